@@ -13,9 +13,11 @@
 #include <ncurses.h>
 #include <unordered_map>
 #include <stdexcept>
-#include <random>
 #include <chrono>
 #include <thread>
+#include "Whac-A-Mole/Hardware/Random.h"
+#include "Whac-A-Mole/Hardware/GameMode.h"
+#include "Whac-A-Mole/Hardware/MoleEngine.h"
 
 using namespace std;
 
@@ -106,6 +108,7 @@ public:
 class LEDMatrix {
 private:
     unordered_map<char, int> keyToLedMap;
+    Random random; // Seeded once, not for every LED
 
 public:
     LEDMatrix() {
@@ -125,12 +128,8 @@ public:
      * @return The pin number of the newly lit LED.
      */
     int lightUpRandomLED(int currentLedPin) {
-        random_device rd;
-        mt19937 gen(rd());
-        uniform_int_distribution<> distrib(0, keyToLedMap.size() - 1);
-
         auto it = keyToLedMap.begin();
-        advance(it, distrib(gen));
+        advance(it, random.nextBelow(keyToLedMap.size()));
         int newLedPin = it->second;
 
         if (currentLedPin != -1) {
@@ -204,6 +203,15 @@ public:
     void decrementScore() {
         if (score > 0) score--;
     }
+
+    /**
+     * @brief Add points to the player's score (not going below 0).
+     *
+     * @param points The points to add; negative for a penalty.
+     */
+    void addPoints(int points) {
+        score = max(0, score + points);
+    }
 };
 
 // HighScore Class
@@ -269,10 +277,21 @@ private:
     Timer timer;
     LEDMatrix ledMatrix;
     Player currentPlayer;
+    MoleEngine moles; // Runs the moles of every mode from kGameModes
+    Random random;
 
-    int lightUpRandomLEDAndWaitForInput(int currentLedPin);
-    int lightUpRandomLEDNoWait(int currentLedPin);
-    vector<int> lightUpMultipleRandomLEDs(vector<int>& activeLeds);
+    /**
+     * @brief Write the LEDs that differ between two cell masks.
+     *
+     * @param shown The cells currently lit.
+     * @param wanted The cells to light.
+     */
+    static void showMask(uint16_t shown, uint16_t wanted) {
+        for (uint16_t changed = shown ^ wanted; changed != 0; changed &= changed - 1) {
+            int cell = __builtin_ctz(changed);
+            gpioWrite(kLedLayout.cellToPin[cell], (wanted >> cell) & 1);
+        }
+    }
 
 public:
     /**
@@ -303,42 +322,43 @@ public:
      *
      * @param player The player object.
      * @param highScore The highScore object.
-     * @param gameMode The selected game mode.
+     * @param gameMode The selected game mode, 1 to 3; the index of its kGameModes entry plus one.
      */
     void inGame(Player& player, HighScore& highScore, int gameMode) {
+        if (gameMode < 1 || gameMode > static_cast<int>(size(kGameModes))) {
+            return;
+        }
         setup(); // Setup using LEDMatrix
         initscr();
         noecho();
         cbreak();
         keypad(stdscr, TRUE);
-        nodelay(stdscr, TRUE);
         curs_set(0);
 
-        int currentLedPin = -1;
-        vector<int> activeLeds;
+        uint16_t shown = 0;
 
         timer.start();
+        moles.start(kGameModes[gameMode - 1], MoleEngine::Clock::now(), chrono::seconds(30));
         while (!timer.isTimeUp()) {
+            MoleEngine::Step step = moles.advance(MoleEngine::Clock::now(), random);
+            player.addPoints(step.scoreDelta);
+            showMask(shown, moles.getMask());
+            shown = moles.getMask();
+
             mvprintw(0, 0, "Time left: %d seconds ", timer.getTimeLeft());
-            mvprintw(1, 0, "Score: %d", player.getScore());
+            mvprintw(1, 0, "Score: %d ", player.getScore());
             refresh();
 
-            switch (gameMode) {
-                case 1: // Easy
-                    currentLedPin = lightUpRandomLEDAndWaitForInput(currentLedPin);
-                    break;
-                case 2: // Medium
-                    currentLedPin = lightUpRandomLEDNoWait(currentLedPin);
-                    break;
-                case 3: // Hard
-                    activeLeds = lightUpMultipleRandomLEDs(activeLeds);
-                    break;
-                default:
-                    // Default behavior or error handling
-                    break;
+            // Sleep until a key, the next mole deadline or the next countdown update
+            auto wait = chrono::duration_cast<chrono::milliseconds>(moles.nextDeadline() - MoleEngine::Clock::now());
+            timeout(static_cast<int>(max<long long>(0, min<long long>(wait.count(), 100))));
+            int cell = kLedLayout.cellForKey(getch());
+            if (cell != LedLayout::kNoCell) {
+                player.addPoints(moles.whack(cell, MoleEngine::Clock::now()).scoreDelta);
             }
         }
 
+        showMask(shown, 0);
         endwin();
         gpioTerminate();
         cout << "Game Over! " << player.getName() << ", your final score is: " << player.getScore() << endl;
@@ -0,0 +1,163 @@
+#include "GameOverPipeline.h"
+#include "audioengine.h"
+#include "scorelistmodel.h"
+#include <QMetaObject>
+#include <QRunnable>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Runs a function on a QThreadPool; the pool deletes it afterwards.
+ */
+class Task : public QRunnable {
+public:
+    explicit Task(std::function<void()> function) : function(std::move(function)) {
+        setAutoDelete(true);
+    }
+
+    void run() override {
+        function();
+    }
+
+private:
+    std::function<void()> function; ///< The work.
+};
+
+} // namespace
+
+/**
+ * @brief Retrieves the application's game-over pipeline.
+ *
+ * @return The single instance, created on first use.
+ */
+GameOverPipeline& GameOverPipeline::instance() {
+    static GameOverPipeline pipeline;
+    return pipeline;
+}
+
+/**
+ * @brief Constructs an idle pipeline.
+ *
+ * The storage lane has a single thread, so its tasks run one after another in the order
+ * they were submitted. Idle threads are kept, as rounds end every minute or so.
+ */
+GameOverPipeline::GameOverPipeline() {
+    storage.setMaxThreadCount(1);
+    storage.setExpiryTimeout(-1);
+    workers.setMaxThreadCount(kWorkerThreads);
+}
+
+/**
+ * @brief Destructor for GameOverPipeline.
+ *
+ * Waits for both pools before the HighScore is destroyed, which in turn commits and folds
+ * its journal. Queued calls to scoreSaved that have not been delivered are dropped with
+ * this object.
+ */
+GameOverPipeline::~GameOverPipeline() {
+    waitForDone();
+}
+
+/**
+ * @brief Starts the game-over tasks of a round.
+ *
+ * The storage lane saves the score and posts its rank to the GUI thread, where the
+ * leaderboard model is updated and scoreSaved is emitted. The workers play the game-over
+ * sound and print the report at the same time.
+ *
+ * @param result The outcome of the round.
+ */
+void GameOverPipeline::submit(const GameOverResult& result) {
+    storage.start(new Task([this, result] {
+        int rank = persist(result);
+        ScoreRecord record = ScoreRecord::make(result.score, result.playerName, 0, result.game);
+        QMetaObject::invokeMethod(this, [this, record, rank] {
+            ScoreListModel::instance().scoreSaved(record, rank);
+            emit scoreSaved(record.score, rank);
+        }, Qt::QueuedConnection);
+    }));
+    workers.start(new Task([] {
+        AudioEngine::instance().play("over.wav");
+    }));
+    workers.start(new Task([result] {
+        report(result);
+    }));
+}
+
+/**
+ * @brief Reads the leaderboard on the storage lane and hands it to the ScoreListModel.
+ *
+ * The entries are copied out best first on the lane and posted to the GUI thread, where
+ * they replace the rows of the model.
+ */
+void GameOverPipeline::loadLeaderboard() {
+    storage.start(new Task([this] {
+        const Leaderboard& board = scores().getLeaderboard();
+        std::vector<ScoreRecord> copy(board.begin(), board.end());
+        std::size_t capacity = board.capacity();
+        bool perPlayer = board.isBestPerPlayer();
+        QMetaObject::invokeMethod(this, [copy = std::move(copy), capacity, perPlayer]() mutable {
+            ScoreListModel::instance().boardRead(std::move(copy), capacity, perPlayer);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+/**
+ * @brief Waits until every task submitted so far has run.
+ */
+void GameOverPipeline::waitForDone() {
+    storage.waitForDone();
+    workers.waitForDone();
+}
+
+/**
+ * @brief Retrieves the HighScore, opening it on first use.
+ *
+ * @return The pipeline's HighScore.
+ */
+HighScore& GameOverPipeline::scores() {
+    if (!highScore) {
+        highScore.reset(new HighScore());
+    }
+    return *highScore;
+}
+
+/**
+ * @brief Saves a score and finds its rank.
+ *
+ * add() hands the score to the daemon or the journal, offers it to the in-memory
+ * leaderboard and reports where the new entry landed, so an older entry with the same
+ * name and score is never taken for it.
+ *
+ * @param result The outcome of the round.
+ * @return The rank of the score, or 0 if it did not make the board.
+ */
+int GameOverPipeline::persist(const GameOverResult& result) {
+    return scores().add(result.score, result.playerName, result.game);
+}
+
+/**
+ * @brief Prints the final score and reaction times of a round.
+ *
+ * The report is formatted first and written with one call, so it is not interleaved with
+ * other output.
+ *
+ * @param result The outcome of the round.
+ */
+void GameOverPipeline::report(const GameOverResult& result) {
+    std::ostringstream out;
+    out << "Game ended!\n"
+        << "Final score for " << result.playerName << ": " << result.score << "\n";
+    if (result.game.samples > 0) {
+        out << "Reaction time p50/p90/p99: " << result.game.p50Us / 1000.0 << "/" << result.game.p90Us / 1000.0
+            << "/" << result.game.p99Us / 1000.0 << " ms (session " << result.session.p50Us / 1000.0 << "/"
+            << result.session.p90Us / 1000.0 << "/" << result.session.p99Us / 1000.0 << " ms)\n";
+    }
+    std::cout << out.str() << std::flush;
+}
@@ -0,0 +1,135 @@
+#ifndef GAMEOVERPIPELINE_H
+#define GAMEOVERPIPELINE_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <memory>
+#include <string>
+#include "Hardware/HighScore.h"
+#include "Hardware/LatencyHistogram.h"
+
+/**
+ * @struct GameOverResult
+ * @brief Everything the game-over tasks need from a finished round, copied out of the controller.
+ */
+struct GameOverResult {
+    std::string playerName;  ///< Name of the player.
+    int score;               ///< Final score of the round.
+    ReactionSummary game;    ///< Reaction times of the round.
+    ReactionSummary session; ///< Reaction times of every round so far.
+};
+
+/**
+ * @class GameOverPipeline
+ * @brief Runs the work at the end of a round on background threads.
+ *
+ * submit() returns at once and starts a small task graph:
+ *
+ *   persist score -> refresh leaderboard --> (GUI thread) ScoreListModel, scoreSaved
+ *   play the game-over sound
+ *   print the round report
+ *
+ * Persisting and refreshing run in order on a storage lane, a pool with a single thread,
+ * so the scores of consecutive rounds are saved in the order they were played and the
+ * HighScore is only ever touched by one thread. The sound and the report run on a second
+ * pool, side by side with the save. Only the result of the save, the rank of the score,
+ * is posted back to the GUI thread, as a queued call that updates the ScoreListModel and
+ * emits scoreSaved.
+ *
+ * The application has one pipeline and so one HighScore. The ScoreListModel reads the
+ * leaderboard through loadLeaderboard(), on the same lane, instead of opening the store
+ * a second time.
+ *
+ * The next round can start as soon as submit() returns; its score queues behind the
+ * previous one on the storage lane.
+ * @author Anubhav Aery
+ */
+class GameOverPipeline : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Retrieves the application's game-over pipeline.
+     *
+     * @return The single instance.
+     */
+    static GameOverPipeline& instance();
+
+    GameOverPipeline(const GameOverPipeline&) = delete;
+    GameOverPipeline& operator=(const GameOverPipeline&) = delete;
+
+    /**
+     * @brief Starts the game-over tasks of a round. Call from the GUI thread.
+     *
+     * @param result The outcome of the round.
+     */
+    void submit(const GameOverResult& result);
+
+    /**
+     * @brief Reads the leaderboard on the storage lane and hands it to the ScoreListModel.
+     *
+     * Call from the GUI thread. The read runs after every save submitted before it, so the
+     * board it hands over already holds their scores.
+     */
+    void loadLeaderboard();
+
+    /**
+     * @brief Waits until every task submitted so far has run.
+     */
+    void waitForDone();
+
+    static constexpr int kWorkerThreads = 2; ///< Threads for the sound and the report.
+
+signals:
+    /**
+     * @brief Signal emitted in the GUI thread once a score is saved.
+     *
+     * @param score The score that was saved.
+     * @param rank Its position on the leaderboard, starting at 1, or 0 if it did not make the board.
+     */
+    void scoreSaved(int score, int rank);
+
+private:
+    /**
+     * @brief Constructs an idle pipeline.
+     *
+     * The HighScore is opened by the first save or read, on the storage lane, so opening
+     * the store and recovering its journal do not delay the first frame either.
+     */
+    GameOverPipeline();
+
+    /**
+     * @brief Destructor for GameOverPipeline.
+     *
+     * Waits for the tasks still queued, so no score submitted before is lost.
+     */
+    ~GameOverPipeline();
+
+    /**
+     * @brief Retrieves the HighScore, opening it on first use. Runs on the storage lane.
+     *
+     * @return The pipeline's HighScore.
+     */
+    HighScore& scores();
+
+    /**
+     * @brief Saves a score and finds its rank. Runs on the storage lane.
+     *
+     * @param result The outcome of the round.
+     * @return The rank of the score, or 0 if it did not make the board.
+     */
+    int persist(const GameOverResult& result);
+
+    /**
+     * @brief Prints the final score and reaction times of a round. Runs on a worker.
+     *
+     * @param result The outcome of the round.
+     */
+    static void report(const GameOverResult& result);
+
+    QThreadPool storage;                   ///< Single-threaded lane for persist and refresh.
+    QThreadPool workers;                   ///< Runs the tasks that do not touch the store.
+    std::unique_ptr<HighScore> highScore;  ///< Opened by the first save or read; only used on the storage lane.
+};
+
+#endif // GAMEOVERPIPELINE_H
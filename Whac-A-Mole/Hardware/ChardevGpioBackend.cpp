@@ -0,0 +1,153 @@
+#include "ChardevGpioBackend.h"
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+/**
+ * @class ChardevGpioBackend
+ * @brief Drives GPIO lines through the v2 character device uAPI.
+ * @author Anubhav Aery
+ */
+ChardevGpioBackend::ChardevGpioBackend(const std::string& chipPath)
+        : chipPath(chipPath), chipFd(-1), requestFd(-1), lines(), levels(0) {}
+
+/**
+ * @brief Destructor for ChardevGpioBackend.
+ */
+ChardevGpioBackend::~ChardevGpioBackend() {
+    terminate();
+}
+
+/**
+ * @brief Opens the GPIO chip device.
+ *
+ * @return True on success, false if the device cannot be opened.
+ */
+bool ChardevGpioBackend::initialise() {
+    if (chipFd >= 0) {
+        return true;
+    }
+    chipFd = open(chipPath.c_str(), O_RDWR | O_CLOEXEC);
+    if (chipFd < 0) {
+        std::cerr << "Unable to open " << chipPath << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Releases the line request and closes the chip device.
+ */
+void ChardevGpioBackend::terminate() {
+    if (requestFd >= 0) {
+        close(requestFd);
+        requestFd = -1;
+    }
+    if (chipFd >= 0) {
+        close(chipFd);
+        chipFd = -1;
+    }
+    lines.clear();
+}
+
+/**
+ * @brief Adds a pin to the shared line request as an output.
+ *
+ * If the kernel refuses the request with the new pin, the request of the pins added before
+ * is made again, so they keep working.
+ *
+ * @param pin The GPIO line offset.
+ */
+void ChardevGpioBackend::setOutput(int pin) {
+    if (std::find(lines.begin(), lines.end(), pin) != lines.end()) {
+        return;
+    }
+    lines.push_back(pin);
+    levels &= ~(1u << pin);
+    if (!requestLines()) {
+        lines.pop_back();
+        if (!lines.empty()) {
+            requestLines();
+        }
+    }
+}
+
+/**
+ * @brief Drives a single pin.
+ *
+ * @param pin The GPIO line offset.
+ * @param level 1 for high, 0 for low.
+ */
+void ChardevGpioBackend::write(int pin, int level) {
+    std::uint32_t bit = 1u << pin;
+    writeBank(level ? bit : 0, level ? 0 : bit);
+}
+
+/**
+ * @brief Drives every requested pin in the masks with one ioctl.
+ *
+ * @param setMask Pins to drive high.
+ * @param clearMask Pins to drive low.
+ */
+void ChardevGpioBackend::writeBank(std::uint32_t setMask, std::uint32_t clearMask) {
+    levels = (levels & ~clearMask) | setMask;
+    if (requestFd < 0) {
+        return;
+    }
+    gpio_v2_line_values values{};
+    std::uint32_t touched = setMask | clearMask;
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        std::uint32_t bit = 1u << lines[i];
+        if (touched & bit) {
+            values.mask |= 1ULL << i;
+            if (setMask & bit) {
+                values.bits |= 1ULL << i;
+            }
+        }
+    }
+    if (values.mask != 0) {
+        ioctl(requestFd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values);
+    }
+}
+
+/**
+ * @brief Re-creates the line request so that it covers every output pin.
+ *
+ * The kernel refuses lines that are held by any request, including ours, so the old
+ * request is released just before the new one is made. On failure no request is held.
+ *
+ * @return True on success, false if the kernel refused the request.
+ */
+bool ChardevGpioBackend::requestLines() {
+    if (chipFd < 0) {
+        return false;
+    }
+    gpio_v2_line_request request{};
+    std::strncpy(request.consumer, "whac-a-mole", sizeof(request.consumer) - 1);
+    request.num_lines = static_cast<__u32>(lines.size());
+    request.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+    request.config.num_attrs = 1;
+    request.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        request.offsets[i] = static_cast<__u32>(lines[i]);
+        request.config.attrs[0].mask |= 1ULL << i;
+        if (levels & (1u << lines[i])) {
+            request.config.attrs[0].attr.values |= 1ULL << i;
+        }
+    }
+    if (requestFd >= 0) {
+        close(requestFd);
+        requestFd = -1;
+    }
+    if (ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &request) < 0) {
+        std::cerr << "Unable to request GPIO lines: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    requestFd = request.fd;
+    return true;
+}
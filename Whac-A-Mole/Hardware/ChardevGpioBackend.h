@@ -0,0 +1,57 @@
+#ifndef CHARDEVGPIOBACKEND_H
+#define CHARDEVGPIOBACKEND_H
+
+#include "GpioBackend.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class ChardevGpioBackend
+ * @brief GpioBackend that uses the Linux GPIO character device (/dev/gpiochipN).
+ *
+ * Works on any kernel with the v2 GPIO uAPI and, unlike pigpio, does not need root when
+ * the user has access to the chip device. All output pins share one line request, so a
+ * bank write is a single GPIO_V2_LINE_SET_VALUES_IOCTL call.
+ * @author Anubhav Aery
+ */
+class ChardevGpioBackend : public GpioBackend {
+public:
+    /**
+     * @brief Constructor for ChardevGpioBackend.
+     *
+     * @param chipPath Path to the GPIO chip device, by default /dev/gpiochip0.
+     */
+    explicit ChardevGpioBackend(const std::string& chipPath = "/dev/gpiochip0");
+
+    /**
+     * @brief Destructor for ChardevGpioBackend. Releases the chip and the line request.
+     */
+    ~ChardevGpioBackend() override;
+
+    bool initialise() override;
+    void terminate() override;
+
+    /**
+     * @brief Adds a pin to the line request as an output, driven low.
+     *
+     * @param pin The GPIO line offset.
+     */
+    void setOutput(int pin) override;
+    void write(int pin, int level) override;
+    void writeBank(std::uint32_t setMask, std::uint32_t clearMask) override;
+
+private:
+    /**
+     * @brief Re-creates the line request for every output pin, keeping their levels.
+     */
+    bool requestLines();
+
+    std::string chipPath; ///< Path to the GPIO chip device.
+    int chipFd; ///< Open chip device, or -1.
+    int requestFd; ///< Line request covering every output pin, or -1.
+    std::vector<int> lines; ///< Line offset of each requested pin, in request order.
+    std::uint32_t levels; ///< Current level of every pin, bit n = GPIO n.
+};
+
+#endif // CHARDEVGPIOBACKEND_H
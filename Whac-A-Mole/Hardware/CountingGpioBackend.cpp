@@ -0,0 +1,80 @@
+#include "CountingGpioBackend.h"
+
+/**
+ * @class CountingGpioBackend
+ * @brief Records pin levels and register writes instead of touching hardware.
+ * @author Anubhav Aery
+ */
+CountingGpioBackend::CountingGpioBackend() : levels(0), registerWrites(0) {}
+
+/**
+ * @brief Always succeeds; there is no hardware to initialise.
+ *
+ * @return True.
+ */
+bool CountingGpioBackend::initialise() {
+    return true;
+}
+
+/**
+ * @brief Does nothing; there is no hardware to release.
+ */
+void CountingGpioBackend::terminate() {}
+
+/**
+ * @brief Counts the mode change as one register write.
+ *
+ * @param pin The GPIO pin number.
+ */
+void CountingGpioBackend::setOutput(int pin) {
+    (void)pin;
+    ++registerWrites;
+}
+
+/**
+ * @brief Updates one pin and counts one register write.
+ *
+ * @param pin The GPIO pin number.
+ * @param level 1 for high, 0 for low.
+ */
+void CountingGpioBackend::write(int pin, int level) {
+    std::uint32_t bit = 1u << pin;
+    levels = level ? (levels | bit) : (levels & ~bit);
+    ++registerWrites;
+}
+
+/**
+ * @brief Updates several pins and counts one write per non-empty mask.
+ *
+ * @param setMask Pins to drive high.
+ * @param clearMask Pins to drive low.
+ */
+void CountingGpioBackend::writeBank(std::uint32_t setMask, std::uint32_t clearMask) {
+    levels = (levels & ~clearMask) | setMask;
+    registerWrites += (setMask != 0) + (clearMask != 0);
+}
+
+/**
+ * @brief Retrieves the current level of every pin.
+ *
+ * @return Bit n is the level of GPIO n.
+ */
+std::uint32_t CountingGpioBackend::getLevels() const {
+    return levels;
+}
+
+/**
+ * @brief Retrieves the number of register writes counted so far.
+ *
+ * @return The number of register writes.
+ */
+std::uint64_t CountingGpioBackend::getRegisterWrites() const {
+    return registerWrites;
+}
+
+/**
+ * @brief Resets the register write counter.
+ */
+void CountingGpioBackend::resetCounters() {
+    registerWrites = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef COUNTINGGPIOBACKEND_H
+#define COUNTINGGPIOBACKEND_H
+
+#include "GpioBackend.h"
+#include <cstdint>
+
+/**
+ * @class CountingGpioBackend
+ * @brief Mock GpioBackend that keeps the pin levels in memory and counts register writes.
+ *
+ * Each single-pin write and each non-empty set or clear mask counts as one register
+ * access, which is what the real hardware would see. Used to measure the effect of
+ * batching without a Raspberry Pi.
+ * @author Anubhav Aery
+ */
+class CountingGpioBackend : public GpioBackend {
+public:
+    /**
+     * @brief Constructor for CountingGpioBackend.
+     *
+     * Starts with every pin low and every counter at zero.
+     */
+    CountingGpioBackend();
+
+    bool initialise() override;
+    void terminate() override;
+    void setOutput(int pin) override;
+    void write(int pin, int level) override;
+    void writeBank(std::uint32_t setMask, std::uint32_t clearMask) override;
+
+    /**
+     * @brief Retrieves the current level of every pin.
+     *
+     * @return Bit n is the level of GPIO n.
+     */
+    std::uint32_t getLevels() const;
+
+    /**
+     * @brief Retrieves the number of register writes since construction or resetCounters().
+     *
+     * @return The number of register writes.
+     */
+    std::uint64_t getRegisterWrites() const;
+
+    /**
+     * @brief Resets the register write counter to zero.
+     */
+    void resetCounters();
+
+private:
+    std::uint32_t levels; ///< Current level of every pin, bit n = GPIO n.
+    std::uint64_t registerWrites; ///< Register writes counted so far.
+};
+
+#endif // COUNTINGGPIOBACKEND_H
@@ -1,9 +1,55 @@
 #include "GameController.h"
-#include <pigpio.h>
+#include "InputEngine.h"
+#include <algorithm>
+#include <array>
 #include <iostream>
-#include <thread>
 #include <chrono>
+#include <cstdlib>
 #include <ncurses.h>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Parses the button of every cell from a list such as "4,9,-,10".
+ *
+ * The GPIO pins are given in cell order, separated by commas; "-" or nothing leaves a cell
+ * without a button. A pin must be in the first bank and must not drive an LED.
+ *
+ * @param text The list, as in WHAC_BUTTON_PINS.
+ * @param pins Receives the pin of every cell, or -1.
+ * @return True if the list is valid.
+ */
+bool parseButtonPins(const char* text, std::array<int, LedLayout::kCellCount>& pins) {
+    pins.fill(-1);
+    for (int cell = 0; *text; ++cell) {
+        if (cell == LedLayout::kCellCount) {
+            return false;
+        }
+        if (*text == '-') {
+            ++text;
+        } else if (*text != ',') {
+            char* end = nullptr;
+            long pin = std::strtol(text, &end, 10);
+            if (end == text || pin < 0 || pin >= LedLayout::kPinCount ||
+                kLedLayout.cellForPin(static_cast<int>(pin)) != LedLayout::kNoCell) {
+                return false;
+            }
+            pins[cell] = static_cast<int>(pin);
+            text = end;
+        }
+        if (*text == ',') {
+            ++text;
+        } else if (*text) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
 
 /**
  * @class GameController
@@ -13,100 +59,503 @@
  * handling user input, controlling LEDs, and maintaining game state.
  * @author Anubhav Aery
  */
-GameController::GameController() : timer(), ledMatrix(), currentPlayer() {}
+GameController::GameController()
+        : GameController(GpioBackend::createFromEnvironment()) {
+    if (const char* name = std::getenv("WHAC_GAME_MODE")) {
+        if (const GameMode* selected = findGameMode(name)) {
+            mode = selected;
+        } else {
+            std::cerr << "Unknown game mode " << name << ", playing " << mode->name << std::endl;
+        }
+    }
+    if (const char* path = std::getenv("WHAC_RECORD")) {
+        startRecording(path);
+    }
+}
+
+/**
+ * @brief Constructs a GameController that drives the LEDs through the given backend.
+ *
+ * @param backend The GPIO backend, for example a SimulatedGpioBackend for off-device runs.
+ */
+GameController::GameController(std::unique_ptr<GpioBackend> backend)
+        : timer(), ledMatrix(), currentPlayer(), random(), gpio(std::move(backend)), events(nullptr),
+          mode(&gameMode(GameModeId::Easy)), moles(), conditioner(), waveform(), nextWarningAt(Timer::Clock::time_point::max()), nextTickAt(Timer::Clock::time_point::max()), recorder(), gameLatency(), sessionLatency(), stopRequested(false) {}
 
 /**
  * @brief Initializes the game environment.
  *
- * Sets up GPIO pins for LED control using the pigpio library. Throws runtime error
+ * Sets up GPIO pins for LED control through the GPIO backend. Throws runtime error
  * if GPIO initialization fails.
  * @author Anubhav Aery
  */
 void GameController::setup() {
-    if (gpioInitialise() < 0) {
-        throw std::runtime_error("Failed to initialize pigpio.");
-    }
-    const auto& keyToLedMap = ledMatrix.getKeyToLedMap();
-    for (auto const& kvp : keyToLedMap) {
-        gpioSetMode(kvp.second, PI_OUTPUT);
-        gpioWrite(kvp.second, 0); // Initially turn off all LEDs
+    if (!gpio->initialise()) {
+        throw std::runtime_error("Failed to initialize the GPIO backend.");
     }
+    ledMatrix.setBackend(gpio.get());
+    waveform.setBackend(gpio.get());
 }
 
 /**
  * @brief Starts the game.
  *
- * Marks the beginning of the game by starting the timer and printing a start message.
+ * Marks the beginning of the game by starting the timer and publishing the Started event.
+ * Nothing is printed on the game thread.
  * @author Anubhav Aery
  */
 void GameController::startGame() {
-    std::cout << "Game started!\n";
+    gameLatency.reset();
     timer.start();
+    publish(GameEvent::Type::Started, -1, 0);
+}
+
+/**
+ * @brief Re-seeds the random engine that places the moles.
+ *
+ * @param seed The new seed.
+ */
+void GameController::seed(std::uint64_t seed) {
+    random.seed(seed);
+}
+
+/**
+ * @brief Sets the queue that receives the events of the round.
+ *
+ * @param queue The queue, or nullptr to stop publishing.
+ */
+void GameController::setEventQueue(GameEventQueue* queue) {
+    events = queue;
+}
+
+/**
+ * @brief Selects the mode of the following rounds.
+ *
+ * @param newMode The mode.
+ */
+void GameController::setMode(const GameMode& newMode) {
+    mode = &newMode;
+}
+
+/**
+ * @brief Retrieves the mode of the current or next round.
+ *
+ * @return The selected mode.
+ */
+const GameMode& GameController::getMode() const {
+    return *mode;
+}
+
+/**
+ * @brief Starts recording the following rounds for replay.
+ *
+ * @param path Path of the game log; rounds are appended to it.
+ * @return True if the log could be opened.
+ */
+bool GameController::startRecording(const std::string& path) {
+    return recorder.open(path);
+}
+
+/**
+ * @brief Stops recording rounds.
+ */
+void GameController::stopRecording() {
+    recorder.close();
+}
+
+/**
+ * @brief Asks a running round to end early.
+ */
+void GameController::requestStop() {
+    stopRequested = true;
+}
+
+/**
+ * @brief Forgets an earlier stop request, before a new round is started.
+ */
+void GameController::clearStop() {
+    stopRequested = false;
+}
+
+/**
+ * @brief Retrieves the reaction times of the current or last round.
+ *
+ * @return Histogram of the round's reaction times.
+ */
+const LatencyHistogram& GameController::getGameLatency() const {
+    return gameLatency;
+}
+
+/**
+ * @brief Retrieves the reaction times of every round played by this controller.
+ *
+ * @return Histogram of all finished rounds.
+ */
+const LatencyHistogram& GameController::getSessionLatency() const {
+    return sessionLatency;
+}
+
+/**
+ * @brief Publishes an event to the event queue, if one is set.
+ *
+ * Ended is the last event of a round and the consumer waits for it, so it is retried until
+ * there is room; every other event is dropped when the queue is full.
+ *
+ * @param type The kind of event.
+ * @param cell The cell involved, or -1.
+ * @param score The current score.
+ */
+void GameController::publish(GameEvent::Type type, int cell, int score) {
+    if (!events) {
+        return;
+    }
+    Timer::Clock::time_point now = Timer::now();
+    GameEvent event;
+    event.type = type;
+    event.cell = static_cast<std::int8_t>(cell);
+    event.score = score;
+    event.timeLeftMs = static_cast<std::int32_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(timer.getTimeLeftNs(now)).count());
+    event.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    while (!events->tryPush(event) && type == GameEvent::Type::Ended) {
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief Plays the attract-mode sweep across the matrix.
+ *
+ * Every cell plays kAttractSweep, each column kAttractColumnDelay after the one to its
+ * left. The PWM does the dimming, so the thread sleeps between animation frames.
+ *
+ * @param length How long to play.
+ */
+void GameController::attract(std::chrono::nanoseconds length) {
+    LedAnimator& animator = ledMatrix.getAnimator();
+    Timer::Clock::time_point start = Timer::now();
+    Timer::Clock::time_point end = start + length;
+    for (int cell = 0; cell < LedLayout::kCellCount; ++cell) {
+        animator.play(cell, kAttractSweep, start + (cell % 4) * kAttractColumnDelay);
+    }
+    for (Timer::Clock::time_point now = start; now < end && !stopRequested; now = Timer::now()) {
+        animator.update(now);
+        Timer::sleepUntil(std::min(end, animator.nextFrame()));
+    }
+    animator.stopAll();
+    ledMatrix.show();
 }
 
 /**
  * @brief Handles the in-game logic.
  *
  * Manages the game's running state, including lighting up LEDs, capturing user input,
- * and updating the player's score. Ends when the timer is up.
+ * and updating the player's score. Ends when the timer is up. The loop sleeps in the
+ * InputEngine until a key arrives or the round ends, so hits register immediately.
+ * An evdev keyboard or button panel can be added through the WHAC_INPUT_DEVICE variable,
+ * and buttons wired to GPIO pins through WHAC_BUTTON_PINS. A button's press is timed by
+ * the GPIO backend when the pin changed, so its reaction time is exact to the sample.
+ * Spawns, hits, misses, score changes and periodic ticks are published to the event queue.
+ * Each hit records the time from the mole lighting up to the key event in the game's
+ * latency histogram; both ends are taken from the monotonic clock.
+ * The moles come from a MoleEngine running the selected mode. The loop is the same for
+ * every mode: it advances the engine, shows its cell mask in one batch and sleeps until
+ * the next key, tick, mole deadline or the end of the round. There is no fixed sleep and
+ * no polling: every deadline is an absolute time on the monotonic clock, and the engine
+ * applies each one at that time however late the loop wakes up, so the round does not
+ * depend on the scheduler. A key is judged by the moles lit at its own time: one that
+ * arrives after the round was advanced past it still hits a mole that escaped since,
+ * taking the escape back, and misses a mole that appeared after it.
+ * Ticks are deadlines too, every kTickInterval from the start of the round.
+ * Every round starts from a fresh seed drawn from the random engine. If recording is on,
+ * the seed, the mode and every advance, accepted key and tick go to the GameRecorder,
+ * from which a GameReplayer can run the round again.
+ * On a backend with waveforms, the frames of the coming deadlines are scheduled after each
+ * pass, and the round is advanced to the deadlines the wave has shown at their exact
+ * times, rather than at the time the loop woke up. Hits still reach the LEDs at once.
+ * While a cell plays an escape warning or a hit pulse, the loop also wakes up for every
+ * animation frame.
  *
  * @param player Reference to the player's data.
- * @param highScore Reference to the high score manager.
  * @author Anubhav Aery
  */
-void GameController::inGame(Player& player, HighScore& highScore) {
-    initscr();
-    noecho();
-    cbreak();
-    keypad(stdscr, TRUE);
-    nodelay(stdscr, TRUE);
-    curs_set(0);
-
-    int currentLedPin = -1;
-    bool ledOn = false;
-
-    while (!timer.isTimeUp()) {
-        if (!ledOn) {
-            if (currentLedPin != -1) {
-                gpioWrite(currentLedPin, 0);
-            }
-            currentLedPin = ledMatrix.lightUpRandomLED(currentLedPin);
-            ledOn = true;
+void GameController::inGame(Player& player) {
+    // Without a terminal (CI, load tests) the round runs without keyboard input
+    bool terminal = isatty(STDIN_FILENO);
+    if (terminal) {
+        initscr();
+        noecho();
+        cbreak();
+        keypad(stdscr, TRUE);
+        curs_set(0);
+    }
+
+    // Leaves the LEDs dark and the terminal and GPIO as they were, also when input fails
+    auto restore = [&] {
+        waveform.setBackend(nullptr);
+        ledMatrix.getAnimator().stopAll();
+        ledMatrix.getFrame().clear();
+        ledMatrix.show();
+        if (terminal) {
+            endwin();
         }
+        ledMatrix.setBackend(nullptr);
+        gpio->terminate();
+    };
+    try {
+        playRound(player, terminal);
+    } catch (...) {
+        restore();
+        throw;
+    }
+    restore();
+}
 
-        int ch = getch();
-        if (ch != ERR) {
-            const auto& keyToLedMap = ledMatrix.getKeyToLedMap();
-            if (keyToLedMap.count(ch) > 0) {
-                if (keyToLedMap.at(ch) == currentLedPin) {
-                    gpioWrite(currentLedPin, 0);
-                    ledOn = false;
-                    player.incrementScore();
-                } else {
-                    player.decrementScore();
-                }
-            }
+/**
+ * @brief Plays the round from the input sources to the end of its time.
+ *
+ * @param player Reference to the player's data.
+ * @param terminal True if keys are read from the terminal.
+ * @throws std::runtime_error If the input sources cannot be set up or waited on.
+ */
+void GameController::playRound(Player& player, bool terminal) {
+    InputEngine input;
+    if (terminal) {
+        input.addTerminal(STDIN_FILENO);
+    }
+    if (const char* device = std::getenv("WHAC_INPUT_DEVICE")) {
+        if (!input.addEvdevDevice(device)) {
+            std::cerr << "Unable to open input device " << device << std::endl;
         }
+    }
+    if (const char* pins = std::getenv("WHAC_BUTTON_PINS")) {
+        std::array<int, LedLayout::kCellCount> buttonPins;
+        if (!parseButtonPins(pins, buttonPins) || !input.addGpioButtons(*gpio, buttonPins)) {
+            std::cerr << "Unable to watch the buttons on GPIO " << pins << std::endl;
+        }
+    }
+
+    beginRound(player, Timer::now());
+    while (!timer.isTimeUp() && !stopRequested) {
+        Timer::Clock::time_point now = Timer::now();
+        catchUpWave(player, now);
+        updateRound(player, now);
+        scheduleWave(now);
+        InputEvent event = input.waitForEvent(getNextWakeup());
+        if (event.type == InputEvent::Type::Key) {
+            catchUpWave(player, event.timestamp);
+            updateRound(player, event.timestamp);
+            handleKey(player, event.key, event.timestamp);
+        } else if (event.type == InputEvent::Type::Release) {
+            handleRelease(event.key, event.timestamp);
+        }
+    }
+    recorder.endRound(player.getScore());
+}
+
+/**
+ * @brief Starts the moles of a round.
+ *
+ * Every round starts from a fresh seed drawn from the random engine, so a recorded round
+ * can be replayed from its seed.
+ *
+ * @param player Reference to the player's data.
+ * @param now The current time.
+ */
+void GameController::beginRound(Player& player, Timer::Clock::time_point now) {
+    std::chrono::nanoseconds roundLength = timer.getElapsed(now) + timer.getTimeLeftNs(now);
+    random.seed(random.next());
+    moles.start(*mode, now, roundLength);
+    conditioner.reset(mode->concurrentMoles);
+    nextWarningAt = Timer::Clock::time_point::max();
+    nextTickAt = now + kTickInterval;
+    recorder.beginRound(random.getSeed(), *mode, roundLength, now, player.getScore());
+}
+
+/**
+ * @brief Advances the moles to the current time and shows them.
+ *
+ * Hits, escapes and spawns since the last pass reach the LEDs in one batch. The curves
+ * playing on single cells are updated first, so a cell whose curve has just ended is in
+ * the same batch. The ticks due by then are applied at their own times; ticks missed by
+ * more than a period are dropped rather than run in a burst.
+ *
+ * @param player Reference to the player's data.
+ * @param now The current time.
+ */
+void GameController::updateRound(Player& player, Timer::Clock::time_point now) {
+    MoleEngine::Step step = moles.advance(now, random);
+    recorder.recordAdvance(now, step.spawned);
+    warnEscapes(now);
+    ledMatrix.getAnimator().update(now);
+    ledMatrix.getFrame().setMask(moles.getMask());
+    ledMatrix.show();
+    if (step.escaped) {
+        player.addPoints(step.scoreDelta);
+        publish(GameEvent::Type::Score, -1, player.getScore());
+    }
+    for (std::uint16_t spawned = step.spawned; spawned != 0; spawned &= spawned - 1) {
+        publish(GameEvent::Type::MoleSpawned, __builtin_ctz(spawned), player.getScore());
+    }
+    if (nextTickAt <= now) {
+        handleTick(player, nextTickAt);
+        nextTickAt += kTickInterval * ((now - nextTickAt) / kTickInterval + 1);
+    }
+}
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+/**
+ * @brief Applies a key press to the round.
+ *
+ * Only presses the conditioner accepts are recorded, so a replay scores the same presses
+ * without conditioning them again.
+ *
+ * @param player Reference to the player's data.
+ * @param key The key code.
+ * @param at Time of the key event.
+ */
+void GameController::handleKey(Player& player, int key, Timer::Clock::time_point at) {
+    int cell = ledMatrix.cellForKey(key);
+    if (cell == LedLayout::kNoCell || conditioner.press(cell, at) != InputConditioner::Verdict::Accepted) {
+        return;
+    }
+    recorder.recordKey(at, key);
+    MoleEngine::Whack whack = moles.whack(cell, at);
+    player.addPoints(whack.scoreDelta);
+    if (whack.hit) {
+        ledMatrix.getAnimator().play(cell, kHitPulse, at);
+        gameLatency.record(whack.reaction);
+        publish(GameEvent::Type::Hit, cell, player.getScore());
+    } else {
+        publish(GameEvent::Type::Miss, cell, player.getScore());
     }
+    publish(GameEvent::Type::Score, -1, player.getScore());
+}
 
-    endwin();
-    gpioTerminate();
-    std::cout << "Game Over! Your score is: " << player.getScore() << std::endl;
-    //highScore.add(player.getScore(), player.getName());
+/**
+ * @brief Passes a key release to the conditioner.
+ *
+ * @param key The key code.
+ * @param at Time of the release.
+ */
+void GameController::handleRelease(int key, Timer::Clock::time_point at) {
+    int cell = ledMatrix.cellForKey(key);
+    if (cell != LedLayout::kNoCell) {
+        conditioner.release(cell, at);
+    }
+}
+
+/**
+ * @brief Retrieves the conditioner of the key presses.
+ *
+ * @return The conditioner.
+ */
+const InputConditioner& GameController::getConditioner() const {
+    return conditioner;
+}
+
+/**
+ * @brief Applies a tick of the game loop to the round.
+ *
+ * @param player Reference to the player's data.
+ * @param at Time of the tick.
+ */
+void GameController::handleTick(Player& player, Timer::Clock::time_point at) {
+    recorder.recordTick(at);
+    publish(GameEvent::Type::Tick, -1, player.getScore());
+}
+
+/**
+ * @brief Schedules the LED frames of the mole deadlines ahead on the waveform.
+ *
+ * Stops at kWaveHorizon, at LedWaveform::kMaxSteps frames and at the end of the round. A key
+ * changes the moles, so the next pass computes different frames and replaces the wave.
+ *
+ * @param now The current time.
+ */
+void GameController::scheduleWave(Timer::Clock::time_point now) {
+    if (!waveform.isAvailable()) {
+        return;
+    }
+    LedStep steps[LedWaveform::kMaxSteps];
+    std::size_t count = 0;
+    MoleEngine preview = moles;
+    Random previewRandom = random;
+    Timer::Clock::time_point end = std::min(timer.getDeadline(), now + kWaveHorizon);
+    while (count < LedWaveform::kMaxSteps) {
+        Timer::Clock::time_point at = preview.nextDeadline();
+        if (at <= now || at >= end) {
+            break;
+        }
+        preview.advance(at, previewRandom);
+        steps[count++] = LedStep{at, preview.getMask()};
+    }
+    waveform.schedule(ledMatrix.getFrame().getShownMask(), steps, count, ledMatrix.getFrame().getHeldMask());
+}
+
+/**
+ * @brief Advances the round through the steps the waveform has already shown.
+ *
+ * Each step is applied at its own deadline. Its frame is already on the LEDs, so the
+ * frame buffer is told so and updateRound() writes nothing unless a key changed the moles
+ * after the wave was scheduled.
+ *
+ * @param player Reference to the player's data.
+ * @param until The current time, or the time of the key about to be handled.
+ */
+void GameController::catchUpWave(Player& player, Timer::Clock::time_point until) {
+    LedStep step;
+    while (waveform.popFired(until, step)) {
+        ledMatrix.getFrame().assumeShown(step.cells);
+        updateRound(player, step.at);
+    }
+}
+
+/**
+ * @brief Starts the escape warning of every mole within kEscapeWarningTime of escaping.
+ *
+ * The warning is timed from the escape, not from now, so it ends as the mole goes out even
+ * if the loop wakes up late. Cells already playing a curve, such as a hit pulse, are left
+ * alone until it ends. Also finds the time the next warning is due.
+ *
+ * @param now The current time.
+ */
+void GameController::warnEscapes(Timer::Clock::time_point now) {
+    LedAnimator& animator = ledMatrix.getAnimator();
+    nextWarningAt = Timer::Clock::time_point::max();
+    std::uint16_t idle = static_cast<std::uint16_t>(moles.getMask() & ~animator.getActiveMask());
+    for (std::uint16_t lit = idle; lit != 0; lit &= lit - 1) {
+        int cell = __builtin_ctz(lit);
+        Timer::Clock::time_point warnAt = moles.getEscapeTime(cell) - kEscapeWarningTime;
+        if (warnAt <= now) {
+            animator.play(cell, kEscapeWarning, warnAt);
+        } else {
+            nextWarningAt = std::min(nextWarningAt, warnAt);
+        }
+    }
+}
+
+/**
+ * @brief Retrieves the time by which updateRound() must run again.
+ *
+ * @return The next mole deadline, tick, escape warning, animation frame or the end of the
+ *         round, whichever comes first.
+ */
+Timer::Clock::time_point GameController::getNextWakeup() const {
+    return std::min({timer.getDeadline(), moles.nextDeadline(), nextTickAt, nextWarningAt,
+                     ledMatrix.getAnimator().nextFrame()});
 }
 
 /**
  * @brief Ends the game.
  *
- * Stops the game timer and prints the final score of the player.
+ * Stops the game timer, adds the round's reaction times to the session and publishes the
+ * Ended event. Nothing is printed or saved on the game thread; the receiver of the event
+ * reports and saves the score.
  *
  * @param player Reference to the player's data.
  * @author Anubhav Aery
  */
 void GameController::endGame(Player& player) {
-    std::cout << "Game ended!\n";
     timer.stop();
-    std::cout << "Final score: " << player.getScore() << "\n";
+    sessionLatency.merge(gameLatency);
+    publish(GameEvent::Type::Ended, -1, player.getScore());
 }
@@ -3,8 +3,21 @@
 
 #include "Timer.h"
 #include "LEDMatrix.h"
+#include "LedWaveform.h"
 #include "Player.h"
-#include "HighScore.h"
+#include "Random.h"
+#include "GpioBackend.h"
+#include "GameEvent.h"
+#include "LatencyHistogram.h"
+#include "GameMode.h"
+#include "MoleEngine.h"
+#include "InputConditioner.h"
+#include "GameRecorder.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
 
 /**
  * @class GameController
@@ -13,6 +26,15 @@
  * The GameController class is responsible for initializing the game environment,
  * handling game state, processing player inputs, controlling LED matrix, and managing
  * the game timer. It acts as the central component coordinating various aspects of the game.
+ * While a round runs, it can publish GameEvents to another thread through a lock-free queue,
+ * and it measures the time from each mole appearing to the key that hits it. The moles
+ * follow the selected GameMode, run by a MoleEngine.
+ * If the GPIO backend can play waveforms, the spawns and escapes of the next kWaveHorizon
+ * are handed to its DMA engine, so they light up and go out at their exact deadlines.
+ * A mole about to escape flickers and fades out over kEscapeWarningTime, and a hit cell
+ * flashes, both played by the LedAnimator of the matrix.
+ * Key presses pass through an InputConditioner first, which drops bounce, auto-repeat and
+ * presses beyond what a chord may hit, so they cost no points.
  * @author Anubhav Aery
  */
 class GameController {
@@ -20,14 +42,25 @@ public:
     /**
      * @brief Constructor for GameController.
      *
-     * Initializes a new GameController instance with default Timer, LEDMatrix, and Player objects.
+     * Initializes a new GameController instance with default Timer, LEDMatrix, and Player objects,
+     * a random engine seeded from std::random_device, and the GPIO backend selected by
+     * the WHAC_GPIO_BACKEND environment variable (see GpioBackend::createFromEnvironment()).
+     * The game mode is the one named by WHAC_GAME_MODE, or easy. If WHAC_RECORD names a
+     * file, every round is recorded to it.
      */
     GameController();
 
+    /**
+     * @brief Constructor for GameController with an explicit GPIO backend.
+     *
+     * @param backend The GPIO backend that drives the LEDs.
+     */
+    explicit GameController(std::unique_ptr<GpioBackend> backend);
+
     /**
      * @brief Sets up the game environment.
      *
-     * Initializes GPIO pins for LED control and prepares the game for starting.
+     * Initializes the GPIO backend and the LED pins and prepares the game for starting.
      */
     void setup();
 
@@ -38,29 +71,243 @@ public:
      */
     void startGame();
 
+    /**
+     * @brief Re-seeds the random engine that places the moles.
+     *
+     * Seeding with a fixed value makes the sequence of moles reproducible.
+     *
+     * @param seed The new seed.
+     */
+    void seed(std::uint64_t seed);
+
+    /**
+     * @brief Sets the queue that receives the events of the round.
+     *
+     * The controller is the only producer. Events other than Ended are dropped if the
+     * consumer falls more than a full queue behind.
+     *
+     * @param queue The queue, or nullptr to stop publishing.
+     */
+    void setEventQueue(GameEventQueue* queue);
+
+    /**
+     * @brief Selects the mode of the following rounds.
+     *
+     * @param mode The mode; must outlive the controller, as the kGameModes entries do.
+     */
+    void setMode(const GameMode& mode);
+
+    /**
+     * @brief Retrieves the mode of the current or next round.
+     *
+     * @return The selected mode.
+     */
+    const GameMode& getMode() const;
+
+    /**
+     * @brief Starts recording the following rounds for replay by a GameReplayer.
+     *
+     * @param path Path of the game log; rounds are appended to it.
+     * @return True if the log could be opened.
+     */
+    bool startRecording(const std::string& path);
+
+    /**
+     * @brief Stops recording rounds.
+     */
+    void stopRecording();
+
+    /**
+     * @brief Asks a running round to end early. Safe to call from any thread.
+     *
+     * The round ends at the next tick, within kTickInterval. A request made before the round
+     * starts, during setup() or attract(), ends it at once.
+     */
+    void requestStop();
+
+    /**
+     * @brief Forgets an earlier stop request, before a new round is started.
+     *
+     * Called on the thread that starts the round, before it starts it, so a request made
+     * from then on is not lost.
+     */
+    void clearStop();
+
+    /**
+     * @brief Plays the attract-mode sweep across the matrix, as the intro of a round.
+     *
+     * Runs after setup(), until @p length has passed or requestStop() is called, and
+     * leaves every LED off.
+     *
+     * @param length How long to play.
+     */
+    void attract(std::chrono::nanoseconds length);
+
     /**
      * @brief Manages the in-game logic.
      *
      * Controls the gameplay activities, including LED matrix interactions, player score,
-     * and handling game timing. Continues until the game timer runs out.
+     * and handling game timing. Continues until the game timer runs out. If the input
+     * sources fail, the LEDs, terminal and GPIO are restored and the error is rethrown.
+     *
+     * @param player Reference to the current Player object.
+     * @throws std::runtime_error If the input sources cannot be set up or waited on.
+     */
+    void inGame(Player& player);
+
+    /**
+     * @brief Starts the moles of a round. Called by inGame(), after startGame().
+     *
+     * @param player Reference to the current Player object.
+     * @param now The current time.
+     */
+    void beginRound(Player& player, Timer::Clock::time_point now);
+
+    /**
+     * @brief Advances the moles to the current time, shows them and scores escapes.
+     *
+     * One pass of the game loop; inGame() calls it before waiting for input, and before
+     * applying a key. Also applies the tick, if one is due.
+     *
+     * @param player Reference to the current Player object.
+     * @param now The current time.
+     */
+    void updateRound(Player& player, Timer::Clock::time_point now);
+
+    /**
+     * @brief Applies a key press: a hit, a miss, or nothing for an unmapped key.
+     *
+     * Presses the InputConditioner drops do nothing either.
      *
      * @param player Reference to the current Player object.
-     * @param highScore Reference to the HighScore manager.
+     * @param key The key code.
+     * @param at Time of the key event.
+     */
+    void handleKey(Player& player, int key, Timer::Clock::time_point at);
+
+    /**
+     * @brief Passes a key release to the InputConditioner.
+     *
+     * @param key The key code.
+     * @param at Time of the release.
      */
-    void inGame(Player& player, HighScore& highScore);
+    void handleRelease(int key, Timer::Clock::time_point at);
+
+    /**
+     * @brief Retrieves the conditioner of the key presses.
+     *
+     * @return The conditioner, with the counts of the current or last round.
+     */
+    const InputConditioner& getConditioner() const;
+
+    /**
+     * @brief Applies a tick of the game loop.
+     *
+     * @param player Reference to the current Player object.
+     * @param at Time of the tick.
+     */
+    void handleTick(Player& player, Timer::Clock::time_point at);
+
+    /**
+     * @brief Retrieves the time by which updateRound() must run again.
+     *
+     * @return The next mole deadline, tick, escape warning, animation frame or the end of
+     *         the round, whichever comes first.
+     */
+    Timer::Clock::time_point getNextWakeup() const;
 
     /**
      * @brief Ends the game.
      *
-     * Stops the game, finalizes the score, and performs any necessary cleanup.
+     * Stops the game timer, adds the round's reaction times to the session and publishes
+     * the Ended event. Nothing is printed or saved on the game thread; the round report is
+     * printed by the receiver of the event.
      *
      * @param player Reference to the current Player object.
      */
     void endGame(Player& player);
 
+    /**
+     * @brief Retrieves the reaction times of the current or last round.
+     *
+     * @return Histogram of the time from a mole lighting up to the key that hit it.
+     */
+    const LatencyHistogram& getGameLatency() const;
+
+    /**
+     * @brief Retrieves the reaction times of every round played by this controller.
+     *
+     * @return Histogram of all rounds, updated by endGame().
+     */
+    const LatencyHistogram& getSessionLatency() const;
+
+    static constexpr std::chrono::milliseconds kTickInterval{100}; ///< Period of Tick events during a round.
+    static constexpr std::chrono::milliseconds kWaveHorizon{500};  ///< How far ahead the LED frames are scheduled.
+    static constexpr std::chrono::milliseconds kEscapeWarningTime{kEscapeWarning.lengthMs()}; ///< Warning before a mole escapes.
+    static constexpr std::chrono::milliseconds kAttractColumnDelay{150}; ///< Delay of the sweep from one column to the next.
+    static constexpr std::chrono::milliseconds kAttractIntro{kAttractSweep.lengthMs()}; ///< One sweep, played before each round.
+
     Timer timer; ///< Timer object to manage game timing.
     LEDMatrix ledMatrix; ///< LEDMatrix object to control the LED matrix.
     Player currentPlayer; ///< Player object to represent the current player.
+    Random random; ///< Random engine for mole placement, seeded once per controller.
+    std::unique_ptr<GpioBackend> gpio; ///< Backend driving the GPIO pins.
+
+private:
+    /**
+     * @brief Publishes an event to the event queue, if one is set.
+     *
+     * @param type The kind of event.
+     * @param cell The cell involved, or -1.
+     * @param score The current score.
+     */
+    void publish(GameEvent::Type type, int cell, int score);
+
+    /**
+     * @brief Runs the game loop of inGame() until the round is over or stopped.
+     *
+     * @param player Reference to the current Player object.
+     * @param terminal True if keys are read from the terminal.
+     * @throws std::runtime_error If the input sources cannot be set up or waited on.
+     */
+    void playRound(Player& player, bool terminal);
+
+    /**
+     * @brief Schedules the LED frames of the mole deadlines ahead on the waveform.
+     *
+     * Runs the MoleEngine forward on a copy, with a copy of the random engine, so the
+     * frames are exactly the ones updateRound() will compute at those deadlines.
+     *
+     * @param now The current time.
+     */
+    void scheduleWave(Timer::Clock::time_point now);
+
+    /**
+     * @brief Advances the round through the steps the waveform has already shown.
+     *
+     * @param player Reference to the player's data.
+     * @param until The current time, or the time of the key about to be handled.
+     */
+    void catchUpWave(Player& player, Timer::Clock::time_point until);
+
+    /**
+     * @brief Starts the escape warning of every mole within kEscapeWarningTime of escaping.
+     *
+     * @param now The current time.
+     */
+    void warnEscapes(Timer::Clock::time_point now);
+
+    GameEventQueue* events;           ///< Receives the events of the round, or nullptr.
+    const GameMode* mode;             ///< Mode of the current or next round.
+    MoleEngine moles;                 ///< Spawns, escapes and hit tests of the round.
+    InputConditioner conditioner;     ///< Drops the presses the player did not mean.
+    LedWaveform waveform;             ///< Plays the upcoming LED frames, if the backend can.
+    Timer::Clock::time_point nextWarningAt; ///< Start of the next escape warning.
+    Timer::Clock::time_point nextTickAt;    ///< Time of the next tick of the round.
+    GameRecorder recorder;            ///< Records the rounds if a log is open.
+    LatencyHistogram gameLatency;     ///< Reaction times of the current round.
+    LatencyHistogram sessionLatency;  ///< Reaction times of all finished rounds.
+    std::atomic<bool> stopRequested;  ///< Set by requestStop() to end the round early.
 };
 
 #endif // GAMECONTROLLER_H
@@ -0,0 +1,40 @@
+#ifndef GAMEEVENT_H
+#define GAMEEVENT_H
+
+#include "SpscQueue.h"
+#include <cstdint>
+
+/**
+ * @struct GameEvent
+ * @brief One thing that happened during a round, published by the game thread.
+ *
+ * Events are small and trivially copyable so they can travel through a SpscQueue
+ * without allocating.
+ */
+struct GameEvent {
+    /**
+     * @brief The kind of event.
+     */
+    enum class Type : std::uint8_t {
+        Started,     ///< The round started; timeLeftMs holds its length.
+        MoleSpawned, ///< A mole appeared in cell.
+        Hit,         ///< The mole in cell was hit.
+        Miss,        ///< The player pressed cell while no mole was there.
+        Score,       ///< The score changed; score holds the new value.
+        Tick,        ///< Periodic update; timeLeftMs holds the time left.
+        Ended        ///< The round is over; score holds the final score.
+    };
+
+    Type type;                ///< The kind of event.
+    std::int8_t cell;         ///< Cell of MoleSpawned, Hit and Miss events, otherwise -1.
+    std::int32_t score;       ///< Score after the event.
+    std::int32_t timeLeftMs;  ///< Time left in the round in milliseconds.
+    std::int64_t timestampNs; ///< Timer::now() when the event happened, in nanoseconds.
+};
+
+/**
+ * @brief Queue carrying GameEvents from the game thread to the GUI thread.
+ */
+using GameEventQueue = SpscQueue<GameEvent, 1024>;
+
+#endif // GAMEEVENT_H
@@ -0,0 +1,93 @@
+#ifndef GAMELOG_H
+#define GAMELOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @namespace GameLog
+ * @brief Binary format shared by the GameRecorder and the GameReplayer.
+ *
+ * A log starts with the eight bytes of kMagic and holds any number of rounds. A round is a
+ * Begin record, then Advance, Key and Tick records in the order the game loop saw them, and
+ * an End record. Each record is a tag byte followed by unsigned LEB128 varints. Timestamps
+ * are stored as the zigzag-encoded difference to the previous record of the round, so a
+ * typical record takes three to four bytes. Signed values are zigzag-encoded as well.
+ *
+ *   Begin    start ns, seed, start score, round length ns, name length, name bytes,
+ *            concurrent moles, spawn interval ms, mole lifetime ms, hit points,
+ *            miss penalty, escape penalty, speed-up per mille
+ *   Advance  delta ns, mask of the cells spawned by MoleEngine::advance()
+ *   Key      delta ns, key code
+ *   Tick     delta ns
+ *   End      final score
+ * @author Anubhav Aery
+ */
+namespace GameLog {
+
+/**
+ * @brief First bytes of every log.
+ *
+ * Version 2 logs are played by a MoleEngine that applies each deadline at its own time;
+ * version 1 rounds would not replay the same, so their logs are not accepted.
+ */
+inline constexpr char kMagic[8] = {'W', 'H', 'A', 'C', 'R', 'E', 'C', '2'};
+
+/**
+ * @brief Kind of a record.
+ */
+enum class Tag : std::uint8_t { Begin = 1, Advance = 2, Key = 3, Tick = 4, End = 5 };
+
+/**
+ * @brief Maps a signed value to an unsigned one with small magnitudes staying small.
+ */
+inline std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+/**
+ * @brief Reverses zigzag().
+ */
+inline std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+/**
+ * @brief Appends an unsigned LEB128 varint.
+ *
+ * @param out The buffer to append to.
+ * @param value The value; seven bits per byte, at most ten bytes.
+ */
+inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+/**
+ * @brief Reads an unsigned LEB128 varint.
+ *
+ * @param data The buffer.
+ * @param size Size of the buffer.
+ * @param position Offset of the varint, advanced past it.
+ * @param value Receives the value.
+ * @return False if the varint runs past the buffer or is longer than ten bytes.
+ */
+inline bool getVarint(const std::uint8_t* data, std::size_t size, std::size_t& position, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && position < size; shift += 7) {
+        std::uint8_t byte = data[position++];
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace GameLog
+
+#endif // GAMELOG_H
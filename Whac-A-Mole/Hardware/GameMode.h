@@ -0,0 +1,73 @@
+#ifndef GAMEMODE_H
+#define GAMEMODE_H
+
+#include <chrono>
+#include <cstring>
+
+/**
+ * @struct GameMode
+ * @brief Parameters of one difficulty level.
+ *
+ * A mode is plain data: the MoleEngine reads these values and has no code specific to
+ * any mode, so a new difficulty is a new row in kGameModes.
+ * @author Anubhav Aery
+ */
+struct GameMode {
+    const char* name;                        ///< Name used by WHAC_GAME_MODE and in messages.
+    int concurrentMoles;                     ///< Maximum number of moles lit at once, 1-16.
+    std::chrono::milliseconds spawnInterval; ///< Minimum time between two spawns; 0 spawns as soon as a mole is free.
+    std::chrono::milliseconds moleLifetime;  ///< Time before an unhit mole escapes.
+    int hitPoints;                           ///< Points for hitting a mole.
+    int missPenalty;                         ///< Points lost for a key on a cell without a mole.
+    int escapePenalty;                       ///< Points lost when a mole escapes.
+    int speedUpPermille;                     ///< How much shorter intervals and lifetimes are at the end of the round, in 1/1000.
+};
+
+/**
+ * @brief Lifetime of a mole that stays until it is hit.
+ */
+inline constexpr std::chrono::milliseconds kUntilHit = std::chrono::hours(24);
+
+/**
+ * @brief Index of each built-in mode in kGameModes.
+ */
+enum class GameModeId { Easy, Medium, Hard };
+
+/**
+ * @brief The built-in modes.
+ *
+ * Easy keeps one mole up until it is hit. Medium moves the mole on if it is not hit in
+ * time. Hard runs up to four moles at once, and faster as the round goes on.
+ */
+inline constexpr GameMode kGameModes[] = {
+        {"easy",   1, std::chrono::milliseconds(0),   kUntilHit,                      1, 1, 0, 0},
+        {"medium", 1, std::chrono::milliseconds(0),   std::chrono::milliseconds(1000), 1, 1, 0, 400},
+        {"hard",   4, std::chrono::milliseconds(350), std::chrono::milliseconds(1200), 1, 2, 1, 500},
+};
+
+/**
+ * @brief Retrieves a built-in mode.
+ *
+ * @param id The mode.
+ * @return Its parameters.
+ */
+inline const GameMode& gameMode(GameModeId id) {
+    return kGameModes[static_cast<int>(id)];
+}
+
+/**
+ * @brief Looks up a built-in mode by name.
+ *
+ * @param name The name, for example "hard".
+ * @return The mode, or nullptr if there is none with that name.
+ */
+inline const GameMode* findGameMode(const char* name) {
+    for (const GameMode& mode : kGameModes) {
+        if (std::strcmp(mode.name, name) == 0) {
+            return &mode;
+        }
+    }
+    return nullptr;
+}
+
+#endif // GAMEMODE_H
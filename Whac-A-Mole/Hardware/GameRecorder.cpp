@@ -0,0 +1,181 @@
+#include "GameRecorder.h"
+#include "GameLog.h"
+#include <cstring>
+#include <iostream>
+
+/**
+ * @class GameRecorder
+ * @brief Records rounds into a compact binary log for the GameReplayer.
+ * @author Anubhav Aery
+ */
+GameRecorder::GameRecorder() : path(), file(), round(), last(), recording(false) {
+    round.reserve(4096);
+}
+
+/**
+ * @brief Opens a log for appending, creating it if needed.
+ *
+ * A new or empty log gets the header; an existing one must start with it.
+ *
+ * @param logPath Path of the log.
+ * @return True on success, false if the file cannot be opened or is not a game log.
+ */
+bool GameRecorder::open(const std::string& logPath) {
+    close();
+    {
+        std::ifstream existing(logPath, std::ios::binary);
+        char magic[sizeof(GameLog::kMagic)];
+        if (existing && existing.read(magic, sizeof(magic)) &&
+            std::memcmp(magic, GameLog::kMagic, sizeof(magic)) != 0) {
+            std::cerr << logPath << " is not a game log." << std::endl;
+            return false;
+        }
+    }
+    file.open(logPath, std::ios::binary | std::ios::app | std::ios::ate);
+    if (!file) {
+        std::cerr << "Unable to open " << logPath << std::endl;
+        return false;
+    }
+    if (file.tellp() == 0) {
+        file.write(GameLog::kMagic, sizeof(GameLog::kMagic));
+        file.flush();
+    }
+    path = logPath;
+    return true;
+}
+
+/**
+ * @brief Closes the log. A round in progress is dropped.
+ */
+void GameRecorder::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+    file.clear();
+    recording = false;
+}
+
+/**
+ * @brief Checks whether a log is open.
+ *
+ * @return True if rounds are being recorded.
+ */
+bool GameRecorder::isOpen() const {
+    return file.is_open();
+}
+
+/**
+ * @brief Starts recording a round.
+ *
+ * @param seed Seed of the random engine that places the moles.
+ * @param mode Mode of the round; its parameters are stored, so the log does not depend on kGameModes.
+ * @param roundLength Length of the round.
+ * @param start Time at which the round started.
+ * @param startScore Score of the player at the start.
+ */
+void GameRecorder::beginRound(std::uint64_t seed, const GameMode& mode, std::chrono::nanoseconds roundLength,
+                              Clock::time_point start, int startScore) {
+    if (!isOpen()) {
+        return;
+    }
+    round.clear();
+    round.push_back(static_cast<std::uint8_t>(GameLog::Tag::Begin));
+    GameLog::putVarint(round, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count()));
+    GameLog::putVarint(round, seed);
+    GameLog::putVarint(round, GameLog::zigzag(startScore));
+    GameLog::putVarint(round, static_cast<std::uint64_t>(roundLength.count()));
+    std::size_t nameLength = std::strlen(mode.name);
+    GameLog::putVarint(round, nameLength);
+    round.insert(round.end(), mode.name, mode.name + nameLength);
+    GameLog::putVarint(round, GameLog::zigzag(mode.concurrentMoles));
+    GameLog::putVarint(round, GameLog::zigzag(mode.spawnInterval.count()));
+    GameLog::putVarint(round, GameLog::zigzag(mode.moleLifetime.count()));
+    GameLog::putVarint(round, GameLog::zigzag(mode.hitPoints));
+    GameLog::putVarint(round, GameLog::zigzag(mode.missPenalty));
+    GameLog::putVarint(round, GameLog::zigzag(mode.escapePenalty));
+    GameLog::putVarint(round, GameLog::zigzag(mode.speedUpPermille));
+    last = start;
+    recording = true;
+}
+
+/**
+ * @brief Records a call to MoleEngine::advance().
+ *
+ * @param at The time passed to advance().
+ * @param spawned The cells it spawned.
+ */
+void GameRecorder::recordAdvance(Clock::time_point at, std::uint16_t spawned) {
+    if (recording) {
+        put(static_cast<std::uint8_t>(GameLog::Tag::Advance), at);
+        GameLog::putVarint(round, spawned);
+    }
+}
+
+/**
+ * @brief Records a key press.
+ *
+ * @param at Time of the key event.
+ * @param key The key code.
+ */
+void GameRecorder::recordKey(Clock::time_point at, int key) {
+    if (recording) {
+        put(static_cast<std::uint8_t>(GameLog::Tag::Key), at);
+        GameLog::putVarint(round, GameLog::zigzag(key));
+    }
+}
+
+/**
+ * @brief Records a tick of the game loop.
+ *
+ * @param at Time of the tick.
+ */
+void GameRecorder::recordTick(Clock::time_point at) {
+    if (recording) {
+        put(static_cast<std::uint8_t>(GameLog::Tag::Tick), at);
+    }
+}
+
+/**
+ * @brief Ends the round and appends it to the log.
+ *
+ * The round is written with one write and flushed, so a crash loses at most the round
+ * in progress.
+ *
+ * @param score Final score of the player.
+ * @return True on success, false if the round could not be written.
+ */
+bool GameRecorder::endRound(int score) {
+    if (!recording) {
+        return false;
+    }
+    recording = false;
+    round.push_back(static_cast<std::uint8_t>(GameLog::Tag::End));
+    GameLog::putVarint(round, GameLog::zigzag(score));
+    file.write(reinterpret_cast<const char*>(round.data()), static_cast<std::streamsize>(round.size()));
+    file.flush();
+    if (!file) {
+        std::cerr << "Unable to write to " << path << std::endl;
+        file.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Retrieves the size of the current or last round.
+ *
+ * @return Bytes recorded for the round.
+ */
+std::size_t GameRecorder::getRoundBytes() const {
+    return round.size();
+}
+
+/**
+ * @brief Appends a tag and the time since the previous record.
+ */
+void GameRecorder::put(std::uint8_t tag, Clock::time_point at) {
+    round.push_back(tag);
+    GameLog::putVarint(round, GameLog::zigzag(std::chrono::duration_cast<std::chrono::nanoseconds>(at - last).count()));
+    last = at;
+}
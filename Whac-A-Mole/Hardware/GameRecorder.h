@@ -0,0 +1,112 @@
+#ifndef GAMERECORDER_H
+#define GAMERECORDER_H
+
+#include "GameMode.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @class GameRecorder
+ * @brief Records rounds into a compact binary log for the GameReplayer.
+ *
+ * A round is the seed of the random engine, the mode, and every call the game loop makes
+ * into the MoleEngine with its timestamp: each advance, with the cells it spawned, each key
+ * and each tick. That is enough to run the round again through the same engine and get the
+ * same score. Records go to an in-memory buffer during the round, so recording costs a few
+ * byte appends per loop pass; the buffer is written to the file by endRound(). The format
+ * is described in GameLog.h.
+ * @author Anubhav Aery
+ */
+class GameRecorder {
+public:
+    using Clock = std::chrono::steady_clock; ///< Clock of every time point passed in.
+
+    /**
+     * @brief Constructs a recorder without a file; nothing is recorded until open().
+     */
+    GameRecorder();
+
+    /**
+     * @brief Opens a log for appending, creating it if needed.
+     *
+     * @param path Path of the log.
+     * @return True on success, false if the file cannot be opened or is not a game log.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Closes the log. A round in progress is dropped.
+     */
+    void close();
+
+    /**
+     * @brief Checks whether a log is open.
+     *
+     * @return True if rounds are being recorded.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Starts recording a round.
+     *
+     * @param seed Seed of the random engine that places the moles.
+     * @param mode Mode of the round.
+     * @param roundLength Length of the round.
+     * @param start Time at which the round started.
+     * @param startScore Score of the player at the start.
+     */
+    void beginRound(std::uint64_t seed, const GameMode& mode, std::chrono::nanoseconds roundLength,
+                    Clock::time_point start, int startScore);
+
+    /**
+     * @brief Records a call to MoleEngine::advance().
+     *
+     * @param at The time passed to advance().
+     * @param spawned The cells it spawned.
+     */
+    void recordAdvance(Clock::time_point at, std::uint16_t spawned);
+
+    /**
+     * @brief Records a key press.
+     *
+     * @param at Time of the key event.
+     * @param key The key code.
+     */
+    void recordKey(Clock::time_point at, int key);
+
+    /**
+     * @brief Records a tick of the game loop.
+     *
+     * @param at Time of the tick.
+     */
+    void recordTick(Clock::time_point at);
+
+    /**
+     * @brief Ends the round and appends it to the log.
+     *
+     * @param score Final score of the player.
+     * @return True on success, false if the round could not be written.
+     */
+    bool endRound(int score);
+
+    /**
+     * @brief Retrieves the size of the current or last round.
+     *
+     * @return Bytes recorded for the round.
+     */
+    std::size_t getRoundBytes() const;
+
+private:
+    void put(std::uint8_t tag, Clock::time_point at);
+
+    std::string path;                 ///< Path of the open log.
+    std::ofstream file;               ///< The open log.
+    std::vector<std::uint8_t> round;  ///< Records of the round in progress.
+    Clock::time_point last;           ///< Timestamp of the previous record of the round.
+    bool recording;                   ///< True between beginRound() and endRound().
+};
+
+#endif // GAMERECORDER_H
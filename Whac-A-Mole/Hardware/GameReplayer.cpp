@@ -0,0 +1,204 @@
+#include "GameReplayer.h"
+#include "GameLog.h"
+#include "LedLayout.h"
+#include "Timer.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+/**
+ * @class GameReplayer
+ * @brief Plays rounds recorded by the GameRecorder back through the MoleEngine.
+ * @author Anubhav Aery
+ */
+GameReplayer::GameReplayer(Speed replaySpeed)
+        : speed(replaySpeed), data(), position(0), modeName(), mode(gameMode(GameModeId::Easy)), moles(),
+          random(0), player(), last(), recordedStart(), replayStart(), frame(), showing(false) {}
+
+/**
+ * @brief Loads a log recorded by the GameRecorder.
+ *
+ * The whole log is read into memory, so the replay itself does no I/O.
+ *
+ * @param path Path of the log.
+ * @return True on success, false if the file cannot be read or is not a game log.
+ */
+bool GameReplayer::open(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Unable to open " << path << std::endl;
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(GameLog::kMagic) ||
+        std::memcmp(data.data(), GameLog::kMagic, sizeof(GameLog::kMagic)) != 0) {
+        std::cerr << path << " is not a game log." << std::endl;
+        data.clear();
+        return false;
+    }
+    position = sizeof(GameLog::kMagic);
+    return true;
+}
+
+/**
+ * @brief Sets the backend that shows the moles during the replay.
+ *
+ * @param backend An initialised backend, or nullptr to replay without LEDs.
+ */
+void GameReplayer::setBackend(GpioBackend* backend) {
+    frame.setBackend(backend);
+    showing = backend != nullptr;
+}
+
+/**
+ * @brief Replays the next round of the log.
+ *
+ * @param game Receives the outcome of the round.
+ * @return True if a round was replayed, false at the end of the log or if it is corrupt.
+ */
+bool GameReplayer::next(ReplayedGame& game) {
+    if (atEnd() || data.empty()) {
+        return false;
+    }
+    if (data[position++] != static_cast<std::uint8_t>(GameLog::Tag::Begin) || !readBegin()) {
+        std::cerr << "Corrupt round at offset " << position << " of the game log." << std::endl;
+        return false;
+    }
+    game.mode = modeName;
+    game.seed = random.getSeed();
+    game.keys = 0;
+    game.spawnsMatched = true;
+
+    while (position < data.size()) {
+        auto tag = static_cast<GameLog::Tag>(data[position++]);
+        if (tag == GameLog::Tag::End) {
+            std::int64_t score;
+            if (!readSigned(score)) {
+                break;
+            }
+            game.recordedScore = static_cast<int>(score);
+            game.score = player.getScore();
+            game.hits = moles.getHits();
+            game.misses = moles.getMisses();
+            game.escapes = moles.getEscapes();
+            if (showing) {
+                frame.clear();
+                frame.flush();
+            }
+            return true;
+        }
+
+        std::int64_t delta;
+        if (!readSigned(delta)) {
+            break;
+        }
+        MoleEngine::Clock::time_point at = last + std::chrono::nanoseconds(delta);
+        last = at;
+        if (speed == Speed::RealTime) {
+            waitUntil(at);
+        }
+
+        // The same calls, in the same order, as GameController::inGame()
+        if (tag == GameLog::Tag::Advance) {
+            std::uint64_t spawned;
+            if (!read(spawned)) {
+                break;
+            }
+            MoleEngine::Step step = moles.advance(at, random);
+            game.spawnsMatched = game.spawnsMatched && step.spawned == spawned;
+            if (showing) {
+                frame.setMask(moles.getMask());
+                frame.flush();
+            }
+            player.addPoints(step.scoreDelta);
+        } else if (tag == GameLog::Tag::Key) {
+            std::int64_t key;
+            if (!readSigned(key)) {
+                break;
+            }
+            ++game.keys;
+            int cell = kLedLayout.cellForKey(static_cast<int>(key));
+            if (cell != LedLayout::kNoCell) {
+                player.addPoints(moles.whack(cell, at).scoreDelta);
+            }
+        } else if (tag != GameLog::Tag::Tick) {
+            break;
+        }
+    }
+    std::cerr << "Corrupt round at offset " << position << " of the game log." << std::endl;
+    position = data.size();
+    return false;
+}
+
+/**
+ * @brief Checks whether the log was read to its end without error.
+ *
+ * @return True once every round was replayed.
+ */
+bool GameReplayer::atEnd() const {
+    return position >= data.size();
+}
+
+/**
+ * @brief Reads an unsigned varint at the current position.
+ */
+bool GameReplayer::read(std::uint64_t& value) {
+    return GameLog::getVarint(data.data(), data.size(), position, value);
+}
+
+/**
+ * @brief Reads a zigzag-encoded varint at the current position.
+ */
+bool GameReplayer::readSigned(std::int64_t& value) {
+    std::uint64_t raw;
+    if (!read(raw)) {
+        return false;
+    }
+    value = GameLog::unzigzag(raw);
+    return true;
+}
+
+/**
+ * @brief Reads the body of a Begin record and prepares the engine for the round.
+ */
+bool GameReplayer::readBegin() {
+    std::uint64_t start, seed, length, nameLength;
+    std::int64_t startScore, concurrent, interval, lifetime, hit, miss, escape, speedUp;
+    if (!read(start) || !read(seed) || !readSigned(startScore) || !read(length) || !read(nameLength) ||
+        nameLength > data.size() - position) {
+        return false;
+    }
+    modeName.assign(reinterpret_cast<const char*>(data.data() + position), nameLength);
+    position += nameLength;
+    if (!readSigned(concurrent) || !readSigned(interval) || !readSigned(lifetime) || !readSigned(hit) ||
+        !readSigned(miss) || !readSigned(escape) || !readSigned(speedUp) || concurrent < 1 ||
+        concurrent > LedLayout::kCellCount) {
+        return false;
+    }
+    // Intervals that scale to zero would keep the engine spawning and escaping at one time,
+    // and intervals longer than kUntilHit could overflow once converted to nanoseconds
+    if (lifetime <= 0 || lifetime > kUntilHit.count() || interval < 0 || interval > kUntilHit.count() ||
+        speedUp < 0 || speedUp >= 1000) {
+        return false;
+    }
+    mode = GameMode{modeName.c_str(), static_cast<int>(concurrent), std::chrono::milliseconds(interval),
+                    std::chrono::milliseconds(lifetime), static_cast<int>(hit), static_cast<int>(miss),
+                    static_cast<int>(escape), static_cast<int>(speedUp)};
+
+    recordedStart = MoleEngine::Clock::time_point(std::chrono::nanoseconds(start));
+    replayStart = MoleEngine::Clock::now();
+    last = recordedStart;
+    random.seed(seed);
+    player = Player();
+    player.addPoints(static_cast<int>(startScore));
+    moles.start(mode, recordedStart, std::chrono::nanoseconds(length));
+    return true;
+}
+
+/**
+ * @brief Sleeps until the replay reaches a recorded time.
+ */
+void GameReplayer::waitUntil(MoleEngine::Clock::time_point at) const {
+    Timer::sleepUntil(replayStart + (at - recordedStart));
+}
@@ -0,0 +1,119 @@
+#ifndef GAMEREPLAYER_H
+#define GAMEREPLAYER_H
+
+#include "GameMode.h"
+#include "LedFrameBuffer.h"
+#include "MoleEngine.h"
+#include "Player.h"
+#include "Random.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class GpioBackend;
+
+/**
+ * @struct ReplayedGame
+ * @brief The outcome of one replayed round.
+ */
+struct ReplayedGame {
+    std::string mode;          ///< Name of the mode of the round.
+    std::uint64_t seed;        ///< Seed of the random engine.
+    int recordedScore;         ///< Final score stored in the log.
+    int score;                 ///< Final score of the replay.
+    std::uint32_t hits;        ///< Moles hit.
+    std::uint32_t misses;      ///< Keys on empty cells.
+    std::uint32_t escapes;     ///< Moles that escaped.
+    std::uint32_t keys;        ///< Key records replayed.
+    bool spawnsMatched;        ///< True if every advance spawned the recorded cells.
+
+    /**
+     * @brief Checks whether the replay reproduced the recorded round.
+     *
+     * @return True if the moles and the final score are identical.
+     */
+    bool matches() const {
+        return spawnsMatched && score == recordedScore;
+    }
+};
+
+/**
+ * @class GameReplayer
+ * @brief Plays rounds recorded by the GameRecorder back through the MoleEngine.
+ *
+ * Each round is run again from its seed and mode, feeding the recorded advances and keys
+ * to a MoleEngine and a Player exactly as GameController::inGame() does, and the result is
+ * compared with the recording. At real-time speed the replayer sleeps until the recorded
+ * time of each record and can show the moles through a GPIO backend; at maximum speed it
+ * runs the records back to back, which replays thousands of rounds per second.
+ * @author Anubhav Aery
+ */
+class GameReplayer {
+public:
+    /**
+     * @brief Pace of the replay.
+     */
+    enum class Speed {
+        RealTime, ///< Records are replayed at their recorded times.
+        Maximum   ///< Records are replayed without waiting.
+    };
+
+    /**
+     * @brief Constructs a replayer without a log.
+     *
+     * @param speed Pace of the replay.
+     */
+    explicit GameReplayer(Speed speed = Speed::Maximum);
+
+    /**
+     * @brief Loads a log recorded by the GameRecorder.
+     *
+     * @param path Path of the log.
+     * @return True on success, false if the file cannot be read or is not a game log.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Sets the backend that shows the moles during the replay.
+     *
+     * @param backend An initialised backend, or nullptr to replay without LEDs.
+     */
+    void setBackend(GpioBackend* backend);
+
+    /**
+     * @brief Replays the next round of the log.
+     *
+     * @param game Receives the outcome of the round.
+     * @return True if a round was replayed, false at the end of the log or if it is corrupt.
+     */
+    bool next(ReplayedGame& game);
+
+    /**
+     * @brief Checks whether the log was read to its end without error.
+     *
+     * @return True once every round was replayed.
+     */
+    bool atEnd() const;
+
+private:
+    bool read(std::uint64_t& value);
+    bool readSigned(std::int64_t& value);
+    bool readBegin();
+    void waitUntil(MoleEngine::Clock::time_point at) const;
+
+    Speed speed;                      ///< Pace of the replay.
+    std::vector<std::uint8_t> data;   ///< The whole log.
+    std::size_t position;             ///< Offset of the next record.
+    std::string modeName;             ///< Name of the mode of the current round.
+    GameMode mode;                    ///< Mode of the current round, named by modeName.
+    MoleEngine moles;                 ///< Engine the round is replayed through.
+    Random random;                    ///< Random engine, seeded from the round.
+    Player player;                    ///< Score of the round.
+    MoleEngine::Clock::time_point last;     ///< Timestamp of the previous record.
+    MoleEngine::Clock::time_point recordedStart; ///< Recorded start of the round.
+    MoleEngine::Clock::time_point replayStart;   ///< Start of the replay of the round.
+    LedFrameBuffer frame;             ///< Shows the moles if a backend is set.
+    bool showing;                     ///< True if a backend is set.
+};
+
+#endif // GAMEREPLAYER_H
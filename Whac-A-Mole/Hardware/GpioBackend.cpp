@@ -0,0 +1,55 @@
+#include "GpioBackend.h"
+#include "ChardevGpioBackend.h"
+#include "SimulatedGpioBackend.h"
+#ifdef WHAC_HAVE_PIGPIO
+#include "PigpioBackend.h"
+#endif
+#include <cstdlib>
+#include <stdexcept>
+
+/**
+ * @class GpioBackend
+ * @brief Runtime selection of the GPIO implementation.
+ * @author Anubhav Aery
+ */
+
+/**
+ * @brief Creates a backend by name.
+ *
+ * @param name "pigpio", "chardev" or "sim".
+ * @return The new backend.
+ */
+std::unique_ptr<GpioBackend> GpioBackend::create(const std::string& name) {
+    if (name == "pigpio") {
+#ifdef WHAC_HAVE_PIGPIO
+        return std::unique_ptr<GpioBackend>(new PigpioBackend());
+#else
+        throw std::runtime_error("This build has no pigpio support.");
+#endif
+    }
+    if (name == "chardev") {
+        const char* chip = std::getenv("WHAC_GPIO_CHIP");
+        return std::unique_ptr<GpioBackend>(new ChardevGpioBackend(chip ? chip : "/dev/gpiochip0"));
+    }
+    if (name == "sim") {
+        return std::unique_ptr<GpioBackend>(new SimulatedGpioBackend());
+    }
+    throw std::runtime_error("Unknown GPIO backend: " + name);
+}
+
+/**
+ * @brief Creates the backend selected by WHAC_GPIO_BACKEND.
+ *
+ * @return The new backend.
+ */
+std::unique_ptr<GpioBackend> GpioBackend::createFromEnvironment() {
+    const char* name = std::getenv("WHAC_GPIO_BACKEND");
+    if (name && *name) {
+        return create(name);
+    }
+#ifdef WHAC_HAVE_PIGPIO
+    return create("pigpio");
+#else
+    return create("chardev");
+#endif
+}
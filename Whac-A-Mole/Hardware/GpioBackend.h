@@ -0,0 +1,210 @@
+#ifndef GPIOBACKEND_H
+#define GPIOBACKEND_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @struct GpioPulse
+ * @brief One step of a waveform: pins to change, then the time until the next step.
+ *
+ * Laid out like pigpio's gpioPulse_t, so a pulse list can be handed to the DMA engine as it is.
+ */
+struct GpioPulse {
+    std::uint32_t setMask;   ///< Pins (bit n = GPIO n) driven high at the start of the pulse.
+    std::uint32_t clearMask; ///< Pins (bit n = GPIO n) driven low at the start of the pulse.
+    std::uint32_t delayUs;   ///< Microseconds until the next pulse starts.
+};
+
+/**
+ * @struct GpioEdge
+ * @brief A level change on an input pin, timed by the backend when it happened.
+ */
+struct GpioEdge {
+    std::chrono::steady_clock::time_point at; ///< When the pin changed, not when it was reported.
+    int pin;   ///< The GPIO pin number.
+    int level; ///< The new level, 1 for high and 0 for low.
+};
+
+/**
+ * @brief Receives the edges of the watched pins, on a thread of the backend.
+ *
+ * @param edge The edge.
+ * @param context The pointer passed to GpioBackend::watchEdges().
+ */
+using GpioEdgeHandler = void (*)(const GpioEdge& edge, void* context);
+
+/**
+ * @class GpioBackend
+ * @brief Abstract access to the GPIO pins that drive the LED matrix.
+ *
+ * The game logic talks to the pins only through this interface, so the hardware
+ * library can be swapped for a mock when measuring or testing off the Raspberry Pi.
+ * All pins used by the cabinet are in the first bank (GPIO 0-31), which the
+ * SoC can set and clear with one register write each.
+ *
+ * Three implementations exist: "pigpio" (PigpioBackend, needs root and is only built when
+ * the pigpio library is found), "chardev" (ChardevGpioBackend, the Linux GPIO character
+ * device) and "sim" (SimulatedGpioBackend, an in-memory board). The backend is chosen at
+ * runtime with create().
+ *
+ * A backend may also play waveforms: a list of GpioPulse steps that the hardware applies on
+ * its own clock, without the CPU. Backends without a DMA engine keep the default, which
+ * reports that waveforms are not supported.
+ *
+ * Likewise a backend may dim a pin with pulse-width modulation timed by the hardware, so
+ * the CPU only sets a duty cycle when the brightness changes. The default approximates a
+ * duty cycle by driving the pin fully on or off.
+ *
+ * Buttons wired to input pins can be watched for edges, each timed by the backend when it
+ * sampled the pin rather than when the game gets to read it. Backends that cannot watch
+ * pins keep the default, and the buttons are not used.
+ * @author Anubhav Aery
+ */
+class GpioBackend {
+public:
+    /**
+     * @brief Virtual destructor for GpioBackend.
+     */
+    virtual ~GpioBackend() = default;
+
+    /**
+     * @brief Creates a backend by name.
+     *
+     * Throws a runtime error for an unknown name or for "pigpio" in a build without pigpio.
+     *
+     * @param name "pigpio", "chardev" or "sim".
+     * @return The new backend, not yet initialised.
+     */
+    static std::unique_ptr<GpioBackend> create(const std::string& name);
+
+    /**
+     * @brief Creates the backend selected by the environment.
+     *
+     * Reads the backend name from WHAC_GPIO_BACKEND and the chip device used by "chardev"
+     * from WHAC_GPIO_CHIP. Without WHAC_GPIO_BACKEND, pigpio is used when it was built in
+     * and the character device otherwise.
+     *
+     * @return The new backend, not yet initialised.
+     */
+    static std::unique_ptr<GpioBackend> createFromEnvironment();
+
+    /**
+     * @brief Initialises the GPIO hardware.
+     *
+     * @return True on success, false otherwise.
+     */
+    virtual bool initialise() = 0;
+
+    /**
+     * @brief Releases the GPIO hardware.
+     */
+    virtual void terminate() = 0;
+
+    /**
+     * @brief Configures a pin as an output.
+     *
+     * @param pin The GPIO pin number.
+     */
+    virtual void setOutput(int pin) = 0;
+
+    /**
+     * @brief Drives a single pin.
+     *
+     * @param pin The GPIO pin number.
+     * @param level 1 for high, 0 for low.
+     */
+    virtual void write(int pin, int level) = 0;
+
+    /**
+     * @brief Drives several pins of the first bank at once.
+     *
+     * Every pin whose bit is set in @p setMask goes high, every pin whose bit is set in
+     * @p clearMask goes low. An empty mask costs no register write.
+     *
+     * @param setMask Pins (bit n = GPIO n) to drive high.
+     * @param clearMask Pins (bit n = GPIO n) to drive low.
+     */
+    virtual void writeBank(std::uint32_t setMask, std::uint32_t clearMask) = 0;
+
+    /**
+     * @brief Checks whether sendWave() is supported.
+     *
+     * @return False unless the backend overrides it.
+     */
+    virtual bool supportsWaves() const { return false; }
+
+    /**
+     * @brief Replaces the waveform being played with a new one, started at once.
+     *
+     * Pulses of the previous waveform that have not started yet are dropped. The default
+     * implementation plays nothing.
+     *
+     * @param pulses The steps, in order; the first one is applied immediately.
+     * @param count Number of pulses.
+     * @return True if the waveform is playing.
+     */
+    virtual bool sendWave(const GpioPulse* /*pulses*/, std::size_t /*count*/) { return false; }
+
+    /**
+     * @brief Stops the waveform being played; the pins keep their levels.
+     */
+    virtual void cancelWave() {}
+
+    /**
+     * @brief Checks whether setPwm() dims a pin rather than switching it.
+     *
+     * @return False unless the backend overrides it.
+     */
+    virtual bool supportsPwm() const { return false; }
+
+    /**
+     * @brief Sets the frequency of the pulses setPwm() starts on a pin.
+     *
+     * The default implementation does nothing.
+     *
+     * @param pin The GPIO pin number.
+     * @param frequencyHz The requested frequency; the backend may round it.
+     */
+    virtual void setPwmFrequency(int /*pin*/, int /*frequencyHz*/) {}
+
+    /**
+     * @brief Dims a pin by pulse-width modulation.
+     *
+     * A duty cycle of 0 stops the pulses and leaves the pin low, so it can be written again
+     * with write() and writeBank(). The default implementation drives the pin high from a
+     * duty cycle of 128 up.
+     *
+     * @param pin The GPIO pin number.
+     * @param duty The share of each period the pin is high, out of 255.
+     */
+    virtual void setPwm(int pin, std::uint8_t duty) { write(pin, duty >= 128 ? 1 : 0); }
+
+    /**
+     * @brief Checks whether watchEdges() is supported.
+     *
+     * @return False unless the backend overrides it.
+     */
+    virtual bool supportsEdges() const { return false; }
+
+    /**
+     * @brief Watches input pins for edges, replacing the pins watched before.
+     *
+     * The pins are configured as inputs with the pull-up on, so a button wired from the pin
+     * to ground reads 0 while it is pressed. The handler is called on a thread of the
+     * backend and must not block. An empty mask stops watching. Once this returns, the
+     * handler passed before has finished any call in progress and is not called again, so
+     * its context may be destroyed. The default implementation watches nothing.
+     *
+     * @param pins Pins (bit n = GPIO n) to watch.
+     * @param handler Receives every edge.
+     * @param context Passed to the handler.
+     * @return True if the pins are watched.
+     */
+    virtual bool watchEdges(std::uint32_t /*pins*/, GpioEdgeHandler /*handler*/, void* /*context*/) { return false; }
+};
+
+#endif // GPIOBACKEND_H
@@ -1,5 +1,7 @@
 #include "HighScore.h"
-#include <fstream>
+#include "ScoreProtocol.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 
 /**
@@ -7,8 +9,96 @@
  * @brief Manages high score data for the game.
  *
  * This class is responsible for reading, writing, and maintaining high score data.
- * It interacts with a file to persist high score information.
+ * It persists high score information through the whac-scored daemon, or in a local
+ * ScoreStore when the daemon is not running.
  */
+HighScore::HighScore(std::size_t boardSize, bool bestPerPlayer)
+        : store("highScores", kIndexCapacity), journal("highScores"), board(boardSize, bestPerPlayer) {
+    const char* path = std::getenv("WHAC_SCORE_SOCKET");
+    socketPath = path ? path : ScoreProtocol::kDefaultSocket;
+    std::vector<ScoreRecord> top;
+    if (!socketPath.empty() && client.connect(socketPath) && client.top(boardSize, bestPerPlayer, top)) {
+        for (const ScoreRecord& record : top) {
+            board.offer(record);
+        }
+        return;
+    }
+    client.close();
+    openLocalStore();
+}
+
+/**
+ * @brief Destructor for HighScore.
+ *
+ * Makes a last attempt to save the scores that could not be saved yet, and reports the
+ * ones that are lost.
+ */
+HighScore::~HighScore() {
+    if (!unsaved.empty() && !saveUnsaved()) {
+        std::cerr << unsaved.size() << " scores could not be saved and are lost." << std::endl;
+    }
+}
+
+/**
+ * @brief Opens the local score store and its journal and fills the leaderboard from them.
+ *
+ * If another HighScore or the daemon owns the journal, the store is opened read-only and
+ * the scores the owner has not folded yet are read from the journal file.
+ *
+ * @return True if the store is open.
+ */
+bool HighScore::openLocalStore() {
+    if (!ownStore()) {
+        if (store.open(true)) {
+            store.load(board);
+        }
+        ScoreJournal::loadUnfolded("highScores", store, board);
+        return store.isOpen();
+    }
+    // The index already holds the best scores; only a per-player or larger board needs the whole log
+    if (board.isBestPerPlayer() || board.capacity() > store.topCount()) {
+        store.load(board);
+    } else {
+        const ScoreRecord* top = store.top();
+        for (std::size_t i = 0; i < store.topCount(); ++i) {
+            board.offer(top[i]);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Takes the journal lock and opens the store for writing, unless it is already owned.
+ *
+ * A store opened read-only is reopened. Imports 'highScores.txt' the first time the store is
+ * created. Opening the journal folds the scores a crash left in it into the store.
+ *
+ * @return True if this HighScore owns the store and its journal is open.
+ */
+bool HighScore::ownStore() {
+    if (journal.isOpen()) {
+        return true;
+    }
+    if (!journal.lock()) {
+        return false;
+    }
+    store.close();
+    if (!store.open()) {
+        journal.close();
+        return false;
+    }
+    if (store.wasCreated()) {
+        std::size_t imported = store.importText("highScores.txt");
+        if (imported > 0) {
+            std::cout << "Imported " << imported << " scores from highScores.txt" << std::endl;
+        }
+    }
+    if (!journal.open(store)) {
+        store.close();
+        return false;
+    }
+    return true;
+}
 
 /**
  * @brief Retrieves high scores as a sorted vector.
@@ -16,58 +106,125 @@
  * Returns a vector of pairs, each containing a score and the corresponding player's name.
  * The vector is sorted based on the score.
  *
+ * @param limit Maximum number of entries to return.
  * @return Vector of pairs with score and player name.
  * @author Eseosa Emmanuel Atekha
  */
-std::vector<std::pair<int, std::string>> HighScore::getHighScores() const {
+std::vector<std::pair<int, std::string>> HighScore::getHighScores(std::size_t limit) const {
     std::vector<std::pair<int, std::string>> scores;
-    for (const auto& entry : highScoresMap) {
-        scores.push_back({entry.first, entry.second});
+    scores.reserve(std::min(limit, board.size()));
+    for (const ScoreRecord& record : board) {
+        if (scores.size() == limit) {
+            break;
+        }
+        scores.push_back({record.score, record.getName()});
     }
     return scores;
 }
 
 /**
- * @brief Reads high scores from a file and prints them to the console.
+ * @brief Prints the high scores to the console.
  *
- * Opens and reads the 'highScores.txt' file, if available, and prints the high scores
- * to the console. The scores are inserted into a map for sorting purposes.
+ * Prints the leaderboard, best first, with the median and 99th percentile reaction time of
+ * entries that have one. Calling it repeatedly prints the same entries.
  */
 void HighScore::print() {
-    std::ifstream inputFile("highScores.txt");
-    if (inputFile.is_open()) {
-        std::string name;
-        int score;
-        while (inputFile >> name >> score) {
-            highScoresMap.insert(std::make_pair(score, name));
-        }
-        inputFile.close();
-
-        std::cout << "Name " << "Score" << std::endl;
-        for (auto rit = highScoresMap.rbegin(); rit != highScoresMap.rend(); ++rit) {
-            std::cout << rit->second << " " << rit->first << std::endl;
-        }
-
-    } else {
+    if (!client.isConnected() && !store.isOpen()) {
         std::cerr << "Unable to open the file." << std::endl;
+        return;
+    }
+    std::cout << "Name " << "Score" << std::endl;
+    for (const ScoreRecord& record : board) {
+        std::cout << record.getName() << " " << record.score;
+        if (record.reaction.samples > 0) {
+            std::cout << " (reaction p50 " << record.reaction.p50Us / 1000.0 << " ms, p99 "
+                      << record.reaction.p99Us / 1000.0 << " ms)";
+        }
+        std::cout << std::endl;
     }
 }
 
 /**
- * @brief Adds a new high score to the file.
+ * @brief Adds a new high score.
  *
- * Appends a new high score entry, consisting of the player's name and score, to the 'highScores.txt' file.
- * If the file cannot be opened, an error message is displayed.
+ * Queues the score and saves the queue with saveUnsaved(). If it cannot be saved, an
+ * error message says so and the score stays queued, to be saved with the next score or
+ * when the HighScore is destroyed.
  *
  * @param score The score achieved by the player.
  * @param playerName The name of the player.
+ * @param reaction The player's reaction-time percentiles for the game.
+ * @return The position of the new entry on the leaderboard, starting at 1, or 0 if it did
+ *         not make the board or was not saved.
  */
-void HighScore::add(int score, const std::string& playerName) {
-    std::ofstream outputFile("highScores.txt", std::ios::app);
-    if (outputFile.is_open()) {
-        outputFile << playerName << " " << score << std::endl;
-        outputFile.close();
-    } else {
-        std::cerr << "Unable to open the file for writing." << std::endl;
+int HighScore::add(int score, const std::string& playerName, const ReactionSummary& reaction) {
+    unsaved.push_back(ScoreRecord::make(score, playerName, 0, reaction));
+    ScoreRecord saved{};
+    if (!saveUnsaved(&saved)) {
+        std::cerr << "The score could not be saved yet: the score daemon does not answer and the score "
+                     "files are in use. It is kept and saved with the next score." << std::endl;
+        return 0;
     }
+    return static_cast<int>(board.rankOf(saved));
+}
+
+/**
+ * @brief Saves the queued scores and offers them to the leaderboard.
+ *
+ * If this HighScore owns the local store, the scores go to its journal. Otherwise they are
+ * submitted to the daemon, which is reconnected first if it went away or was started after
+ * the game; the daemon is waited for until the scores are durable. If the daemon does not
+ * answer either, the local store is taken over if its owner has gone. A submission that
+ * timed out may still have been saved by the daemon, so a score can then be saved twice;
+ * that is preferred to losing it.
+ *
+ * @param last Receives the last score saved, with its sequence number, if not null.
+ * @return True if the queue is empty afterwards.
+ */
+bool HighScore::saveUnsaved(ScoreRecord* last) {
+    if (unsaved.empty()) {
+        return true;
+    }
+    if (!journal.isOpen()) {
+        if (!client.isConnected() && !socketPath.empty()) {
+            client.connect(socketPath);
+        }
+        while (client.isConnected() && !unsaved.empty()) {
+            std::size_t count = std::min<std::size_t>(unsaved.size(), ScoreProtocol::kMaxRecords);
+            std::uint32_t first = 0;
+            if (!client.submit(unsaved.data(), count, &first)) {
+                break;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                unsaved[i].sequence = first + static_cast<std::uint32_t>(i);
+                board.offer(unsaved[i]);
+            }
+            if (last) {
+                *last = unsaved[count - 1];
+            }
+            unsaved.erase(unsaved.begin(), unsaved.begin() + static_cast<std::ptrdiff_t>(count));
+        }
+        // Writing next to another owner would interleave in the files; it may have closed by now
+        if (unsaved.empty() || !ownStore()) {
+            return unsaved.empty();
+        }
+    }
+    for (ScoreRecord& record : unsaved) {
+        record.sequence = journal.submit(record);
+        board.offer(record);
+    }
+    if (last) {
+        *last = unsaved.back();
+    }
+    unsaved.clear();
+    return true;
+}
+
+/**
+ * @brief Retrieves the leaderboard.
+ *
+ * @return The board of entries shown to players.
+ */
+const Leaderboard& HighScore::getLeaderboard() const {
+    return board;
 }
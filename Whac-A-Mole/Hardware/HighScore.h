@@ -1,40 +1,79 @@
 #ifndef HIGHSCORE_H
 #define HIGHSCORE_H
 
-#include <map>
 #include <string>
 #include <vector>
-#include <functional> // Include for std::greater
+#include "Leaderboard.h"
+#include "ScoreClient.h"
+#include "ScoreJournal.h"
+#include "ScoreStore.h"
 
 /**
  * @class HighScore
  * @brief Manages high score data for the game.
  *
- * This class handles the storage, retrieval, and updating of high scores. It supports
- * reading and writing high score data to a file and provides functionalities to print
+ * This class handles the storage, retrieval, and updating of high scores. Scores are kept
+ * in a binary ScoreStore ("highScores.log" and "highScores.idx"); the first time the store
+ * is created, an existing 'highScores.txt' is imported into it. New scores go through a
+ * ScoreJournal ("highScores.wal"), so add() returns without waiting for the disk, and a
+ * crash loses at most the scores of the last group commit and never leaves a torn entry.
+ * Only one HighScore or daemon at a time owns the journal, and only the owner writes to the
+ * store; others open the store read-only, show the scores the owner has not folded yet as
+ * well, and cannot save until the owner is gone. The entries shown are kept in a fixed-size
+ * Leaderboard, optionally with one entry per player. It provides functionalities to print
  * and retrieve sorted high score entries.
+ *
+ * When the whac-scored daemon is running, HighScore is a thin client of it instead: the
+ * board is filled from the daemon and new scores are submitted to it, so several game
+ * processes on one machine share one leaderboard. The socket is taken from
+ * WHAC_SCORE_SOCKET, or ScoreProtocol::kDefaultSocket if it is unset; an empty value
+ * disables the daemon. If the daemon cannot be reached, the local store is used; a daemon
+ * that goes away or starts later is connected again on the next save. A score that neither
+ * can take is kept and saved with the next one.
  * @author Eseosa Emmanuel Atekha
  */
 class HighScore {
 public:
     /**
-     * @brief Reads and prints high scores from a file.
+     * @brief Constructor for HighScore.
+     *
+     * Fills the leaderboard from the whac-scored daemon if it answers. Otherwise opens the
+     * score store in the working directory, importing 'highScores.txt' if the store did not
+     * exist yet, and fills the leaderboard from it.
+     *
+     * @param boardSize Number of entries on the leaderboard.
+     * @param bestPerPlayer If true, show only the best score of each player.
+     */
+    explicit HighScore(std::size_t boardSize = kIndexCapacity, bool bestPerPlayer = false);
+
+    /**
+     * @brief Destructor for HighScore.
+     *
+     * Tries once more to save the scores that are still queued.
+     */
+    ~HighScore();
+
+    /**
+     * @brief Prints the high scores.
      *
-     * Opens the 'highScores.txt' file, reads high score entries, and prints them.
-     * High scores are stored in a map sorted in descending order.
+     * Prints the leaderboard, best first. Nothing is parsed or allocated per entry.
      */
     void print();
 
     /**
-     * @brief Adds a new high score entry to a file.
+     * @brief Adds a new high score entry.
      *
-     * Appends a player's name and score to the 'highScores.txt' file. High scores are stored
-     * in a multimap in descending order.
+     * Submits the score to the daemon, or to the local score journal if the daemon cannot
+     * be reached, and offers it to the leaderboard. The local path does not wait for the disk.
+     * If neither can take it, the score is kept and saved with the next score.
      *
      * @param score The score achieved by the player.
      * @param playerName The name of the player.
+     * @param reaction The player's reaction-time percentiles for the game.
+     * @return The position of the new entry on the leaderboard, starting at 1, or 0 if it
+     *         did not make the board or was not saved.
      */
-    void add(int score, const std::string& playerName);
+    int add(int score, const std::string& playerName, const ReactionSummary& reaction = ReactionSummary{});
 
     /**
      * @brief Retrieves sorted high scores as a vector.
@@ -42,13 +81,31 @@ public:
      * Returns a vector of pairs, each containing a score and the corresponding player's name.
      * The vector is sorted in descending order based on the score.
      *
+     * @param limit Maximum number of entries to return.
      * @return Vector of pairs with score and player name.
      */
-    std::vector<std::pair<int, std::string>> getHighScores() const;
+    std::vector<std::pair<int, std::string>> getHighScores(std::size_t limit = kIndexCapacity) const;
+
+    /**
+     * @brief Retrieves the leaderboard.
+     *
+     * @return The board; iterate it for the entries, best first.
+     */
+    const Leaderboard& getLeaderboard() const;
+
+    static constexpr std::uint32_t kIndexCapacity = 1000; ///< Number of best scores kept in the index.
 
 private:
-    // Use std::greater to sort scores in descending order
-    std::multimap<int, std::string, std::greater<int>> highScoresMap; ///< Map storing high scores in descending order.
+    bool openLocalStore();
+    bool ownStore();
+    bool saveUnsaved(ScoreRecord* last = nullptr);
+
+    std::string socketPath;           ///< Socket of the daemon, or empty if the daemon is disabled.
+    std::vector<ScoreRecord> unsaved; ///< Scores neither the daemon nor the local store took yet.
+    ScoreClient client;               ///< Connection to the whac-scored daemon, if it is running.
+    ScoreStore store;                 ///< Binary log and sorted top-N index of every score, without the daemon.
+    ScoreJournal journal;             ///< Write-ahead log in front of the store; closed before the store.
+    Leaderboard board;                ///< The entries shown to players.
 };
 
 #endif // HIGHSCORE_H
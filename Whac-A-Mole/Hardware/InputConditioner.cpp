@@ -0,0 +1,140 @@
+#include "InputConditioner.h"
+
+namespace {
+
+/**
+ * @brief A time long before any event, so every window is open at first.
+ */
+constexpr InputConditioner::Clock::time_point kNever = InputConditioner::Clock::time_point::min();
+
+} // namespace
+
+/**
+ * @class InputConditioner
+ * @brief Drops bounce, auto-repeat and mashing from the key presses of a round.
+ * @author Anubhav Aery
+ */
+InputConditioner::InputConditioner()
+        : cells(), chord(0), chordStart(kNever), chordLimit(1), counts(), chords(0) {
+    reset(1);
+}
+
+/**
+ * @brief Forgets every press.
+ *
+ * @param limit Most cells a chord may hit.
+ */
+void InputConditioner::reset(int limit) {
+    for (CellState& cell : cells) {
+        cell = CellState{kNever, kNever, true};
+    }
+    chord = 0;
+    chordStart = kNever;
+    chordLimit = limit;
+    for (std::uint64_t& entry : counts) {
+        entry = 0;
+    }
+    chords = 0;
+}
+
+/**
+ * @brief Classifies a press.
+ *
+ * The checks run from the cheapest and most certain to the least: bounce, repeat, then
+ * the chord limit. Windows are compared as at < start + window, which cannot overflow
+ * for kNever.
+ *
+ * @param cell The cell pressed.
+ * @param at Time of the press.
+ * @return The verdict.
+ */
+InputConditioner::Verdict InputConditioner::press(int cell, Clock::time_point at) {
+    CellState& state = cells[cell];
+    if (at < state.lastEdgeAt + kDebounce) {
+        return count(Verdict::Bounce);
+    }
+    bool repeat = !state.released && at < state.lastPressAt + kRepeatGap;
+    state.lastPressAt = at;
+    if (repeat) {
+        return count(Verdict::Repeat);
+    }
+
+    std::uint16_t bit = static_cast<std::uint16_t>(1u << cell);
+    if (at < chordStart + kChordWindow && !(chord & bit)) {
+        if (__builtin_popcount(chord) >= chordLimit) {
+            return count(Verdict::ChordLimit);
+        }
+        chord |= bit;
+        if (__builtin_popcount(chord) == 2) {
+            ++chords;
+        }
+    } else {
+        chord = bit;
+        chordStart = at;
+    }
+    state.lastEdgeAt = at;
+    state.released = false;
+    return count(Verdict::Accepted);
+}
+
+/**
+ * @brief Records a release.
+ *
+ * A release within kDebounce of the last edge is bounce and ignored.
+ *
+ * @param cell The cell released.
+ * @param at Time of the release.
+ */
+void InputConditioner::release(int cell, Clock::time_point at) {
+    CellState& state = cells[cell];
+    if (at < state.lastEdgeAt + kDebounce) {
+        return;
+    }
+    state.lastEdgeAt = at;
+    state.released = true;
+}
+
+/**
+ * @brief Retrieves the cells of the chord of the last accepted press.
+ *
+ * @return The chord's cell mask.
+ */
+std::uint16_t InputConditioner::getChord() const {
+    return chord;
+}
+
+/**
+ * @brief Retrieves the time of the first press of the chord.
+ *
+ * @return The start of the chord.
+ */
+InputConditioner::Clock::time_point InputConditioner::getChordStart() const {
+    return chordStart;
+}
+
+/**
+ * @brief Retrieves how many presses got a verdict.
+ *
+ * @param verdict The verdict.
+ * @return The number of presses.
+ */
+std::uint64_t InputConditioner::getCount(Verdict verdict) const {
+    return counts[static_cast<int>(verdict)];
+}
+
+/**
+ * @brief Retrieves the number of chords of two or more cells.
+ *
+ * @return The number of chords.
+ */
+std::uint64_t InputConditioner::getChords() const {
+    return chords;
+}
+
+/**
+ * @brief Counts a verdict and returns it.
+ */
+InputConditioner::Verdict InputConditioner::count(Verdict verdict) {
+    ++counts[static_cast<int>(verdict)];
+    return verdict;
+}
@@ -0,0 +1,130 @@
+#ifndef INPUTCONDITIONER_H
+#define INPUTCONDITIONER_H
+
+#include "LedLayout.h"
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @class InputConditioner
+ * @brief Filters the raw key presses of a round before they are scored.
+ *
+ * Every source of presses delivers some that the player did not mean:
+ *
+ *   - Bounce: a button's contacts chatter for a few milliseconds, and each closure reads
+ *     as a press. Edges on a cell within kDebounce of its last accepted edge are dropped.
+ *   - Auto-repeat: a key held down on a terminal repeats about 30 times a second, and a
+ *     terminal reports no releases. A press on a cell within kRepeatGap of its previous
+ *     press, with no release in between, is taken as a repeat and dropped; the gap is
+ *     measured from the previous press, accepted or not, so a whole repeat run is dropped.
+ *     Sources that report releases only drop presses while the key is held.
+ *   - Mashing: presses on different cells within kChordWindow of the first form a chord.
+ *     A chord may hit as many cells as the mode has moles at once; further presses in it
+ *     are dropped, so slapping the whole board scores no more than aiming.
+ *
+ * The state is a fixed array indexed by cell, so a press costs a few comparisons and no
+ * allocation. The conditioner never reads the clock; every call passes the time of the
+ * event, which makes it easy to drive from recorded or synthetic input.
+ * @author Anubhav Aery
+ */
+class InputConditioner {
+public:
+    using Clock = std::chrono::steady_clock; ///< Clock of every time point passed in.
+
+    /**
+     * @brief What press() decided.
+     */
+    enum class Verdict : std::uint8_t {
+        Accepted,   ///< A real press; score it.
+        Bounce,     ///< Within kDebounce of the cell's last edge.
+        Repeat,     ///< Auto-repeat of a key held down.
+        ChordLimit, ///< One press more in a chord than the mode has moles.
+        Count       ///< Number of verdicts.
+    };
+
+    static constexpr std::chrono::milliseconds kDebounce{10};    ///< Shortest time between two edges of a cell.
+    static constexpr std::chrono::milliseconds kRepeatGap{100};  ///< Presses closer than this without a release are a repeat.
+    static constexpr std::chrono::milliseconds kChordWindow{30}; ///< Presses within this of the first form a chord.
+
+    /**
+     * @brief Constructor for InputConditioner. No cell has been pressed; chords may have one cell.
+     */
+    InputConditioner();
+
+    /**
+     * @brief Forgets every press, for example at the start of a round.
+     *
+     * @param chordLimit Most cells a chord may hit, usually the mode's concurrent moles.
+     */
+    void reset(int chordLimit);
+
+    /**
+     * @brief Classifies a press.
+     *
+     * @param cell The cell pressed, 0-15.
+     * @param at Time of the press; calls must come in time order.
+     * @return Accepted if the press should be scored.
+     */
+    Verdict press(int cell, Clock::time_point at);
+
+    /**
+     * @brief Records a release, from sources that report them.
+     *
+     * @param cell The cell released, 0-15.
+     * @param at Time of the release.
+     */
+    void release(int cell, Clock::time_point at);
+
+    /**
+     * @brief Retrieves the cells of the chord of the last accepted press.
+     *
+     * @return Bit n set means cell n is in the chord.
+     */
+    std::uint16_t getChord() const;
+
+    /**
+     * @brief Retrieves the time of the first press of that chord.
+     *
+     * @return The start of the chord.
+     */
+    Clock::time_point getChordStart() const;
+
+    /**
+     * @brief Retrieves how many presses got a verdict since the last reset().
+     *
+     * @param verdict The verdict.
+     * @return The number of presses.
+     */
+    std::uint64_t getCount(Verdict verdict) const;
+
+    /**
+     * @brief Retrieves the number of chords of two or more cells since the last reset().
+     *
+     * @return The number of chords.
+     */
+    std::uint64_t getChords() const;
+
+private:
+    /**
+     * @brief What the conditioner remembers about a cell.
+     */
+    struct CellState {
+        Clock::time_point lastEdgeAt;  ///< Last accepted press or release.
+        Clock::time_point lastPressAt; ///< Last press, accepted or not.
+        bool released;                 ///< True if a release came after the last press.
+    };
+
+    /**
+     * @brief Counts a verdict and returns it.
+     */
+    Verdict count(Verdict verdict);
+
+    CellState cells[LedLayout::kCellCount];                     ///< State of every cell.
+    std::uint16_t chord;                                        ///< Cells of the current chord.
+    Clock::time_point chordStart;                               ///< First press of the current chord.
+    int chordLimit;                                             ///< Most cells a chord may hit.
+    std::uint64_t counts[static_cast<int>(Verdict::Count)];     ///< Presses per verdict.
+    std::uint64_t chords;                                       ///< Chords of two or more cells.
+};
+
+#endif // INPUTCONDITIONER_H
@@ -0,0 +1,330 @@
+#include "InputEngine.h"
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Translates an evdev key code to the character the game expects.
+ *
+ * @param code The evdev key code.
+ * @return The matching character, or -1 if the key has no meaning in the game.
+ */
+int evdevCodeToChar(unsigned code) {
+    static const struct { unsigned code; char key; } table[] = {
+            {KEY_1, '1'}, {KEY_2, '2'}, {KEY_3, '3'}, {KEY_4, '4'}, {KEY_5, '5'},
+            {KEY_6, '6'}, {KEY_7, '7'}, {KEY_8, '8'}, {KEY_9, '9'}, {KEY_0, '0'},
+            {KEY_Q, 'q'}, {KEY_W, 'w'}, {KEY_E, 'e'}, {KEY_R, 'r'}, {KEY_T, 't'},
+            {KEY_Y, 'y'}, {KEY_U, 'u'}, {KEY_I, 'i'}, {KEY_O, 'o'}, {KEY_P, 'p'},
+            {KEY_A, 'a'}, {KEY_S, 's'}, {KEY_D, 'd'}, {KEY_F, 'f'}, {KEY_G, 'g'},
+            {KEY_H, 'h'}, {KEY_J, 'j'}, {KEY_K, 'k'}, {KEY_L, 'l'}, {KEY_Z, 'z'},
+            {KEY_X, 'x'}, {KEY_C, 'c'}, {KEY_V, 'v'}, {KEY_B, 'b'}, {KEY_N, 'n'},
+            {KEY_M, 'm'}
+    };
+    for (const auto& entry : table) {
+        if (entry.code == code) {
+            return entry.key;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Converts a steady_clock time point to a timespec on CLOCK_MONOTONIC.
+ */
+timespec toTimespec(std::chrono::steady_clock::time_point point) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(point.time_since_epoch()).count();
+    if (ns < 0) {
+        ns = 0;
+    }
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);
+    return ts;
+}
+
+} // namespace
+
+/**
+ * @class InputEngine
+ * @brief Waits on keyboard, evdev and timer file descriptors with epoll.
+ *
+ * The deadline timer is a timerfd on CLOCK_MONOTONIC, the same clock that backs
+ * std::chrono::steady_clock on Linux, so deadlines are honoured to the nanosecond
+ * instead of being rounded to the millisecond timeout of epoll_wait.
+ * Button edges come from the GPIO backend's thread through an SpscQueue, with an eventfd
+ * to wake epoll_wait.
+ * @author Anubhav Aery
+ */
+InputEngine::InputEngine()
+        : epollFd(-1), deadlineFd(-1), pending(), pendingHead(0), pendingCount(0),
+          buttonBackend(nullptr), buttonFd(-1), pinToKey(), buttonEvents() {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    deadlineFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epollFd < 0 || deadlineFd < 0) {
+        for (int fd : {epollFd, deadlineFd}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        throw std::runtime_error("Failed to create the input engine.");
+    }
+    watch(deadlineFd, SourceKind::Deadline, true);
+}
+
+/**
+ * @brief Destructor for InputEngine.
+ *
+ * Stops watching the buttons, then closes every descriptor the engine owns. Terminal
+ * descriptors are left open.
+ */
+InputEngine::~InputEngine() {
+    if (buttonBackend) {
+        buttonBackend->watchEdges(0, nullptr, nullptr);
+    }
+    for (const auto& source : sources) {
+        if (source.owned) {
+            close(source.fd);
+        }
+    }
+    close(epollFd);
+}
+
+/**
+ * @brief Registers a terminal file descriptor as a key source.
+ *
+ * @param fd The terminal file descriptor.
+ */
+void InputEngine::addTerminal(int fd) {
+    watch(fd, SourceKind::Terminal, false);
+}
+
+/**
+ * @brief Opens an evdev device and registers it as a key source.
+ *
+ * @param path Path to the evdev device.
+ * @return True on success, false if the device could not be opened.
+ */
+bool InputEngine::addEvdevDevice(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    watch(fd, SourceKind::Evdev, true);
+    return true;
+}
+
+/**
+ * @brief Watches buttons on GPIO pins and registers them as a key source.
+ *
+ * Replaces the buttons watched before. The eventfd is created on the first call.
+ *
+ * @param backend The initialised GPIO backend.
+ * @param buttonPins GPIO pin of the button of each cell, or -1.
+ * @return True if the backend watches the pins.
+ */
+bool InputEngine::addGpioButtons(GpioBackend& backend, const std::array<int, LedLayout::kCellCount>& buttonPins) {
+    if (!backend.supportsEdges()) {
+        return false;
+    }
+    if (buttonBackend) {
+        buttonBackend->watchEdges(0, nullptr, nullptr);
+        buttonBackend = nullptr;
+    }
+    std::uint32_t pins = 0;
+    pinToKey.fill(0);
+    for (int cell = 0; cell < LedLayout::kCellCount; ++cell) {
+        int pin = buttonPins[cell];
+        if (static_cast<unsigned>(pin) < LedLayout::kPinCount) {
+            pins |= 1u << pin;
+            pinToKey[pin] = kLedLayout.cellToKey[cell];
+        }
+    }
+    if (pins == 0) {
+        return false;
+    }
+    if (buttonFd < 0) {
+        buttonFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (buttonFd < 0) {
+            return false;
+        }
+        watch(buttonFd, SourceKind::Buttons, true);
+    }
+    buttonBackend = &backend;
+    return backend.watchEdges(pins, &InputEngine::onEdge, this);
+}
+
+/**
+ * @brief Blocks until the next event is available.
+ *
+ * Events already read from a descriptor are returned first. Otherwise the deadline timer
+ * is armed and the engine sleeps in epoll_wait until one of its descriptors is readable.
+ *
+ * @param deadline Absolute time at which a Timeout event is returned.
+ * @return The next event.
+ */
+InputEvent InputEngine::waitForEvent(std::chrono::steady_clock::time_point deadline) {
+    armDeadline(deadline);
+    epoll_event ready[8];
+    for (;;) {
+        while (pendingCount == 0) {
+            int count = epoll_wait(epollFd, ready, 8, -1);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("epoll_wait failed.");
+            }
+            auto now = std::chrono::steady_clock::now();
+            for (int i = 0; i < count; ++i) {
+                readSource(sources[ready[i].data.u32], now);
+            }
+        }
+        InputEvent event = pending[pendingHead];
+        pendingHead = (pendingHead + 1) % kPendingCapacity;
+        --pendingCount;
+        // A timeout queued for an earlier, shorter deadline is stale
+        if (event.type == InputEvent::Type::Timeout && event.timestamp < deadline) {
+            continue;
+        }
+        return event;
+    }
+}
+
+/**
+ * @brief Adds a descriptor to the epoll set.
+ */
+void InputEngine::watch(int fd, SourceKind kind, bool owned) {
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u32 = static_cast<std::uint32_t>(sources.size());
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        if (owned) {
+            close(fd);
+        }
+        throw std::runtime_error("Failed to register an input source.");
+    }
+    sources.push_back({fd, kind, owned});
+}
+
+/**
+ * @brief Arms the one-shot deadline timer at an absolute monotonic time.
+ */
+void InputEngine::armDeadline(std::chrono::steady_clock::time_point deadline) {
+    itimerspec spec{};
+    spec.it_value = toTimespec(deadline);
+    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+        spec.it_value.tv_nsec = 1; // A zero value would disarm the timer instead of firing it
+    }
+    timerfd_settime(deadlineFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+/**
+ * @brief Drains a readable descriptor into the pending event ring.
+ */
+void InputEngine::readSource(const Source& source, std::chrono::steady_clock::time_point now) {
+    switch (source.kind) {
+        case SourceKind::Terminal: {
+            unsigned char buffer[kPendingCapacity];
+            ssize_t n = read(source.fd, buffer, kPendingCapacity - pendingCount);
+            if (n == 0 && pendingCount < kPendingCapacity) {
+                // End of file: stop watching so a closed terminal cannot spin the loop
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, source.fd, nullptr);
+            }
+            for (ssize_t i = 0; i < n; ++i) {
+                push({InputEvent::Type::Key, buffer[i], now});
+            }
+            break;
+        }
+        case SourceKind::Evdev: {
+            input_event events[16];
+            ssize_t n = read(source.fd, events, sizeof(events));
+            if (n < 0 && errno == ENODEV) {
+                // The device was unplugged
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, source.fd, nullptr);
+            }
+            for (ssize_t i = 0; n > 0 && i < n / static_cast<ssize_t>(sizeof(input_event)); ++i) {
+                // value 1 is a press and 0 a release; auto-repeats (2) are ignored
+                if (events[i].type == EV_KEY && (events[i].value == 1 || events[i].value == 0)) {
+                    int key = evdevCodeToChar(events[i].code);
+                    if (key >= 0) {
+                        push({events[i].value ? InputEvent::Type::Key : InputEvent::Type::Release, key, now});
+                    }
+                }
+            }
+            break;
+        }
+        case SourceKind::Buttons: {
+            std::uint64_t signals = 0;
+            if (read(source.fd, &signals, sizeof(signals)) != sizeof(signals)) {
+                break;
+            }
+            InputEvent event;
+            while (pendingCount < kPendingCapacity && buttonEvents.tryPop(event)) {
+                push(event);
+            }
+            if (!buttonEvents.empty()) {
+                signalButtons(); // The ring is full; wake up again for the rest once it is drained
+            }
+            break;
+        }
+        case SourceKind::Deadline: {
+            std::uint64_t expirations = 0;
+            if (read(source.fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                push({InputEvent::Type::Timeout, 0, now});
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Appends an event to the pending ring, dropping it if the ring is full.
+ */
+void InputEngine::push(const InputEvent& event) {
+    if (pendingCount == kPendingCapacity) {
+        return;
+    }
+    pending[(pendingHead + pendingCount) % kPendingCapacity] = event;
+    ++pendingCount;
+}
+
+/**
+ * @brief Edge handler of the buttons, called on a thread of the GPIO backend.
+ *
+ * A button pulls its pin low while pressed. The event is dropped if the queue is full, and
+ * so is an edge on a pin outside the button map.
+ */
+void InputEngine::onEdge(const GpioEdge& edge, void* self) {
+    if (static_cast<unsigned>(edge.pin) >= LedLayout::kPinCount) {
+        return;
+    }
+    auto* engine = static_cast<InputEngine*>(self);
+    char key = engine->pinToKey[edge.pin];
+    if (key == 0) {
+        return;
+    }
+    InputEvent event{edge.level ? InputEvent::Type::Release : InputEvent::Type::Key, key, edge.at};
+    if (engine->buttonEvents.tryPush(event)) {
+        engine->signalButtons();
+    }
+}
+
+/**
+ * @brief Wakes the engine for the queued button events.
+ *
+ * The write only fails when the eventfd counter is saturated, and then the engine is
+ * woken anyway.
+ */
+void InputEngine::signalButtons() {
+    std::uint64_t one = 1;
+    ssize_t written = write(buttonFd, &one, sizeof(one));
+    (void)written;
+}
@@ -0,0 +1,149 @@
+#ifndef INPUTENGINE_H
+#define INPUTENGINE_H
+
+#include "GpioBackend.h"
+#include "LedLayout.h"
+#include "SpscQueue.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct InputEvent
+ * @brief A single event delivered by the InputEngine.
+ *
+ * Key and Release events carry the character of the key, and a timeout event means the
+ * requested deadline was reached.
+ */
+struct InputEvent {
+    /**
+     * @brief The kind of event that woke the engine.
+     */
+    enum class Type {
+        Key,     ///< A key was pressed on the terminal, an evdev device or a GPIO button.
+        Release, ///< A key or button was released; terminals report no releases.
+        Timeout  ///< The deadline passed to waitForEvent() expired.
+    };
+
+    Type type; ///< The kind of event.
+    int key;   ///< The key for Key and Release events.
+    std::chrono::steady_clock::time_point timestamp; ///< Time the engine observed the event, or the backend saw a button's edge.
+};
+
+/**
+ * @class InputEngine
+ * @brief Event-driven input source built on epoll and timerfd.
+ *
+ * The InputEngine blocks on the terminal and on any registered evdev devices and wakes
+ * exactly when a key arrives or when the caller's deadline expires. It replaces polling
+ * the keyboard with a fixed sleep between checks. Periodic work, such as the game tick, is
+ * one of the deadlines the caller passes in.
+ *
+ * Buttons on GPIO pins report the key of their cell, so the game handles them like the
+ * keyboard. Their edges arrive on a thread of the GPIO backend, which queues them without
+ * locking and wakes the engine through an eventfd. They keep the time the backend saw the
+ * edge, so a reaction time does not include the wake-up of the game loop.
+ * @author Anubhav Aery
+ */
+class InputEngine {
+public:
+    /**
+     * @brief Constructor for InputEngine.
+     *
+     * Creates the epoll instance together with the deadline timer.
+     * Throws a runtime error if either cannot be created.
+     */
+    InputEngine();
+
+    /**
+     * @brief Destructor for InputEngine.
+     *
+     * Closes the epoll instance, the timer, and every evdev device opened by the engine.
+     */
+    ~InputEngine();
+
+    InputEngine(const InputEngine&) = delete;
+    InputEngine& operator=(const InputEngine&) = delete;
+
+    /**
+     * @brief Registers a terminal file descriptor as a key source.
+     *
+     * Every byte read from the descriptor is reported as one key event. The terminal is
+     * expected to already be in non-canonical mode (ncurses cbreak, or cfmakeraw).
+     *
+     * @param fd The terminal file descriptor, usually STDIN_FILENO.
+     */
+    void addTerminal(int fd);
+
+    /**
+     * @brief Opens a Linux evdev device and registers it as a key source.
+     *
+     * Key presses on the device are translated to the matching character so they can be
+     * handled exactly like terminal input. Releases are reported too.
+     *
+     * @param path Path to the device, for example /dev/input/event0.
+     * @return True if the device was opened and registered, false otherwise.
+     */
+    bool addEvdevDevice(const std::string& path);
+
+    /**
+     * @brief Watches buttons on GPIO pins and registers them as a key source.
+     *
+     * A button pressed reports a Key event with the key of its cell, and a Release when it
+     * is let go. The buttons are watched until the engine is destroyed.
+     *
+     * @param backend The initialised GPIO backend; must outlive the engine.
+     * @param buttonPins GPIO pin of the button of each cell, or -1 for a cell without one.
+     * @return True if the backend watches the pins, false if it cannot or no pin is given.
+     */
+    bool addGpioButtons(GpioBackend& backend, const std::array<int, LedLayout::kCellCount>& buttonPins);
+
+    /**
+     * @brief Blocks until a key arrives or the deadline expires.
+     *
+     * @param deadline Absolute time at which a Timeout event is returned.
+     * @return The next pending event.
+     */
+    InputEvent waitForEvent(std::chrono::steady_clock::time_point deadline);
+
+private:
+    /**
+     * @brief Kind of file descriptor registered with epoll.
+     */
+    enum class SourceKind { Terminal, Evdev, Buttons, Deadline };
+
+    /**
+     * @brief A file descriptor watched by the engine.
+     */
+    struct Source {
+        int fd;          ///< The watched file descriptor.
+        SourceKind kind; ///< What the descriptor delivers.
+        bool owned;      ///< True if the engine must close the descriptor.
+    };
+
+    void watch(int fd, SourceKind kind, bool owned);
+    void armDeadline(std::chrono::steady_clock::time_point deadline);
+    void readSource(const Source& source, std::chrono::steady_clock::time_point now);
+    void push(const InputEvent& event);
+    void signalButtons();
+    static void onEdge(const GpioEdge& edge, void* self);
+
+    static constexpr std::size_t kPendingCapacity = 64; ///< Size of the pending event ring.
+    static constexpr std::size_t kButtonCapacity = 256; ///< Size of the queue of button events.
+
+    int epollFd;   ///< The epoll instance.
+    int deadlineFd; ///< One-shot absolute timerfd for the caller's deadline.
+    std::vector<Source> sources; ///< Every descriptor registered with epoll.
+    std::array<InputEvent, kPendingCapacity> pending; ///< Events read but not yet returned.
+    std::size_t pendingHead; ///< Index of the next event to return.
+    std::size_t pendingCount; ///< Number of events in the pending ring.
+    GpioBackend* buttonBackend; ///< Backend watching the buttons, or nullptr.
+    int buttonFd;  ///< eventfd signalled when a button event is queued, or -1.
+    std::array<char, LedLayout::kPinCount> pinToKey; ///< Key of the button on every pin, or 0.
+    SpscQueue<InputEvent, kButtonCapacity> buttonEvents; ///< Button events from the backend's thread.
+};
+
+#endif // INPUTENGINE_H
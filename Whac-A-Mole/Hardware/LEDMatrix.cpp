@@ -1,6 +1,4 @@
 #include "LEDMatrix.h"
-#include <pigpio.h>
-#include <random>
 
 /**
  * @class LEDMatrix
@@ -10,38 +8,136 @@
  * and controlling these LEDs, including lighting up a random LED.
  * @author Anubhav Aery
  */
-LEDMatrix::LEDMatrix() {
-    // Initialize LED pin numbers
-    keyToLedMap = {
-            {'4', 15}, {'5', 24}, {'6', 8}, {'7', 20},
-            {'r', 14}, {'t', 23}, {'y', 7}, {'u', 21},
-            {'f', 3}, {'g', 17}, {'h', 5}, {'j', 19},
-            {'v', 2}, {'b', 27}, {'n', 6}, {'m', 26}
-    };
+LEDMatrix::LEDMatrix() : animator(frame) {
+    // Build the compatibility map from the layout tables
+    for (int cell = 0; cell < LedLayout::kCellCount; ++cell) {
+        keyToLedMap.emplace(kLedLayout.cellToKey[cell], kLedLayout.cellToPin[cell]);
+    }
+}
+
+/**
+ * @brief Attaches the GPIO backend that drives the LEDs.
+ *
+ * Configures the LED pins as outputs and writes an all-off frame, since the pin levels
+ * left behind by a previous program are unknown. The animator is detached first, so its
+ * curves end on the backend they were playing on.
+ *
+ * @param backend The initialised GPIO backend, or nullptr to detach.
+ */
+void LEDMatrix::setBackend(GpioBackend* backend) {
+    animator.setBackend(nullptr);
+    frame.setBackend(backend);
+    if (backend) {
+        for (int pin : kLedLayout.cellToPin) {
+            backend->setOutput(pin);
+        }
+        frame.clear();
+        frame.forceFlush(); // Initially turn off all LEDs
+        animator.setBackend(backend);
+    }
+}
+
+/**
+ * @brief Stages a cell as on or off.
+ *
+ * @param cell The cell index.
+ * @param on True to light the cell.
+ */
+void LEDMatrix::setCell(int cell, bool on) {
+    frame.set(cell, on);
+}
+
+/**
+ * @brief Writes every staged change to the LEDs.
+ */
+void LEDMatrix::show() {
+    frame.flush();
+}
+
+/**
+ * @brief Provides access to the frame buffer.
+ *
+ * @return A reference to the frame buffer.
+ */
+LedFrameBuffer& LEDMatrix::getFrame() {
+    return frame;
+}
+
+/**
+ * @brief Provides access to the animator.
+ *
+ * @return A reference to the animator.
+ */
+LedAnimator& LEDMatrix::getAnimator() {
+    return animator;
+}
+
+/**
+ * @brief Provides read access to the animator.
+ *
+ * @return A constant reference to the animator.
+ */
+const LedAnimator& LEDMatrix::getAnimator() const {
+    return animator;
 }
 
 /**
  * @brief Lights up a random LED in the matrix.
  *
  * Selects a random LED to light up, ensuring it is different from the currently lit LED.
- * The LED is lit by writing a high signal to the corresponding GPIO pin.
+ * The LED is staged as lit and the frame is flushed, so a staged switch-off of the
+ * previous LED and the new LED reach the pins in one set/clear pair.
  *
- * @param currentLedPin The GPIO pin number of the currently lit LED.
+ * @param currentLedPin The GPIO pin number of the currently lit LED, or -1 if none is lit.
+ * @param random The random engine used to pick the LED.
  * @return The GPIO pin number of the newly lit LED.
  */
-int LEDMatrix::lightUpRandomLED(int currentLedPin) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distrib(0, keyToLedMap.size() - 1);
-    int randomIndex = distrib(gen);
-    for (auto &led : keyToLedMap) {
-        if (randomIndex-- == 0) {
-            currentLedPin = led.second;
-            gpioWrite(currentLedPin, 1); // Turn on the new LED
-            break;
-        }
-    }
-    return currentLedPin;
+int LEDMatrix::lightUpRandomLED(int currentLedPin, Random& random) {
+    int cell = random.nextCell(kLedLayout.cellForPin(currentLedPin), LedLayout::kCellCount);
+    frame.set(cell, true); // Turn on the new LED
+    frame.flush();
+    return kLedLayout.cellToPin[cell];
+}
+
+/**
+ * @brief Looks up the cell hit by a key.
+ *
+ * @param key A key code as returned by the input layer.
+ * @return The cell index, or LedLayout::kNoCell if the key is not mapped.
+ */
+int LEDMatrix::cellForKey(int key) const {
+    return kLedLayout.cellForKey(key);
+}
+
+/**
+ * @brief Looks up the GPIO pin of the LED hit by a key.
+ *
+ * @param key A key code as returned by the input layer.
+ * @return The GPIO pin number, or -1 if the key is not mapped.
+ */
+int LEDMatrix::pinForKey(int key) const {
+    int cell = kLedLayout.cellForKey(key);
+    return cell == LedLayout::kNoCell ? -1 : kLedLayout.cellToPin[cell];
+}
+
+/**
+ * @brief Looks up the GPIO pin driving a cell.
+ *
+ * @param cell The cell index.
+ * @return The GPIO pin number.
+ */
+int LEDMatrix::pinForCell(int cell) const {
+    return kLedLayout.cellToPin[cell];
+}
+
+/**
+ * @brief Looks up the cell driven by a GPIO pin.
+ *
+ * @param pin A GPIO pin number.
+ * @return The cell index, or LedLayout::kNoCell if the pin drives no LED.
+ */
+int LEDMatrix::cellForPin(int pin) const {
+    return kLedLayout.cellForPin(pin);
 }
 
 /**
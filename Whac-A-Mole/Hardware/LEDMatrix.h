@@ -2,7 +2,11 @@
 #define LEDMATRIX_H
 
 #include <unordered_map>
-#include <random>
+#include "GpioBackend.h"
+#include "LedAnimator.h"
+#include "LedFrameBuffer.h"
+#include "LedLayout.h"
+#include "Random.h"
 
 /**
  * @class LEDMatrix
@@ -10,6 +14,10 @@
  *
  * This class is responsible for associating specific keys with LED GPIO pins and
  * controlling the lighting of these LEDs. It includes functionality to light up a random LED.
+ * Lookups go through the flat tables of kLedLayout, so mapping a key, a cell or a pin is
+ * a single array load. LED changes are staged in a LedFrameBuffer and written together
+ * by show(). Single cells can be dimmed and animated through the LedAnimator, which
+ * takes them over from the frame while they play a curve.
  * @author Anubhav Aery
  */
 class LEDMatrix {
@@ -21,28 +29,109 @@ public:
      */
     LEDMatrix();
 
+    /**
+     * @brief Attaches the GPIO backend that drives the LEDs.
+     *
+     * Configures every LED pin as an output and switches all LEDs off. Curves playing on the
+     * previous backend are stopped.
+     *
+     * @param backend The initialised GPIO backend, or nullptr to detach.
+     */
+    void setBackend(GpioBackend* backend);
+
+    /**
+     * @brief Stages a cell as on or off; the change is written by the next show().
+     *
+     * @param cell The cell index (0-15).
+     * @param on True to light the cell.
+     */
+    void setCell(int cell, bool on);
+
+    /**
+     * @brief Writes every staged change to the LEDs in one batch.
+     */
+    void show();
+
+    /**
+     * @brief Provides access to the frame buffer holding the LED state.
+     *
+     * @return A reference to the frame buffer.
+     */
+    LedFrameBuffer& getFrame();
+
+    /**
+     * @brief Provides access to the animator dimming single LEDs.
+     *
+     * @return A reference to the animator.
+     */
+    LedAnimator& getAnimator();
+
+    /**
+     * @brief Provides read access to the animator.
+     *
+     * @return A constant reference to the animator.
+     */
+    const LedAnimator& getAnimator() const;
+
     /**
      * @brief Lights up a random LED in the matrix.
      *
      * Selects a random LED to light up based on the current LED pin, ensuring a different LED is chosen.
-     * It uses a random number generator to select a LED.
+     * It uses the caller's random engine, which is seeded once rather than for every LED.
+     * Any change staged with setCell() is written in the same batch.
      *
-     * @param currentLedPin The GPIO pin number of the currently lit LED.
+     * @param currentLedPin The GPIO pin number of the currently lit LED, or -1 if none is lit.
+     * @param random The random engine used to pick the LED.
      * @return The GPIO pin number of the newly lit LED.
      */
-    int lightUpRandomLED(int currentLedPin);
+    int lightUpRandomLED(int currentLedPin, Random& random);
+
+    /**
+     * @brief Looks up the cell hit by a key.
+     *
+     * @param key A key code as returned by the input layer.
+     * @return The cell index (0-15), or LedLayout::kNoCell if the key is not mapped.
+     */
+    int cellForKey(int key) const;
+
+    /**
+     * @brief Looks up the GPIO pin of the LED hit by a key.
+     *
+     * @param key A key code as returned by the input layer.
+     * @return The GPIO pin number, or -1 if the key is not mapped.
+     */
+    int pinForKey(int key) const;
+
+    /**
+     * @brief Looks up the GPIO pin driving a cell.
+     *
+     * @param cell The cell index (0-15).
+     * @return The GPIO pin number.
+     */
+    int pinForCell(int cell) const;
+
+    /**
+     * @brief Looks up the cell driven by a GPIO pin.
+     *
+     * @param pin A GPIO pin number.
+     * @return The cell index (0-15), or LedLayout::kNoCell if the pin drives no LED.
+     */
+    int cellForPin(int pin) const;
 
     /**
      * @brief Retrieves the mapping of keys to LED GPIO pins.
      *
      * Provides access to the map that links specific keys with their corresponding LED GPIO pins.
+     * Kept for compatibility; new code should use cellForKey() and pinForKey().
      *
      * @return A constant reference to the unordered map of keys to LED GPIO pins.
      */
     const std::unordered_map<char, int>& getKeyToLedMap() const;
 
 private:
-    std::unordered_map<char, int> keyToLedMap; ///< Map linking keys to LED GPIO pins.
+    std::unordered_map<char, int> keyToLedMap; ///< Compatibility view of kLedLayout, built once.
+    LedFrameBuffer frame; ///< Staged and shown state of every LED.
+    LedAnimator animator; ///< Curves playing on single LEDs; holds them in the frame.
 };
 
 #endif // LEDMATRIX_H
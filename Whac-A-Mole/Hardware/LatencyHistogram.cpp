@@ -0,0 +1,169 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+/**
+ * @class LatencyHistogram
+ * @brief Fixed-size, log-bucketed histogram of durations in the style of HdrHistogram.
+ * @author Anubhav Aery
+ */
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+/**
+ * @brief Records one duration.
+ *
+ * @param micros The duration in microseconds.
+ */
+void LatencyHistogram::record(std::uint32_t micros) {
+    ++counts[bucketFor(micros)];
+    minimum = total == 0 ? micros : std::min(minimum, micros);
+    maximum = std::max(maximum, micros);
+    ++total;
+}
+
+/**
+ * @brief Records one duration.
+ *
+ * @param duration The duration; clamped to the range of the histogram.
+ */
+void LatencyHistogram::record(std::chrono::nanoseconds duration) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    micros = std::max<decltype(micros)>(0, std::min<decltype(micros)>(micros, std::numeric_limits<std::uint32_t>::max()));
+    record(static_cast<std::uint32_t>(micros));
+}
+
+/**
+ * @brief Adds every sample of another histogram.
+ *
+ * @param other The histogram to merge.
+ */
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.total == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] += other.counts[i];
+    }
+    minimum = total == 0 ? other.minimum : std::min(minimum, other.minimum);
+    maximum = std::max(maximum, other.maximum);
+    total += other.total;
+}
+
+/**
+ * @brief Removes all samples.
+ */
+void LatencyHistogram::reset() {
+    std::memset(counts, 0, sizeof(counts));
+    total = 0;
+    minimum = 0;
+    maximum = 0;
+}
+
+/**
+ * @brief Retrieves the number of samples.
+ *
+ * @return The sample count.
+ */
+std::uint64_t LatencyHistogram::count() const {
+    return total;
+}
+
+/**
+ * @brief Retrieves the smallest sample.
+ *
+ * @return The minimum in microseconds.
+ */
+std::uint32_t LatencyHistogram::min() const {
+    return minimum;
+}
+
+/**
+ * @brief Retrieves the largest sample.
+ *
+ * @return The maximum in microseconds.
+ */
+std::uint32_t LatencyHistogram::max() const {
+    return maximum;
+}
+
+/**
+ * @brief Retrieves the value below which a given share of the samples fall.
+ *
+ * Walks the buckets until the rank of the percentile is reached and reports the highest
+ * value of that bucket, clamped to the recorded range, as HdrHistogram does.
+ *
+ * @param percentile The percentile, between 0 and 100.
+ * @return The value in microseconds, or 0 if empty.
+ */
+std::uint32_t LatencyHistogram::percentile(double percentile) const {
+    if (total == 0) {
+        return 0;
+    }
+    percentile = std::min(100.0, std::max(0.0, percentile));
+    auto rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5);
+    rank = std::max<std::uint64_t>(1, std::min(rank, total));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::max(minimum, std::min(maximum, highestValueOf(i)));
+        }
+    }
+    return maximum;
+}
+
+/**
+ * @brief Retrieves the p50, p90 and p99 values.
+ *
+ * @return The summary stored with a score.
+ */
+ReactionSummary LatencyHistogram::summary() const {
+    ReactionSummary result;
+    result.p50Us = percentile(50);
+    result.p90Us = percentile(90);
+    result.p99Us = percentile(99);
+    result.samples = static_cast<std::uint32_t>(std::min<std::uint64_t>(total, std::numeric_limits<std::uint32_t>::max()));
+    return result;
+}
+
+/**
+ * @brief Maps a value to its bucket.
+ *
+ * Values below kSubBucketCount map to themselves. Larger values keep the kSubBucketBits bits
+ * below their leading one; the position of the leading one selects the group of buckets.
+ */
+std::size_t LatencyHistogram::bucketFor(std::uint32_t micros) {
+    if (micros < kSubBucketCount) {
+        return micros;
+    }
+    int leading = 31 - __builtin_clz(micros);
+    int shift = leading - kSubBucketBits;
+    std::uint32_t mantissa = (micros >> shift) & (kSubBucketCount - 1);
+    return static_cast<std::size_t>(shift + 1) * kSubBucketCount + mantissa;
+}
+
+/**
+ * @brief Retrieves the smallest value that maps to a bucket.
+ */
+std::uint32_t LatencyHistogram::lowestValueOf(std::size_t bucket) {
+    if (bucket < kSubBucketCount) {
+        return static_cast<std::uint32_t>(bucket);
+    }
+    int shift = static_cast<int>(bucket / kSubBucketCount) - 1;
+    std::uint32_t mantissa = static_cast<std::uint32_t>(bucket % kSubBucketCount);
+    return (kSubBucketCount | mantissa) << shift;
+}
+
+/**
+ * @brief Retrieves the largest value that maps to a bucket.
+ */
+std::uint32_t LatencyHistogram::highestValueOf(std::size_t bucket) {
+    if (bucket < kSubBucketCount) {
+        return static_cast<std::uint32_t>(bucket);
+    }
+    int shift = static_cast<int>(bucket / kSubBucketCount) - 1;
+    return lowestValueOf(bucket) + ((1u << shift) - 1);
+}
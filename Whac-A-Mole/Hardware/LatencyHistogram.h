@@ -0,0 +1,115 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct ReactionSummary
+ * @brief Percentiles of a player's reaction times, as stored with a score.
+ */
+struct ReactionSummary {
+    std::uint32_t p50Us;   ///< Median reaction time in microseconds.
+    std::uint32_t p90Us;   ///< 90th percentile in microseconds.
+    std::uint32_t p99Us;   ///< 99th percentile in microseconds.
+    std::uint32_t samples; ///< Number of reactions measured; zero if unknown.
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Fixed-size, log-bucketed histogram of durations in the style of HdrHistogram.
+ *
+ * Values are recorded in microseconds. Below 32 µs every value has its own bucket; above,
+ * each power of two is split into 32 linear sub-buckets, so any percentile is reported
+ * within about 3% of the true value. The buckets cover 1 µs to over an hour in 3.5 KB,
+ * and recording a sample is a bit scan and an increment: nothing is allocated.
+ * @author Anubhav Aery
+ */
+class LatencyHistogram {
+public:
+    /**
+     * @brief Constructs an empty histogram.
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Records one duration.
+     *
+     * @param micros The duration in microseconds.
+     */
+    void record(std::uint32_t micros);
+
+    /**
+     * @brief Records one duration.
+     *
+     * Negative durations are recorded as zero.
+     *
+     * @param duration The duration.
+     */
+    void record(std::chrono::nanoseconds duration);
+
+    /**
+     * @brief Adds every sample of another histogram.
+     *
+     * @param other The histogram to merge.
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * @brief Removes all samples.
+     */
+    void reset();
+
+    /**
+     * @brief Retrieves the number of samples.
+     *
+     * @return The sample count.
+     */
+    std::uint64_t count() const;
+
+    /**
+     * @brief Retrieves the smallest sample.
+     *
+     * @return The minimum in microseconds, or 0 if empty.
+     */
+    std::uint32_t min() const;
+
+    /**
+     * @brief Retrieves the largest sample.
+     *
+     * @return The maximum in microseconds, or 0 if empty.
+     */
+    std::uint32_t max() const;
+
+    /**
+     * @brief Retrieves the value below which a given share of the samples fall.
+     *
+     * @param percentile The percentile, between 0 and 100.
+     * @return The value in microseconds, or 0 if empty.
+     */
+    std::uint32_t percentile(double percentile) const;
+
+    /**
+     * @brief Retrieves the p50, p90 and p99 values.
+     *
+     * @return The summary stored with a score.
+     */
+    ReactionSummary summary() const;
+
+    static constexpr int kSubBucketBits = 5;                             ///< log2 of the sub-buckets per power of two.
+    static constexpr std::uint32_t kSubBucketCount = 1u << kSubBucketBits; ///< Sub-buckets per power of two.
+    static constexpr std::size_t kBucketCount = (32 - kSubBucketBits + 1) * kSubBucketCount; ///< Total buckets.
+
+private:
+    static std::size_t bucketFor(std::uint32_t micros);
+    static std::uint32_t lowestValueOf(std::size_t bucket);
+    static std::uint32_t highestValueOf(std::size_t bucket);
+
+    std::uint32_t counts[kBucketCount]; ///< Samples per bucket.
+    std::uint64_t total;                ///< Number of samples.
+    std::uint32_t minimum;              ///< Smallest sample.
+    std::uint32_t maximum;              ///< Largest sample.
+};
+
+#endif // LATENCYHISTOGRAM_H
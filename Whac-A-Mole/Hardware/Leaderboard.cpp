@@ -0,0 +1,334 @@
+#include "Leaderboard.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <utility>
+
+/**
+ * @class Leaderboard
+ * @brief Fixed-capacity top-K board of ScoreRecord entries.
+ * @author Eseosa Emmanuel Atekha
+ */
+Leaderboard::Leaderboard(std::size_t capacity, bool bestPerPlayer)
+        : records(std::max<std::size_t>(1, capacity)), heap(records.size()), heapIndex(records.size()),
+          bucketMask(0), count(0), bestPerPlayer(bestPerPlayer), rank(records.size()), rankDirty(false) {
+    if (bestPerPlayer) {
+        // Keep the table at most half full so probe sequences stay short
+        std::size_t bucketCount = 1;
+        while (bucketCount < records.size() * 2) {
+            bucketCount <<= 1;
+        }
+        buckets.assign(bucketCount, kEmpty);
+        bucketMask = bucketCount - 1;
+        nameHashes.resize(records.size());
+    }
+}
+
+/**
+ * @brief Offers a score to the board.
+ *
+ * A new player fills a free slot or replaces the lowest entry. In per-player mode a player
+ * already on the board only has their entry raised, which moves it down the min-heap.
+ *
+ * @param record The score; its sequence breaks ties, lower first.
+ * @return True if the board changed.
+ */
+bool Leaderboard::offer(const ScoreRecord& record) {
+    std::uint32_t hash = 0;
+    if (bestPerPlayer) {
+        hash = hashName(record.name);
+        std::size_t bucket = findBucket(record.name, hash);
+        if (buckets[bucket] != kEmpty) {
+            std::uint32_t slot = buckets[bucket];
+            if (!record.isBetterThan(records[slot])) {
+                return false;
+            }
+            records[slot] = record;
+            siftDown(heapIndex[slot]);
+            rankDirty = true;
+            return true;
+        }
+    }
+
+    std::uint32_t slot;
+    if (count < records.size()) {
+        slot = static_cast<std::uint32_t>(count);
+        heap[count] = slot;
+        heapIndex[slot] = static_cast<std::uint32_t>(count);
+        ++count;
+        records[slot] = record;
+        siftUp(heapIndex[slot]);
+    } else {
+        slot = heap[0];
+        if (!record.isBetterThan(records[slot])) {
+            return false;
+        }
+        if (bestPerPlayer) {
+            eraseName(slot);
+        }
+        records[slot] = record;
+        siftDown(0);
+    }
+    if (bestPerPlayer) {
+        nameHashes[slot] = hash;
+        insertName(slot);
+    }
+    rankDirty = true;
+    return true;
+}
+
+/**
+ * @brief Offers a score to the board.
+ *
+ * @param score The score achieved by the player.
+ * @param playerName The name of the player.
+ * @param sequence Submission order, used to break ties.
+ * @return True if the board changed.
+ */
+bool Leaderboard::offer(int score, const std::string& playerName, std::uint32_t sequence) {
+    return offer(ScoreRecord::make(score, playerName, sequence));
+}
+
+/**
+ * @brief Checks whether a score would currently make the board.
+ *
+ * @param score The score to test.
+ * @return True if the board has room or the score beats the lowest entry.
+ */
+bool Leaderboard::qualifies(int score) const {
+    return count < records.size() || score > records[heap[0]].score;
+}
+
+/**
+ * @brief Removes all entries.
+ */
+void Leaderboard::clear() {
+    count = 0;
+    std::fill(buckets.begin(), buckets.end(), kEmpty);
+    rankDirty = false;
+}
+
+/**
+ * @brief Retrieves the number of entries.
+ *
+ * @return The number of entries.
+ */
+std::size_t Leaderboard::size() const {
+    return count;
+}
+
+/**
+ * @brief Retrieves the maximum number of entries.
+ *
+ * @return The capacity.
+ */
+std::size_t Leaderboard::capacity() const {
+    return records.size();
+}
+
+/**
+ * @brief Checks whether the board has no entries.
+ *
+ * @return True if empty.
+ */
+bool Leaderboard::empty() const {
+    return count == 0;
+}
+
+/**
+ * @brief Checks whether the board keeps one entry per player.
+ *
+ * @return True in per-player mode.
+ */
+bool Leaderboard::isBestPerPlayer() const {
+    return bestPerPlayer;
+}
+
+/**
+ * @brief Retrieves the lowest entry on the board.
+ *
+ * @return The root of the min-heap.
+ */
+const ScoreRecord& Leaderboard::lowest() const {
+    return records[heap[0]];
+}
+
+/**
+ * @brief Finds the entry of a player.
+ *
+ * @param playerName The name of the player.
+ * @return The player's entry, or nullptr if they are not on the board or per-player mode is off.
+ */
+const ScoreRecord* Leaderboard::find(const std::string& playerName) const {
+    if (!bestPerPlayer) {
+        return nullptr;
+    }
+    ScoreRecord key = ScoreRecord::make(0, playerName, 0);
+    std::size_t bucket = findBucket(key.name, hashName(key.name));
+    return buckets[bucket] == kEmpty ? nullptr : &records[buckets[bucket]];
+}
+
+/**
+ * @brief Finds the position of an entry on the board.
+ *
+ * Counts the entries that rank above it, in slot order.
+ *
+ * @param record The entry, as offered.
+ * @return Its position, starting at 1, or 0 if it is not on the board.
+ */
+std::size_t Leaderboard::rankOf(const ScoreRecord& record) const {
+    std::size_t better = 0;
+    bool found = false;
+    for (std::size_t slot = 0; slot < count; ++slot) {
+        const ScoreRecord& entry = records[slot];
+        if (entry.sequence == record.sequence && entry.score == record.score &&
+            std::strncmp(entry.name, record.name, ScoreRecord::kNameLength) == 0) {
+            found = true;
+        } else if (entry.isBetterThan(record)) {
+            ++better;
+        }
+    }
+    return found ? better + 1 : 0;
+}
+
+/**
+ * @brief Retrieves an iterator to the best entry.
+ *
+ * The rank array is only re-sorted when the board changed. It is pre-allocated, so this
+ * never allocates.
+ *
+ * @return Iterator to the first entry.
+ */
+Leaderboard::const_iterator Leaderboard::begin() const {
+    if (rankDirty) {
+        auto last = rank.begin() + static_cast<std::ptrdiff_t>(count);
+        std::iota(rank.begin(), last, 0u);
+        std::sort(rank.begin(), last, [this](std::uint32_t a, std::uint32_t b) {
+            return records[a].isBetterThan(records[b]);
+        });
+        rankDirty = false;
+    }
+    return const_iterator(records.data(), rank.data());
+}
+
+/**
+ * @brief Retrieves the past-the-end iterator.
+ *
+ * @return Iterator past the lowest entry.
+ */
+Leaderboard::const_iterator Leaderboard::end() const {
+    return const_iterator(records.data(), rank.data() + count);
+}
+
+/**
+ * @brief Checks whether slot @p a ranks below slot @p b.
+ */
+bool Leaderboard::isWorse(std::uint32_t a, std::uint32_t b) const {
+    return records[b].isBetterThan(records[a]);
+}
+
+/**
+ * @brief Moves a heap entry towards the root while it ranks below its parent.
+ */
+void Leaderboard::siftUp(std::size_t position) {
+    while (position > 0) {
+        std::size_t parent = (position - 1) / 2;
+        if (!isWorse(heap[position], heap[parent])) {
+            break;
+        }
+        swapHeap(position, parent);
+        position = parent;
+    }
+}
+
+/**
+ * @brief Moves a heap entry away from the root while a child ranks below it.
+ */
+void Leaderboard::siftDown(std::size_t position) {
+    for (;;) {
+        std::size_t lowestPosition = position;
+        std::size_t left = position * 2 + 1;
+        std::size_t right = left + 1;
+        if (left < count && isWorse(heap[left], heap[lowestPosition])) {
+            lowestPosition = left;
+        }
+        if (right < count && isWorse(heap[right], heap[lowestPosition])) {
+            lowestPosition = right;
+        }
+        if (lowestPosition == position) {
+            return;
+        }
+        swapHeap(position, lowestPosition);
+        position = lowestPosition;
+    }
+}
+
+/**
+ * @brief Swaps two heap positions and updates the position of both slots.
+ */
+void Leaderboard::swapHeap(std::size_t a, std::size_t b) {
+    std::swap(heap[a], heap[b]);
+    heapIndex[heap[a]] = static_cast<std::uint32_t>(a);
+    heapIndex[heap[b]] = static_cast<std::uint32_t>(b);
+}
+
+/**
+ * @brief Hashes a fixed-width name with FNV-1a.
+ */
+std::uint32_t Leaderboard::hashName(const char* name) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < ScoreRecord::kNameLength && name[i] != '\0'; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(name[i])) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Linear probe for a name.
+ *
+ * @return The bucket holding the name, or the empty bucket where it would be inserted.
+ */
+std::size_t Leaderboard::findBucket(const char* name, std::uint32_t hash) const {
+    std::size_t bucket = hash & bucketMask;
+    while (buckets[bucket] != kEmpty) {
+        std::uint32_t slot = buckets[bucket];
+        if (nameHashes[slot] == hash && std::strncmp(records[slot].name, name, ScoreRecord::kNameLength) == 0) {
+            return bucket;
+        }
+        bucket = (bucket + 1) & bucketMask;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Adds a slot to the name table.
+ */
+void Leaderboard::insertName(std::uint32_t slot) {
+    buckets[findBucket(records[slot].name, nameHashes[slot])] = slot;
+}
+
+/**
+ * @brief Removes a slot from the name table with backward-shift deletion.
+ *
+ * Following entries of the probe run are moved back into the gap unless that would place
+ * them before their home bucket, so lookups never need tombstones.
+ */
+void Leaderboard::eraseName(std::uint32_t slot) {
+    std::size_t gap = findBucket(records[slot].name, nameHashes[slot]);
+    if (buckets[gap] != slot) {
+        return;
+    }
+    std::size_t bucket = gap;
+    for (;;) {
+        bucket = (bucket + 1) & bucketMask;
+        if (buckets[bucket] == kEmpty) {
+            break;
+        }
+        std::size_t home = nameHashes[buckets[bucket]] & bucketMask;
+        if (((bucket - home) & bucketMask) >= ((bucket - gap) & bucketMask)) {
+            buckets[gap] = buckets[bucket];
+            gap = bucket;
+        }
+    }
+    buckets[gap] = kEmpty;
+}
@@ -0,0 +1,192 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "ScoreStore.h"
+
+/**
+ * @class Leaderboard
+ * @brief Fixed-capacity top-K board of ScoreRecord entries.
+ *
+ * All storage is allocated once by the constructor: K fixed-width records in one array,
+ * a min-heap of slot numbers with the worst entry at the root, and a rank array that is
+ * sorted lazily when the board is iterated. Offering a score costs one comparison when it
+ * does not qualify and O(log K) when it does; iterating allocates nothing.
+ *
+ * With per-player mode enabled, a player holds at most one entry, their best score. The
+ * entries are found through an open-addressing hash table on the name, which uses
+ * backward-shift deletion so evicted players leave no tombstones.
+ * @author Eseosa Emmanuel Atekha
+ */
+class Leaderboard {
+public:
+    /**
+     * @class const_iterator
+     * @brief Walks the entries best first.
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag; ///< Forward iteration only.
+        using value_type = ScoreRecord;                      ///< Type of the entries.
+        using difference_type = std::ptrdiff_t;              ///< Distance between iterators.
+        using pointer = const ScoreRecord*;                  ///< Pointer to an entry.
+        using reference = const ScoreRecord&;                ///< Reference to an entry.
+
+        const_iterator() : records(nullptr), rank(nullptr) {}
+        const_iterator(const ScoreRecord* records, const std::uint32_t* rank) : records(records), rank(rank) {}
+
+        reference operator*() const { return records[*rank]; }
+        pointer operator->() const { return &records[*rank]; }
+        const_iterator& operator++() { ++rank; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++rank; return old; }
+        bool operator==(const const_iterator& other) const { return rank == other.rank; }
+        bool operator!=(const const_iterator& other) const { return rank != other.rank; }
+
+    private:
+        const ScoreRecord* records; ///< The entry storage.
+        const std::uint32_t* rank;  ///< Current position in the sorted rank array.
+    };
+
+    /**
+     * @brief Constructor for Leaderboard.
+     *
+     * @param capacity Number of entries kept (K); at least one.
+     * @param bestPerPlayer If true, keep only the best score of each player.
+     */
+    explicit Leaderboard(std::size_t capacity, bool bestPerPlayer = false);
+
+    /**
+     * @brief Offers a score to the board.
+     *
+     * @param record The score; its sequence breaks ties, lower first.
+     * @return True if the board changed.
+     */
+    bool offer(const ScoreRecord& record);
+
+    /**
+     * @brief Offers a score to the board.
+     *
+     * @param score The score achieved by the player.
+     * @param playerName The name of the player; truncated to 23 bytes.
+     * @param sequence Submission order, used to break ties.
+     * @return True if the board changed.
+     */
+    bool offer(int score, const std::string& playerName, std::uint32_t sequence);
+
+    /**
+     * @brief Checks whether a score would currently make the board.
+     *
+     * In per-player mode a player may still be refused if they already hold a better score.
+     *
+     * @param score The score to test.
+     * @return True if the board has room or the score beats the lowest entry.
+     */
+    bool qualifies(int score) const;
+
+    /**
+     * @brief Removes all entries. Keeps the storage.
+     */
+    void clear();
+
+    /**
+     * @brief Retrieves the number of entries.
+     *
+     * @return At most capacity().
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Retrieves the maximum number of entries.
+     *
+     * @return K.
+     */
+    std::size_t capacity() const;
+
+    /**
+     * @brief Checks whether the board has no entries.
+     *
+     * @return True if empty.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Checks whether the board keeps one entry per player.
+     *
+     * @return True in per-player mode.
+     */
+    bool isBestPerPlayer() const;
+
+    /**
+     * @brief Retrieves the lowest entry on the board.
+     *
+     * @return The entry that the next qualifying score would evict. The board must not be empty.
+     */
+    const ScoreRecord& lowest() const;
+
+    /**
+     * @brief Finds the entry of a player.
+     *
+     * Only available in per-player mode.
+     *
+     * @param playerName The name of the player.
+     * @return The player's entry, or nullptr if they are not on the board.
+     */
+    const ScoreRecord* find(const std::string& playerName) const;
+
+    /**
+     * @brief Finds the position of an entry on the board.
+     *
+     * The entry is matched by sequence, score and name, so an older entry with the same
+     * score and name is not mistaken for it. One pass over the entries; nothing is sorted.
+     *
+     * @param record The entry, as offered.
+     * @return Its position, starting at 1, or 0 if it is not on the board.
+     */
+    std::size_t rankOf(const ScoreRecord& record) const;
+
+    /**
+     * @brief Retrieves an iterator to the best entry.
+     *
+     * Sorts the rank array first if the board changed since the last iteration.
+     *
+     * @return Iterator to the first entry.
+     */
+    const_iterator begin() const;
+
+    /**
+     * @brief Retrieves the past-the-end iterator.
+     *
+     * @return Iterator past the lowest entry.
+     */
+    const_iterator end() const;
+
+private:
+    static constexpr std::uint32_t kEmpty = 0xffffffffu; ///< Unused hash table bucket.
+
+    bool isWorse(std::uint32_t a, std::uint32_t b) const;
+    void siftUp(std::size_t position);
+    void siftDown(std::size_t position);
+    void swapHeap(std::size_t a, std::size_t b);
+
+    static std::uint32_t hashName(const char* name);
+    std::size_t findBucket(const char* name, std::uint32_t hash) const;
+    void insertName(std::uint32_t slot);
+    void eraseName(std::uint32_t slot);
+
+    std::vector<ScoreRecord> records;       ///< Entries, in no particular order.
+    std::vector<std::uint32_t> heap;        ///< Min-heap of slot numbers, lowest entry at the root.
+    std::vector<std::uint32_t> heapIndex;   ///< Position of each slot in the heap.
+    std::vector<std::uint32_t> nameHashes;  ///< Name hash of each slot, per-player mode only.
+    std::vector<std::uint32_t> buckets;     ///< Open-addressing table of slot numbers, per-player mode only.
+    std::size_t bucketMask;                 ///< buckets.size() - 1.
+    std::size_t count;                      ///< Number of entries in use.
+    bool bestPerPlayer;                     ///< True to keep one entry per player.
+    mutable std::vector<std::uint32_t> rank; ///< Slot numbers sorted best first, when not dirty.
+    mutable bool rankDirty;                 ///< True if rank must be re-sorted before iterating.
+};
+
+#endif // LEADERBOARD_H
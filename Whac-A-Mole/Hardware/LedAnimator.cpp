@@ -0,0 +1,197 @@
+#include "LedAnimator.h"
+#include <algorithm>
+#include <array>
+
+namespace {
+
+/**
+ * @brief Duty cycle for every perceived brightness: level squared, scaled back to 0-255.
+ *
+ * Levels above 0 get at least a duty cycle of 1, so a dim curve never goes dark early.
+ */
+constexpr std::array<std::uint8_t, 256> makeDutyTable() {
+    std::array<std::uint8_t, 256> table{};
+    for (int level = 0; level < 256; ++level) {
+        table[level] = static_cast<std::uint8_t>((level * level + 254) / 255);
+    }
+    return table;
+}
+
+constexpr auto kDutyTable = makeDutyTable();
+
+} // namespace
+
+/**
+ * @class LedAnimator
+ * @brief Evaluates the curve of every playing cell once per frame and writes the duty cycles.
+ * @author Anubhav Aery
+ */
+LedAnimator::LedAnimator(LedFrameBuffer& frame)
+        : frame(frame), backend(nullptr), tracks(), active(0), nextAt(Clock::time_point::max()), pwmWrites(0) {}
+
+/**
+ * @brief Attaches the backend that dims the LEDs.
+ *
+ * @param newBackend The initialised GPIO backend, or nullptr to detach.
+ */
+void LedAnimator::setBackend(GpioBackend* newBackend) {
+    stopAll();
+    backend = newBackend;
+    if (backend && backend->supportsPwm()) {
+        for (int pin : kLedLayout.cellToPin) {
+            backend->setPwmFrequency(pin, kPwmFrequencyHz);
+        }
+    }
+}
+
+/**
+ * @brief Starts a curve on a cell.
+ *
+ * Does nothing without a backend. The cell is held in the frame from now on.
+ *
+ * @param cell The cell index.
+ * @param curve The curve.
+ * @param start Time the curve starts.
+ */
+void LedAnimator::play(int cell, const LedCurve& curve, Clock::time_point start) {
+    if (!backend) {
+        return;
+    }
+    std::uint16_t bit = static_cast<std::uint16_t>(1u << cell);
+    if (!(active & bit)) {
+        frame.hold(bit);
+        active |= bit;
+        tracks[cell].duty = -1;
+    }
+    tracks[cell].curve = &curve;
+    tracks[cell].start = start;
+    nextAt = Clock::time_point::min();
+}
+
+/**
+ * @brief Stops the curve of a cell.
+ *
+ * @param cell The cell index.
+ */
+void LedAnimator::stop(int cell) {
+    if (active & (1u << cell)) {
+        release(cell);
+    }
+}
+
+/**
+ * @brief Stops every curve.
+ */
+void LedAnimator::stopAll() {
+    for (std::uint16_t cells = active; cells != 0; cells &= cells - 1) {
+        release(__builtin_ctz(cells));
+    }
+    nextAt = Clock::time_point::max();
+}
+
+/**
+ * @brief Retrieves the cells playing a curve.
+ *
+ * @return The active cell mask.
+ */
+std::uint16_t LedAnimator::getActiveMask() const {
+    return active;
+}
+
+/**
+ * @brief Writes the duty cycles of the current time and ends finished curves.
+ *
+ * A curve that has reached its last keyframe is released rather than held at its last
+ * level. The next update is due one frame from now, or at the end of a curve if that is
+ * sooner, so a curve ends on time even between frames.
+ *
+ * @param now The current time.
+ * @return True if a cell was released.
+ */
+bool LedAnimator::update(Clock::time_point now) {
+    if (active == 0) {
+        return false;
+    }
+    bool released = false;
+    nextAt = now + kFramePeriod;
+    for (std::uint16_t cells = active; cells != 0; cells &= cells - 1) {
+        int cell = __builtin_ctz(cells);
+        Track& track = tracks[cell];
+        std::uint32_t ms = now <= track.start
+                ? 0
+                : static_cast<std::uint32_t>(
+                        std::chrono::duration_cast<std::chrono::milliseconds>(now - track.start).count());
+        if (!track.curve->isLooping()) {
+            Clock::time_point end = track.start + std::chrono::milliseconds(track.curve->lengthMs());
+            if (now >= end) {
+                release(cell);
+                released = true;
+                continue;
+            }
+            nextAt = std::min(nextAt, end);
+        }
+        int duty = toDuty(track.curve->level(ms));
+        if (duty != track.duty) {
+            backend->setPwm(kLedLayout.cellToPin[cell], static_cast<std::uint8_t>(duty));
+            track.duty = duty;
+            ++pwmWrites;
+        }
+    }
+    if (active == 0) {
+        nextAt = Clock::time_point::max();
+    }
+    return released;
+}
+
+/**
+ * @brief Retrieves the time by which update() must run again.
+ *
+ * @return The time of the next update, or Clock::time_point::max() if no cell is playing.
+ */
+LedAnimator::Clock::time_point LedAnimator::nextFrame() const {
+    return nextAt;
+}
+
+/**
+ * @brief Retrieves the duty cycle last written to a cell.
+ *
+ * @param cell The cell index.
+ * @return The duty cycle, or 0.
+ */
+std::uint8_t LedAnimator::getDuty(int cell) const {
+    return (active & (1u << cell)) && tracks[cell].duty > 0 ? static_cast<std::uint8_t>(tracks[cell].duty) : 0;
+}
+
+/**
+ * @brief Retrieves the number of duty cycles written.
+ *
+ * @return The number of setPwm() calls made for curves.
+ */
+std::uint64_t LedAnimator::getPwmWrites() const {
+    return pwmWrites;
+}
+
+/**
+ * @brief Converts a perceived brightness to a duty cycle.
+ *
+ * @param level The brightness.
+ * @return The duty cycle.
+ */
+std::uint8_t LedAnimator::toDuty(std::uint8_t level) {
+    return kDutyTable[level];
+}
+
+/**
+ * @brief Leaves the pin of a cell low and hands the cell back to the frame.
+ *
+ * @param cell The cell index.
+ */
+void LedAnimator::release(int cell) {
+    std::uint16_t bit = static_cast<std::uint16_t>(1u << cell);
+    if (backend) {
+        backend->setPwm(kLedLayout.cellToPin[cell], 0);
+    }
+    tracks[cell].curve = nullptr;
+    active &= static_cast<std::uint16_t>(~bit);
+    frame.release(bit);
+}
@@ -0,0 +1,145 @@
+#ifndef LEDANIMATOR_H
+#define LEDANIMATOR_H
+
+#include "GpioBackend.h"
+#include "LedCurve.h"
+#include "LedFrameBuffer.h"
+#include "LedLayout.h"
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @class LedAnimator
+ * @brief Plays brightness curves on single cells of the LED matrix.
+ *
+ * Each cell has one track: the curve it plays and when the curve started. A cell playing
+ * a curve is held in the LedFrameBuffer, so the frame's on/off writes leave it alone, and
+ * is dimmed with the backend's PWM instead. On pigpio the pulses are timed by the DMA
+ * engine, so the CPU only works once per animation frame, about 60 times a second, and
+ * then only for cells whose duty cycle changed. When a curve ends, or is stopped, the pin is
+ * left low and the cell is released back to the frame, which shows it again on its next
+ * flush().
+ *
+ * Curve levels are perceived brightness; the duty cycle is their square, scaled back to
+ * 0-255, from a table. Without a PWM-capable backend a cell is simply on for the bright
+ * half of its curve.
+ * @author Anubhav Aery
+ */
+class LedAnimator {
+public:
+    using Clock = std::chrono::steady_clock; ///< Clock of every time point passed in.
+
+    static constexpr std::chrono::milliseconds kFramePeriod{16}; ///< Time between two updates, about 60 Hz.
+    static constexpr int kPwmFrequencyHz = 800;                  ///< PWM frequency of the LED pins.
+
+    /**
+     * @brief Constructor for LedAnimator. No cell is playing and no backend is attached.
+     *
+     * @param frame The frame buffer of the same LEDs; must outlive the animator.
+     */
+    explicit LedAnimator(LedFrameBuffer& frame);
+
+    /**
+     * @brief Attaches the backend that dims the LEDs.
+     *
+     * Stops every curve on the previous backend, then sets the PWM frequency of the LED pins.
+     *
+     * @param backend The initialised GPIO backend, or nullptr to detach.
+     */
+    void setBackend(GpioBackend* backend);
+
+    /**
+     * @brief Starts a curve on a cell, replacing the one it plays.
+     *
+     * The first duty cycle is written by the next update().
+     *
+     * @param cell The cell index (0-15).
+     * @param curve The curve; must outlive its playback, as the built-in curves do.
+     * @param start Time the curve starts; may be in the past, to join it part way through.
+     */
+    void play(int cell, const LedCurve& curve, Clock::time_point start);
+
+    /**
+     * @brief Stops the curve of a cell and releases it to the frame.
+     *
+     * @param cell The cell index (0-15).
+     */
+    void stop(int cell);
+
+    /**
+     * @brief Stops every curve.
+     */
+    void stopAll();
+
+    /**
+     * @brief Retrieves the cells playing a curve.
+     *
+     * @return Bit n set means cell n is playing.
+     */
+    std::uint16_t getActiveMask() const;
+
+    /**
+     * @brief Writes the duty cycles of the current time and ends finished curves.
+     *
+     * @param now The current time.
+     * @return True if a cell was released; the frame should be flushed.
+     */
+    bool update(Clock::time_point now);
+
+    /**
+     * @brief Retrieves the time by which update() must run again.
+     *
+     * @return One frame after the last update, or the end of a curve if sooner;
+     *         Clock::time_point::max() if no cell is playing.
+     */
+    Clock::time_point nextFrame() const;
+
+    /**
+     * @brief Retrieves the duty cycle last written to a cell.
+     *
+     * @param cell The cell index (0-15).
+     * @return The duty cycle, or 0 if the cell is not playing.
+     */
+    std::uint8_t getDuty(int cell) const;
+
+    /**
+     * @brief Retrieves the number of duty cycles written.
+     *
+     * @return The number of setPwm() calls made for curves.
+     */
+    std::uint64_t getPwmWrites() const;
+
+    /**
+     * @brief Converts a perceived brightness to a duty cycle.
+     *
+     * @param level The brightness, 0-255.
+     * @return The duty cycle, 0-255.
+     */
+    static std::uint8_t toDuty(std::uint8_t level);
+
+private:
+    /**
+     * @brief What a cell is playing.
+     */
+    struct Track {
+        const LedCurve* curve;   ///< The curve, or nullptr.
+        Clock::time_point start; ///< Time the curve started.
+        int duty;                ///< Duty cycle last written, or -1 before the first.
+    };
+
+    /**
+     * @brief Leaves the pin of a cell low and hands the cell back to the frame.
+     *
+     * @param cell The cell index (0-15).
+     */
+    void release(int cell);
+
+    LedFrameBuffer& frame;                  ///< Frame buffer of the same LEDs.
+    GpioBackend* backend;                   ///< Backend dimming the LEDs, or nullptr.
+    Track tracks[LedLayout::kCellCount];    ///< Track of every cell.
+    std::uint16_t active;                   ///< Cells playing a curve.
+    Clock::time_point nextAt;               ///< Time of the next update.
+    std::uint64_t pwmWrites;                ///< Duty cycles written.
+};
+
+#endif // LEDANIMATOR_H
@@ -0,0 +1,134 @@
+#ifndef LEDCURVE_H
+#define LEDCURVE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct LedKeyframe
+ * @brief A brightness a curve passes through, and when.
+ */
+struct LedKeyframe {
+    std::uint16_t atMs; ///< Time from the start of the curve, in milliseconds.
+    std::uint8_t level; ///< Brightness at that time, 0 (off) to 255 (full).
+};
+
+/**
+ * @class LedCurve
+ * @brief A brightness animation, given as keyframes with straight lines between them.
+ *
+ * The curve is built at compile time. The slope of every segment is worked out then, in
+ * 16.16 fixed point per millisecond, so level() is a short scan, one multiplication and a
+ * shift, without floating point or division. A looping curve starts over after its last
+ * keyframe; any other curve holds the last level.
+ * @author Anubhav Aery
+ */
+class LedCurve {
+public:
+    static constexpr std::size_t kMaxKeyframes = 8; ///< Keyframes in one curve.
+
+    /**
+     * @brief Builds a curve from its keyframes.
+     *
+     * @param frames The keyframes, the first at 0 ms, in time order.
+     * @param loops True to start over after the last keyframe.
+     */
+    template <std::size_t N>
+    constexpr LedCurve(const LedKeyframe (&frames)[N], bool loops)
+            : keys{}, slopes{}, count(N), loops(loops) {
+        static_assert(N >= 1 && N <= kMaxKeyframes, "A curve has 1 to kMaxKeyframes keyframes");
+        for (std::size_t i = 0; i < N; ++i) {
+            keys[i] = frames[i];
+        }
+        for (std::size_t i = 0; i + 1 < N; ++i) {
+            std::int32_t span = keys[i + 1].atMs - keys[i].atMs;
+            std::int32_t rise = keys[i + 1].level - keys[i].level;
+            slopes[i] = span > 0 ? rise * 65536 / span : 0;
+        }
+    }
+
+    /**
+     * @brief Evaluates the curve.
+     *
+     * @param ms Time from the start of the curve, in milliseconds.
+     * @return The brightness at that time, 0-255.
+     */
+    constexpr std::uint8_t level(std::uint32_t ms) const {
+        std::uint32_t length = keys[count - 1].atMs;
+        if (ms >= length) {
+            if (!loops || length == 0) {
+                return keys[count - 1].level;
+            }
+            ms %= length;
+        }
+        std::size_t i = 0;
+        while (keys[i + 1].atMs <= ms) {
+            ++i;
+        }
+        std::int64_t rise = (static_cast<std::int64_t>(slopes[i]) * (ms - keys[i].atMs) + 32768) >> 16;
+        std::int32_t value = keys[i].level + static_cast<std::int32_t>(rise);
+        return static_cast<std::uint8_t>(value < 0 ? 0 : value > 255 ? 255 : value);
+    }
+
+    /**
+     * @brief Retrieves the time of the last keyframe.
+     *
+     * @return The length of the curve, or of one loop, in milliseconds.
+     */
+    constexpr std::uint32_t lengthMs() const {
+        return keys[count - 1].atMs;
+    }
+
+    /**
+     * @brief Checks whether the curve starts over after its last keyframe.
+     *
+     * @return True for a looping curve.
+     */
+    constexpr bool isLooping() const {
+        return loops;
+    }
+
+private:
+    LedKeyframe keys[kMaxKeyframes];   ///< The keyframes.
+    std::int32_t slopes[kMaxKeyframes]; ///< Level change per millisecond after each keyframe, 16.16 fixed point.
+    std::size_t count;                 ///< Number of keyframes.
+    bool loops;                        ///< True to start over after the last keyframe.
+};
+
+/**
+ * @brief Keyframes of kEscapeWarning: two flickers, then a fade to off.
+ */
+inline constexpr LedKeyframe kEscapeWarningKeys[] = {
+        {0, 255}, {80, 90}, {140, 255}, {220, 60}, {280, 255}, {400, 0},
+};
+
+/**
+ * @brief Played on a mole in the last 400 ms before it escapes, ending as it goes out.
+ */
+inline constexpr LedCurve kEscapeWarning(kEscapeWarningKeys, false);
+
+/**
+ * @brief Keyframes of kHitPulse: a flash, a second smaller one, off.
+ */
+inline constexpr LedKeyframe kHitPulseKeys[] = {
+        {0, 255}, {50, 0}, {90, 180}, {200, 0},
+};
+
+/**
+ * @brief Played on a cell when its mole is hit.
+ */
+inline constexpr LedCurve kHitPulse(kHitPulseKeys, false);
+
+/**
+ * @brief Keyframes of kAttractSweep: a quick rise, a slow fall, then dark until the next pass.
+ */
+inline constexpr LedKeyframe kAttractSweepKeys[] = {
+        {0, 0}, {120, 255}, {520, 0}, {1200, 0},
+};
+
+/**
+ * @brief Looping glow for the attract mode; each column starts it a little later, so it sweeps across.
+ */
+inline constexpr LedCurve kAttractSweep(kAttractSweepKeys, true);
+
+#endif // LEDCURVE_H
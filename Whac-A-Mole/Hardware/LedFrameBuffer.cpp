@@ -0,0 +1,169 @@
+#include "LedFrameBuffer.h"
+#include "LedLayout.h"
+#include <array>
+
+namespace {
+
+/**
+ * @brief Pin masks for every value of one byte of the cell mask.
+ *
+ * Entry [0][b] covers cells 0-7 and entry [1][b] cells 8-15, so a 16-bit frame is
+ * translated with two loads and an OR.
+ */
+constexpr std::array<std::array<std::uint32_t, 256>, 2> makePinMaskTable() {
+    std::array<std::array<std::uint32_t, 256>, 2> table{};
+    for (int half = 0; half < 2; ++half) {
+        for (int byte = 0; byte < 256; ++byte) {
+            std::uint32_t mask = 0;
+            for (int bit = 0; bit < 8; ++bit) {
+                if (byte & (1 << bit)) {
+                    mask |= 1u << kLedLayout.cellToPin[half * 8 + bit];
+                }
+            }
+            table[half][byte] = mask;
+        }
+    }
+    return table;
+}
+
+constexpr auto kPinMaskTable = makePinMaskTable();
+
+} // namespace
+
+/**
+ * @class LedFrameBuffer
+ * @brief Diffs LED frames and flushes them as GPIO bank writes.
+ * @author Anubhav Aery
+ */
+LedFrameBuffer::LedFrameBuffer() : backend(nullptr), staged(0), shown(0), held(0) {}
+
+/**
+ * @brief Attaches the backend that flush() writes to.
+ *
+ * @param newBackend The GPIO backend, or nullptr to detach.
+ */
+void LedFrameBuffer::setBackend(GpioBackend* newBackend) {
+    backend = newBackend;
+}
+
+/**
+ * @brief Stages a cell as on or off.
+ *
+ * @param cell The cell index.
+ * @param on True to light the cell.
+ */
+void LedFrameBuffer::set(int cell, bool on) {
+    std::uint16_t bit = static_cast<std::uint16_t>(1u << cell);
+    staged = on ? (staged | bit) : (staged & ~bit);
+}
+
+/**
+ * @brief Stages a whole frame.
+ *
+ * @param cells Bit n set lights cell n.
+ */
+void LedFrameBuffer::setMask(std::uint16_t cells) {
+    staged = cells;
+}
+
+/**
+ * @brief Stages every cell as off.
+ */
+void LedFrameBuffer::clear() {
+    staged = 0;
+}
+
+/**
+ * @brief Retrieves the staged frame.
+ *
+ * @return The staged cell mask.
+ */
+std::uint16_t LedFrameBuffer::getMask() const {
+    return staged;
+}
+
+/**
+ * @brief Retrieves the frame currently shown.
+ *
+ * @return The shown cell mask.
+ */
+std::uint16_t LedFrameBuffer::getShownMask() const {
+    return shown;
+}
+
+/**
+ * @brief Writes the staged changes to the LEDs.
+ *
+ * Only cells that differ from the shown frame and are not held are written.
+ *
+ * @return True if any LED changed.
+ */
+bool LedFrameBuffer::flush() {
+    std::uint16_t changed = (staged ^ shown) & ~held;
+    if (changed == 0) {
+        return false;
+    }
+    if (backend) {
+        backend->writeBank(toPinMask(changed & staged), toPinMask(changed & shown));
+    }
+    shown ^= changed;
+    return true;
+}
+
+/**
+ * @brief Writes the whole staged frame regardless of what is believed to be shown.
+ */
+void LedFrameBuffer::forceFlush() {
+    std::uint16_t unheld = static_cast<std::uint16_t>(~held);
+    if (backend) {
+        backend->writeBank(toPinMask(staged & unheld), toPinMask(static_cast<std::uint16_t>(~staged & unheld)));
+    }
+    shown = (staged & unheld) | (shown & held);
+}
+
+/**
+ * @brief Records a frame that reached the LEDs without flush().
+ *
+ * @param cells The frame now on the LEDs.
+ */
+void LedFrameBuffer::assumeShown(std::uint16_t cells) {
+    shown = (cells & ~held) | (shown & held);
+}
+
+/**
+ * @brief Hands cells to another writer.
+ *
+ * @param cells The cells to hold.
+ */
+void LedFrameBuffer::hold(std::uint16_t cells) {
+    held |= cells;
+}
+
+/**
+ * @brief Takes held cells back; they are off.
+ *
+ * @param cells The cells to release.
+ */
+void LedFrameBuffer::release(std::uint16_t cells) {
+    held &= ~cells;
+    shown &= ~cells;
+}
+
+/**
+ * @brief Retrieves the held cells.
+ *
+ * @return The held cell mask.
+ */
+std::uint16_t LedFrameBuffer::getHeldMask() const {
+    return held;
+}
+
+/**
+ * @brief Translates a cell mask to the matching GPIO bank mask.
+ *
+ * @param cells The cell mask.
+ * @return The GPIO pin mask.
+ */
+std::uint32_t LedFrameBuffer::toPinMask(std::uint16_t cells) {
+    return kPinMaskTable[0][cells & 0xFF] | kPinMaskTable[1][cells >> 8];
+}
@@ -0,0 +1,132 @@
+#ifndef LEDFRAMEBUFFER_H
+#define LEDFRAMEBUFFER_H
+
+#include <cstdint>
+#include "GpioBackend.h"
+
+/**
+ * @class LedFrameBuffer
+ * @brief Stages the state of all 16 LEDs and writes the changes in one batch.
+ *
+ * The frame is a 16-bit mask with one bit per cell. Changes are only staged until
+ * flush(), which diffs the frame against the one last shown, translates the difference
+ * to GPIO bank masks and hands it to the backend as a single set/clear pair. However many
+ * moles change in a tick, they change together and cost at most two register writes.
+ *
+ * Cells can be held by another writer, such as the LedAnimator dimming them. flush() leaves
+ * held cells alone until they are released; their staged state is written then.
+ * @author Anubhav Aery
+ */
+class LedFrameBuffer {
+public:
+    /**
+     * @brief Constructor for LedFrameBuffer.
+     *
+     * Starts with every cell off and no backend attached.
+     */
+    LedFrameBuffer();
+
+    /**
+     * @brief Attaches the backend that flush() writes to.
+     *
+     * @param backend The GPIO backend, or nullptr to detach.
+     */
+    void setBackend(GpioBackend* backend);
+
+    /**
+     * @brief Stages a cell as on or off.
+     *
+     * @param cell The cell index (0-15).
+     * @param on True to light the cell.
+     */
+    void set(int cell, bool on);
+
+    /**
+     * @brief Stages a whole frame.
+     *
+     * @param cells Bit n set lights cell n.
+     */
+    void setMask(std::uint16_t cells);
+
+    /**
+     * @brief Stages every cell as off.
+     */
+    void clear();
+
+    /**
+     * @brief Retrieves the staged frame.
+     *
+     * @return Bit n set means cell n will be lit after the next flush().
+     */
+    std::uint16_t getMask() const;
+
+    /**
+     * @brief Retrieves the frame currently shown on the LEDs.
+     *
+     * @return Bit n set means cell n is lit.
+     */
+    std::uint16_t getShownMask() const;
+
+    /**
+     * @brief Writes the staged changes to the LEDs.
+     *
+     * @return True if any LED changed, false if the frame was already shown.
+     */
+    bool flush();
+
+    /**
+     * @brief Writes the whole staged frame, including cells believed to be unchanged.
+     *
+     * Used after initialisation, when the real pin levels are unknown.
+     */
+    void forceFlush();
+
+    /**
+     * @brief Records a frame that reached the LEDs without flush(), such as one played by a waveform.
+     *
+     * The staged frame is not changed; the next flush() writes only what differs from @p cells.
+     * Held cells keep their state.
+     *
+     * @param cells Bit n set means cell n is lit.
+     */
+    void assumeShown(std::uint16_t cells);
+
+    /**
+     * @brief Hands cells to another writer; flush() stops writing them.
+     *
+     * @param cells Bit n set holds cell n.
+     */
+    void hold(std::uint16_t cells);
+
+    /**
+     * @brief Takes held cells back, left off by the other writer.
+     *
+     * The next flush() lights those of them that are staged as lit.
+     *
+     * @param cells Bit n set releases cell n.
+     */
+    void release(std::uint16_t cells);
+
+    /**
+     * @brief Retrieves the held cells.
+     *
+     * @return Bit n set means cell n is held.
+     */
+    std::uint16_t getHeldMask() const;
+
+    /**
+     * @brief Translates a cell mask to the matching GPIO bank mask.
+     *
+     * @param cells Bit n set selects cell n.
+     * @return Bit n set selects GPIO n.
+     */
+    static std::uint32_t toPinMask(std::uint16_t cells);
+
+private:
+    GpioBackend* backend; ///< Backend the frames are written to.
+    std::uint16_t staged; ///< Frame to show on the next flush.
+    std::uint16_t shown;  ///< Frame currently on the LEDs, except for held cells.
+    std::uint16_t held;   ///< Cells driven by another writer.
+};
+
+#endif // LEDFRAMEBUFFER_H
@@ -0,0 +1,77 @@
+#ifndef LEDLAYOUT_H
+#define LEDLAYOUT_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @struct LedLayout
+ * @brief Compile-time description of the 4x4 LED matrix wiring.
+ *
+ * Cells are numbered 0-15 row by row, matching the keyboard layout
+ * 4 5 6 7 / r t y u / f g h j / v b n m. The layout holds flat lookup tables so that
+ * key to cell, cell to GPIO pin and GPIO pin to cell are each a single array load.
+ * @author Anubhav Aery
+ */
+struct LedLayout {
+    static constexpr int kCellCount = 16; ///< Number of LEDs in the matrix.
+    static constexpr int kPinCount = 32;  ///< GPIO pins 0-31, the pins of the first bank.
+    static constexpr int kNoCell = -1;    ///< Table entry for keys and pins without a cell.
+
+    std::array<char, kCellCount> cellToKey;         ///< Key that hits each cell.
+    std::array<int, kCellCount> cellToPin;          ///< GPIO pin that drives each cell.
+    std::array<std::int8_t, 256> keyToCell;         ///< Cell for every byte value, or kNoCell.
+    std::array<std::int8_t, kPinCount> pinToCell;   ///< Cell for every GPIO pin, or kNoCell.
+
+    /**
+     * @brief Looks up the cell hit by a key.
+     *
+     * @param key A key code as returned by the input layer.
+     * @return The cell index, or kNoCell if the key is not part of the matrix.
+     */
+    constexpr int cellForKey(int key) const {
+        return static_cast<unsigned>(key) < keyToCell.size() ? keyToCell[key] : kNoCell;
+    }
+
+    /**
+     * @brief Looks up the cell driven by a GPIO pin.
+     *
+     * @param pin A GPIO pin number.
+     * @return The cell index, or kNoCell if the pin drives no LED.
+     */
+    constexpr int cellForPin(int pin) const {
+        return static_cast<unsigned>(pin) < pinToCell.size() ? pinToCell[pin] : kNoCell;
+    }
+};
+
+/**
+ * @brief Builds the layout tables from the key and pin assignment of each cell.
+ *
+ * @return The fully populated layout.
+ */
+constexpr LedLayout makeLedLayout() {
+    LedLayout layout{
+            {'4', '5', '6', '7', 'r', 't', 'y', 'u', 'f', 'g', 'h', 'j', 'v', 'b', 'n', 'm'},
+            {15, 24, 8, 20, 14, 23, 7, 21, 3, 17, 5, 19, 2, 27, 6, 26},
+            {},
+            {}
+    };
+    for (auto& entry : layout.keyToCell) {
+        entry = LedLayout::kNoCell;
+    }
+    for (auto& entry : layout.pinToCell) {
+        entry = LedLayout::kNoCell;
+    }
+    for (int cell = 0; cell < LedLayout::kCellCount; ++cell) {
+        layout.keyToCell[static_cast<unsigned char>(layout.cellToKey[cell])] = static_cast<std::int8_t>(cell);
+        layout.pinToCell[layout.cellToPin[cell]] = static_cast<std::int8_t>(cell);
+    }
+    return layout;
+}
+
+/**
+ * @brief The wiring used by the cabinet, see README.txt.
+ */
+inline constexpr LedLayout kLedLayout = makeLedLayout();
+
+#endif // LEDLAYOUT_H
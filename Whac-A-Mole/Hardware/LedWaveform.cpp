@@ -0,0 +1,159 @@
+#include "LedWaveform.h"
+#include "LedFrameBuffer.h"
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Whole microseconds from one time point to a later one, rounded to nearest.
+ */
+std::int64_t roundedMicros(LedWaveform::Clock::time_point from, LedWaveform::Clock::time_point to) {
+    return (std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count() + 500) / 1000;
+}
+
+/**
+ * @brief A pulse that shows a whole frame: the lit cells' pins set, every other LED pin cleared.
+ *
+ * The pins of held cells are neither set nor cleared.
+ */
+GpioPulse framePulse(std::uint16_t cells, std::uint16_t held, std::int64_t delayUs) {
+    std::uint16_t unheld = static_cast<std::uint16_t>(~held);
+    return GpioPulse{LedFrameBuffer::toPinMask(cells & unheld),
+                     LedFrameBuffer::toPinMask(static_cast<std::uint16_t>(~cells & unheld)),
+                     static_cast<std::uint32_t>(std::max<std::int64_t>(delayUs, 0))};
+}
+
+} // namespace
+
+/**
+ * @class LedWaveform
+ * @brief Compiles upcoming LED frames into waves and tracks which of them have played.
+ * @author Anubhav Aery
+ */
+LedWaveform::LedWaveform()
+        : backend(nullptr), armed(), armedBegin(0), armedEnd(0), armedHeld(0), pulses(), wavesSent(0) {}
+
+/**
+ * @brief Attaches the backend that plays the waves.
+ *
+ * @param backend The initialised GPIO backend, or nullptr to detach.
+ */
+void LedWaveform::setBackend(GpioBackend* backend) {
+    cancel();
+    this->backend = backend;
+}
+
+/**
+ * @brief Checks whether waves can be played.
+ *
+ * @return True if a backend that supports waves is attached.
+ */
+bool LedWaveform::isAvailable() const {
+    return backend && backend->supportsWaves();
+}
+
+/**
+ * @brief Plays a list of upcoming frames.
+ *
+ * If the steps not yet taken and the held cells are the same as before, the wave keeps
+ * playing. Otherwise the frames are compiled from now and the backend replaces its wave.
+ * If the backend fails, nothing is armed and the caller's writes keep the LEDs right, only
+ * later.
+ *
+ * @param shown The frame on the LEDs now.
+ * @param steps The frames, in time order.
+ * @param count Number of steps.
+ * @param held Cells the wave must not write.
+ * @return True if the steps are playing.
+ */
+bool LedWaveform::schedule(std::uint16_t shown, const LedStep* steps, std::size_t count, std::uint16_t held) {
+    if (!isAvailable()) {
+        return false;
+    }
+    count = std::min(count, kMaxSteps);
+    if (count == 0) {
+        cancel();
+        return false;
+    }
+    bool same = armedEnd - armedBegin == count && armedHeld == held &&
+                std::equal(steps, steps + count, armed + armedBegin, [](const LedStep& a, const LedStep& b) {
+                    return a.at == b.at && a.cells == b.cells;
+                });
+    if (same) {
+        return true;
+    }
+
+    std::size_t pulseCount = compile(Clock::now(), shown, steps, count, pulses, held);
+    ++wavesSent;
+    if (!backend->sendWave(pulses, pulseCount)) {
+        armedBegin = armedEnd = 0;
+        return false;
+    }
+    std::copy(steps, steps + count, armed);
+    armedBegin = 0;
+    armedEnd = count;
+    armedHeld = held;
+    return true;
+}
+
+/**
+ * @brief Takes the oldest step whose time has come.
+ *
+ * @param until The current time.
+ * @param step Receives the step.
+ * @return True if a step was taken.
+ */
+bool LedWaveform::popFired(Clock::time_point until, LedStep& step) {
+    if (armedBegin == armedEnd || armed[armedBegin].at > until) {
+        return false;
+    }
+    step = armed[armedBegin++];
+    return true;
+}
+
+/**
+ * @brief Stops the wave; its remaining steps are dropped.
+ */
+void LedWaveform::cancel() {
+    if (backend && armedBegin != armedEnd) {
+        backend->cancelWave();
+    }
+    armedBegin = armedEnd = 0;
+}
+
+/**
+ * @brief Retrieves the number of waves handed to the backend.
+ *
+ * @return The number of waves sent.
+ */
+std::uint64_t LedWaveform::getWavesSent() const {
+    return wavesSent;
+}
+
+/**
+ * @brief Compiles frames into pulses.
+ *
+ * Pulse 0 shows @p shown and lasts until the first step; pulse i shows step i - 1 and lasts
+ * until step i. The last pulse has no delay.
+ *
+ * @param start Time the wave starts.
+ * @param shown The frame on the LEDs at the start.
+ * @param steps The frames, in time order.
+ * @param count Number of steps.
+ * @param pulses Receives count + 1 pulses.
+ * @param held Cells left out of the pulses.
+ * @return The number of pulses written.
+ */
+std::size_t LedWaveform::compile(Clock::time_point start, std::uint16_t shown, const LedStep* steps,
+                                 std::size_t count, GpioPulse* pulses, std::uint16_t held) {
+    std::int64_t previous = 0;
+    std::uint16_t cells = shown;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::int64_t offset = std::max(roundedMicros(start, steps[i].at), previous);
+        pulses[i] = framePulse(cells, held, offset - previous);
+        previous = offset;
+        cells = steps[i].cells;
+    }
+    pulses[count] = framePulse(cells, held, 0);
+    return count + 1;
+}
@@ -0,0 +1,123 @@
+#ifndef LEDWAVEFORM_H
+#define LEDWAVEFORM_H
+
+#include "GpioBackend.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct LedStep
+ * @brief A frame of the LED matrix and the time it must appear.
+ */
+struct LedStep {
+    std::chrono::steady_clock::time_point at; ///< When the frame is shown.
+    std::uint16_t cells;                      ///< Bit n set lights cell n from then on.
+};
+
+/**
+ * @class LedWaveform
+ * @brief Hands the upcoming LED frames to the backend's DMA engine, so they appear on time.
+ *
+ * A frame written by the game loop appears whenever the loop gets to run, which is late by
+ * the scheduler's wake-up latency. The spawns and escapes of the moles are known in advance,
+ * though, so the loop can compile the next few frames into a waveform and let the hardware
+ * change the pins at the exact times while the CPU sleeps.
+ *
+ * Every pulse writes a whole frame: it sets the pins of the lit cells and clears the pins of
+ * every other cell. A wave that is replaced or fires a moment too early is therefore
+ * corrected by the next pulse or write, instead of leaving a stray LED behind. The first
+ * pulse rewrites the frame already shown and waits until the first step. Cells held by the
+ * LedAnimator are left out of every pulse.
+ *
+ * schedule() does nothing if the steps are the ones already playing, so the loop can call
+ * it on every pass. popFired() hands back the steps whose time has come, in order.
+ * @author Anubhav Aery
+ */
+class LedWaveform {
+public:
+    using Clock = std::chrono::steady_clock; ///< Clock of every step.
+
+    static constexpr std::size_t kMaxSteps = 8; ///< Frames in one wave.
+
+    /**
+     * @brief Constructor for LedWaveform. No backend is attached.
+     */
+    LedWaveform();
+
+    /**
+     * @brief Attaches the backend that plays the waves.
+     *
+     * Stops the wave playing on the previous backend.
+     *
+     * @param backend The initialised GPIO backend, or nullptr to detach.
+     */
+    void setBackend(GpioBackend* backend);
+
+    /**
+     * @brief Checks whether waves can be played.
+     *
+     * @return True if a backend that supports waves is attached.
+     */
+    bool isAvailable() const;
+
+    /**
+     * @brief Plays a list of upcoming frames, replacing the wave that is playing.
+     *
+     * @param shown The frame on the LEDs now.
+     * @param steps The frames, in time order, all in the future; at most kMaxSteps are used.
+     * @param count Number of steps; zero stops the wave.
+     * @param held Cells the wave must not write.
+     * @return True if the steps are playing.
+     */
+    bool schedule(std::uint16_t shown, const LedStep* steps, std::size_t count, std::uint16_t held = 0);
+
+    /**
+     * @brief Takes the oldest step whose time has come.
+     *
+     * @param until The current time.
+     * @param step Receives the step.
+     * @return True if a step was taken.
+     */
+    bool popFired(Clock::time_point until, LedStep& step);
+
+    /**
+     * @brief Stops the wave; its remaining steps are dropped.
+     */
+    void cancel();
+
+    /**
+     * @brief Retrieves the number of waves handed to the backend.
+     *
+     * @return The number of waves sent.
+     */
+    std::uint64_t getWavesSent() const;
+
+    /**
+     * @brief Compiles frames into pulses.
+     *
+     * Offsets are rounded to the microsecond from @p start, not from the previous step, so
+     * the rounding does not add up over the wave.
+     *
+     * @param start Time the wave starts.
+     * @param shown The frame on the LEDs at the start.
+     * @param steps The frames, in time order, none before @p start.
+     * @param count Number of steps.
+     * @param pulses Receives count + 1 pulses.
+     * @param held Cells left out of the pulses.
+     * @return The number of pulses written.
+     */
+    static std::size_t compile(Clock::time_point start, std::uint16_t shown, const LedStep* steps,
+                               std::size_t count, GpioPulse* pulses, std::uint16_t held = 0);
+
+private:
+    GpioBackend* backend;           ///< Backend playing the waves, or nullptr.
+    LedStep armed[kMaxSteps];       ///< Steps of the wave playing.
+    std::size_t armedBegin;         ///< First step not yet taken by popFired().
+    std::size_t armedEnd;           ///< One past the last step.
+    std::uint16_t armedHeld;        ///< Cells left out of the wave playing.
+    GpioPulse pulses[kMaxSteps + 1]; ///< Pulses of the last wave.
+    std::uint64_t wavesSent;        ///< Waves handed to the backend.
+};
+
+#endif // LEDWAVEFORM_H
@@ -0,0 +1,218 @@
+#include "MoleEngine.h"
+#include <algorithm>
+
+namespace {
+
+constexpr std::uint16_t kAllCells = static_cast<std::uint16_t>((1u << LedLayout::kCellCount) - 1);
+
+} // namespace
+
+/**
+ * @class MoleEngine
+ * @brief Runs the moles of a round from a GameMode table entry.
+ * @author Anubhav Aery
+ */
+MoleEngine::MoleEngine()
+        : mode(&kGameModes[0]), startedAt(), roundLength(1), advancedTo(), nextSpawnAt(), active(0), recent(0),
+          spawnedAt(), escapesAt(), escapedCells(0), escapedSpawnedAt(), escapedAt(), hits(0), misses(0),
+          escapes(0) {}
+
+/**
+ * @brief Starts a round.
+ *
+ * @param newMode The parameters of the round.
+ * @param now The current time.
+ * @param length Length of the round, over which the speed-up is applied.
+ */
+void MoleEngine::start(const GameMode& newMode, Clock::time_point now, std::chrono::nanoseconds length) {
+    mode = &newMode;
+    startedAt = now;
+    roundLength = std::max(length, std::chrono::nanoseconds(1));
+    advancedTo = now;
+    nextSpawnAt = now;
+    active = 0;
+    recent = 0;
+    escapedCells = 0;
+    hits = 0;
+    misses = 0;
+    escapes = 0;
+}
+
+/**
+ * @brief Lets moles escape and spawns new ones, up to the current time.
+ *
+ * The deadlines are taken one at a time, in order, each at its own time: a mole spawned at
+ * a deadline escapes one lifetime after that deadline, not after the time the caller woke
+ * up. The round therefore plays the same whether advance() is called at every deadline or
+ * once, late, for several of them. At each deadline escapes are handled first, so a free
+ * slot can be refilled at the same time. Spawns missed while every slot was taken are not
+ * banked: a freed slot is filled at once and the next spawn waits for the interval. An
+ * escaped mole's times are kept until the cell's next escape, for keys older than it.
+ *
+ * @param now The current time.
+ * @param random Engine that picks the cells.
+ * @return The cells that changed.
+ */
+MoleEngine::Step MoleEngine::advance(Clock::time_point now, Random& random) {
+    Step step{0, 0, 0};
+    for (Clock::time_point at = nextDeadline(); at <= now; at = nextDeadline()) {
+        std::uint16_t escaped = 0;
+        for (std::uint16_t pending = active; pending != 0; pending &= pending - 1) {
+            int cell = __builtin_ctz(pending);
+            if (escapesAt[cell] <= at) {
+                escaped |= static_cast<std::uint16_t>(1u << cell);
+                escapedSpawnedAt[cell] = spawnedAt[cell];
+                escapedAt[cell] = escapesAt[cell];
+            }
+        }
+        if (escaped) {
+            active &= static_cast<std::uint16_t>(~escaped);
+            escapedCells |= escaped;
+            recent = escaped;
+            int count = __builtin_popcount(escaped);
+            escapes += static_cast<std::uint32_t>(count);
+            step.escaped |= escaped;
+            step.scoreDelta -= mode->escapePenalty * count;
+        }
+
+        if (__builtin_popcount(active) < mode->concurrentMoles && nextSpawnAt <= at) {
+            auto lifetime = scaled(mode->moleLifetime, at);
+            auto interval = scaled(mode->spawnInterval, at);
+            do {
+                int cell = pickCell(random);
+                auto bit = static_cast<std::uint16_t>(1u << cell);
+                active |= bit;
+                step.spawned |= bit;
+                spawnedAt[cell] = at;
+                escapesAt[cell] = at + lifetime;
+                nextSpawnAt = at + interval;
+            } while (__builtin_popcount(active) < mode->concurrentMoles && nextSpawnAt <= at);
+        }
+    }
+    advancedTo = std::max(advancedTo, now);
+    return step;
+}
+
+/**
+ * @brief Applies a key press on a cell.
+ *
+ * The key is judged by the cell as it was at @p at. A hit on a lit mole frees a slot, so a
+ * spawn that was waiting for one is due at the time of the key, or at the last time passed
+ * to advance() if the key is older. A key older than the escape of the cell's last mole
+ * hits that mole instead, and its escape is taken back with the penalty; the slot was
+ * already freed by the escape. A key older than the spawn of the lit mole misses it.
+ *
+ * @param cell The cell of the key, 0-15.
+ * @param at Time of the key press.
+ * @return Whether it was a hit, and the points and reaction time.
+ */
+MoleEngine::Whack MoleEngine::whack(int cell, Clock::time_point at) {
+    cell &= LedLayout::kCellCount - 1;
+    auto bit = static_cast<std::uint16_t>(1u << cell);
+    if ((active & bit) && spawnedAt[cell] <= at) {
+        active &= static_cast<std::uint16_t>(~bit);
+        recent = bit;
+        nextSpawnAt = std::max({nextSpawnAt, at, advancedTo});
+        ++hits;
+        return Whack{true, mode->hitPoints, at - spawnedAt[cell]};
+    }
+    if ((escapedCells & bit) && escapedSpawnedAt[cell] <= at && at < escapedAt[cell]) {
+        escapedCells &= static_cast<std::uint16_t>(~bit);
+        --escapes;
+        ++hits;
+        return Whack{true, mode->hitPoints + mode->escapePenalty, at - escapedSpawnedAt[cell]};
+    }
+    ++misses;
+    return Whack{false, -mode->missPenalty, std::chrono::nanoseconds(0)};
+}
+
+/**
+ * @brief Retrieves the time at which advance() next has work to do.
+ *
+ * @return The next escape or spawn, or Clock::time_point::max() if there is none.
+ */
+MoleEngine::Clock::time_point MoleEngine::nextDeadline() const {
+    Clock::time_point deadline = __builtin_popcount(active) < mode->concurrentMoles ? nextSpawnAt
+                                                                                    : Clock::time_point::max();
+    for (std::uint16_t pending = active; pending != 0; pending &= pending - 1) {
+        deadline = std::min(deadline, escapesAt[__builtin_ctz(pending)]);
+    }
+    return deadline;
+}
+
+/**
+ * @brief Retrieves the lit cells.
+ *
+ * @return Bit i is set if cell i has a mole.
+ */
+std::uint16_t MoleEngine::getMask() const {
+    return active;
+}
+
+/**
+ * @brief Retrieves the time the mole of a cell escapes.
+ *
+ * @param cell A lit cell.
+ * @return The escape time.
+ */
+MoleEngine::Clock::time_point MoleEngine::getEscapeTime(int cell) const {
+    return escapesAt[cell];
+}
+
+/**
+ * @brief Retrieves the mode of the round.
+ *
+ * @return The mode passed to start().
+ */
+const GameMode& MoleEngine::getMode() const {
+    return *mode;
+}
+
+/**
+ * @brief Retrieves the number of moles hit in this round.
+ */
+std::uint32_t MoleEngine::getHits() const {
+    return hits;
+}
+
+/**
+ * @brief Retrieves the number of keys pressed on empty cells in this round.
+ */
+std::uint32_t MoleEngine::getMisses() const {
+    return misses;
+}
+
+/**
+ * @brief Retrieves the number of moles that escaped in this round.
+ */
+std::uint32_t MoleEngine::getEscapes() const {
+    return escapes;
+}
+
+/**
+ * @brief Applies the speed-up curve to an interval.
+ *
+ * The interval shrinks linearly with the elapsed share of the round, down to
+ * (1000 - speedUpPermille) / 1000 of its length at the end.
+ */
+std::chrono::nanoseconds MoleEngine::scaled(std::chrono::nanoseconds base, Clock::time_point now) const {
+    auto elapsed = std::min(std::max(now - startedAt, Clock::duration::zero()), Clock::duration(roundLength));
+    auto progress = elapsed.count() * 1000 / roundLength.count();
+    auto permille = 1000 - mode->speedUpPermille * progress / 1000;
+    return base * permille / 1000;
+}
+
+/**
+ * @brief Picks a free cell, avoiding the cell cleared last if there is a choice.
+ */
+int MoleEngine::pickCell(Random& random) const {
+    auto candidates = static_cast<std::uint16_t>(kAllCells & ~active & ~recent);
+    if (candidates == 0) {
+        candidates = static_cast<std::uint16_t>(kAllCells & ~active);
+    }
+    std::uint32_t skip = random.nextBelow(static_cast<std::uint32_t>(__builtin_popcount(candidates)));
+    for (; skip > 0; --skip) {
+        candidates &= static_cast<std::uint16_t>(candidates - 1);
+    }
+    return __builtin_ctz(candidates);
+}
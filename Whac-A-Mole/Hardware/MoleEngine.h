@@ -0,0 +1,136 @@
+#ifndef MOLEENGINE_H
+#define MOLEENGINE_H
+
+#include "GameMode.h"
+#include "LedLayout.h"
+#include "Random.h"
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @class MoleEngine
+ * @brief Runs the moles of a round from a GameMode table entry.
+ *
+ * The lit moles are a 16-bit cell mask, so testing a key against every mole is one bit
+ * test, and the mask can be written to the LedFrameBuffer as it is. Each cell keeps the
+ * time it was spawned and the time it escapes. The engine never looks at the clock itself:
+ * the caller passes the current time to advance() and whack(), and sleeps until
+ * nextDeadline(), which makes the engine easy to drive from a simulated clock. Every spawn
+ * and escape happens at its deadline, whenever the caller gets to call advance(), so how
+ * late the caller wakes up does not change the round. Likewise a key is judged by the moles
+ * lit at its own time, even when it reaches whack() after advance() has gone past it.
+ * @author Anubhav Aery
+ */
+class MoleEngine {
+public:
+    using Clock = std::chrono::steady_clock; ///< Clock of every time point passed in.
+
+    /**
+     * @brief What advance() changed.
+     */
+    struct Step {
+        std::uint16_t spawned; ///< Cells that got a mole.
+        std::uint16_t escaped; ///< Cells whose mole escaped.
+        int scoreDelta;        ///< Points lost to escapes, as a negative number or zero.
+    };
+
+    /**
+     * @brief The outcome of a key press.
+     */
+    struct Whack {
+        bool hit;                       ///< True if the cell had a mole at the time of the key.
+        int scoreDelta;                 ///< Points won or lost, including an escape penalty taken back.
+        std::chrono::nanoseconds reaction; ///< Time since the mole was spawned, for hits.
+    };
+
+    /**
+     * @brief Constructs an idle engine running the easy mode.
+     */
+    MoleEngine();
+
+    /**
+     * @brief Starts a round.
+     *
+     * @param mode The parameters of the round.
+     * @param now The current time.
+     * @param roundLength Length of the round, over which the speed-up is applied.
+     */
+    void start(const GameMode& mode, Clock::time_point now, std::chrono::nanoseconds roundLength);
+
+    /**
+     * @brief Lets moles escape and spawns new ones, up to the current time.
+     *
+     * @param now The current time.
+     * @param random Engine that picks the cells.
+     * @return The cells that changed.
+     */
+    Step advance(Clock::time_point now, Random& random);
+
+    /**
+     * @brief Applies a key press on a cell.
+     *
+     * A key newer than the last advance() must be preceded by advance() to its time. An older
+     * key, such as a button edge that waited in a queue, still hits a mole that escaped after
+     * it, which takes the escape back, and misses a mole that was spawned after it.
+     *
+     * @param cell The cell of the key, 0-15.
+     * @param at Time of the key press.
+     * @return Whether it was a hit, and the points and reaction time.
+     */
+    Whack whack(int cell, Clock::time_point at);
+
+    /**
+     * @brief Retrieves the time at which advance() next has work to do.
+     *
+     * @return The next escape or spawn, or Clock::time_point::max() if there is none.
+     */
+    Clock::time_point nextDeadline() const;
+
+    /**
+     * @brief Retrieves the lit cells.
+     *
+     * @return Bit i is set if cell i has a mole.
+     */
+    std::uint16_t getMask() const;
+
+    /**
+     * @brief Retrieves the time the mole of a cell escapes if it is not hit.
+     *
+     * @param cell A lit cell, 0-15.
+     * @return The escape time.
+     */
+    Clock::time_point getEscapeTime(int cell) const;
+
+    /**
+     * @brief Retrieves the mode of the round.
+     *
+     * @return The mode passed to start().
+     */
+    const GameMode& getMode() const;
+
+    std::uint32_t getHits() const;    ///< @return Moles hit in this round.
+    std::uint32_t getMisses() const;  ///< @return Keys that found no mole in this round.
+    std::uint32_t getEscapes() const; ///< @return Moles that escaped in this round.
+
+private:
+    std::chrono::nanoseconds scaled(std::chrono::nanoseconds base, Clock::time_point now) const;
+    int pickCell(Random& random) const;
+
+    const GameMode* mode;                             ///< Parameters of the round.
+    Clock::time_point startedAt;                      ///< Start of the round.
+    std::chrono::nanoseconds roundLength;             ///< Length of the round.
+    Clock::time_point advancedTo;                     ///< Latest time passed to advance().
+    Clock::time_point nextSpawnAt;                    ///< Earliest time of the next spawn.
+    std::uint16_t active;                             ///< Cells with a mole.
+    std::uint16_t recent;                             ///< Cell most recently cleared, not reused at once.
+    Clock::time_point spawnedAt[LedLayout::kCellCount]; ///< Spawn time of each lit cell.
+    Clock::time_point escapesAt[LedLayout::kCellCount]; ///< Escape time of each lit cell.
+    std::uint16_t escapedCells;                       ///< Cells whose last escaped mole was not hit since.
+    Clock::time_point escapedSpawnedAt[LedLayout::kCellCount]; ///< Spawn time of each cell's last escaped mole.
+    Clock::time_point escapedAt[LedLayout::kCellCount]; ///< Escape time of each cell's last escaped mole.
+    std::uint32_t hits;                               ///< Moles hit.
+    std::uint32_t misses;                             ///< Keys that found no mole.
+    std::uint32_t escapes;                            ///< Moles that escaped.
+};
+
+#endif // MOLEENGINE_H
@@ -0,0 +1,232 @@
+#include "PigpioBackend.h"
+#include <chrono>
+
+/**
+ * @class PigpioBackend
+ * @brief Forwards GPIO operations to pigpio.
+ * @author Anubhav Aery
+ */
+PigpioBackend::PigpioBackend()
+        : waveId(-1), pulseBuffer(), watchedPins(0), edgeMutex(), edgeHandler(nullptr), edgeContext(nullptr) {}
+
+/**
+ * @brief Initialises pigpio.
+ *
+ * @return True on success, false if gpioInitialise() fails (for example without root).
+ */
+bool PigpioBackend::initialise() {
+    return gpioInitialise() >= 0;
+}
+
+/**
+ * @brief Shuts pigpio down.
+ */
+void PigpioBackend::terminate() {
+    watchEdges(0, nullptr, nullptr);
+    cancelWave();
+    gpioTerminate();
+}
+
+/**
+ * @brief Configures a pin as an output.
+ *
+ * @param pin The GPIO pin number.
+ */
+void PigpioBackend::setOutput(int pin) {
+    gpioSetMode(pin, PI_OUTPUT);
+}
+
+/**
+ * @brief Drives a single pin.
+ *
+ * @param pin The GPIO pin number.
+ * @param level 1 for high, 0 for low.
+ */
+void PigpioBackend::write(int pin, int level) {
+    gpioWrite(pin, level);
+}
+
+/**
+ * @brief Drives several pins of bank 0 through the GPSET0 and GPCLR0 registers.
+ *
+ * The clear is written first so that a cell moving from one LED to another never
+ * shows both LEDs lit at once.
+ *
+ * @param setMask Pins to drive high.
+ * @param clearMask Pins to drive low.
+ */
+void PigpioBackend::writeBank(std::uint32_t setMask, std::uint32_t clearMask) {
+    if (clearMask != 0) {
+        gpioWrite_Bits_0_31_Clear(clearMask);
+    }
+    if (setMask != 0) {
+        gpioWrite_Bits_0_31_Set(setMask);
+    }
+}
+
+/**
+ * @brief Reports that waveforms are played by the DMA engine.
+ *
+ * @return True.
+ */
+bool PigpioBackend::supportsWaves() const {
+    return true;
+}
+
+/**
+ * @brief Builds a pigpio wave from the pulses and transmits it once.
+ *
+ * The wave in flight is stopped and deleted first, so at most one wave exists. The new
+ * one is added with gpioWaveAddGeneric() and started in one-shot mode; from then on the DMA
+ * engine times the pulses, to the microsecond, without the CPU.
+ *
+ * @param pulses The steps, in order.
+ * @param count Number of pulses.
+ * @return True if the wave is being transmitted.
+ */
+bool PigpioBackend::sendWave(const GpioPulse* pulses, std::size_t count) {
+    cancelWave();
+    if (count == 0) {
+        return false;
+    }
+    pulseBuffer.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        pulseBuffer[i].gpioOn = pulses[i].setMask;
+        pulseBuffer[i].gpioOff = pulses[i].clearMask;
+        pulseBuffer[i].usDelay = pulses[i].delayUs;
+    }
+    gpioWaveAddNew();
+    if (gpioWaveAddGeneric(static_cast<unsigned>(count), pulseBuffer.data()) < 0) {
+        return false;
+    }
+    int id = gpioWaveCreate();
+    if (id < 0) {
+        return false;
+    }
+    if (gpioWaveTxSend(static_cast<unsigned>(id), PI_WAVE_MODE_ONE_SHOT) < 0) {
+        gpioWaveDelete(static_cast<unsigned>(id));
+        return false;
+    }
+    waveId = id;
+    return true;
+}
+
+/**
+ * @brief Stops the wave being transmitted and frees it.
+ */
+void PigpioBackend::cancelWave() {
+    if (waveId < 0) {
+        return;
+    }
+    gpioWaveTxStop();
+    gpioWaveDelete(static_cast<unsigned>(waveId));
+    waveId = -1;
+}
+
+/**
+ * @brief Reports that pins are dimmed by the DMA engine.
+ *
+ * @return True.
+ */
+bool PigpioBackend::supportsPwm() const {
+    return true;
+}
+
+/**
+ * @brief Sets the PWM frequency of a pin.
+ *
+ * The range is set to 255 as well, so a duty cycle maps to gpioPWM() unchanged.
+ *
+ * @param pin The GPIO pin number.
+ * @param frequencyHz The requested frequency.
+ */
+void PigpioBackend::setPwmFrequency(int pin, int frequencyHz) {
+    gpioSetPWMfrequency(pin, frequencyHz);
+    gpioSetPWMrange(pin, 255);
+}
+
+/**
+ * @brief Sets the duty cycle of a pin.
+ *
+ * From then on the DMA engine toggles the pin every period without the CPU. A duty cycle
+ * of 0 goes through gpioWrite(), which switches the pulses off, so the bank writes of the
+ * LedFrameBuffer reach the pin again.
+ *
+ * @param pin The GPIO pin number.
+ * @param duty The duty cycle, out of 255.
+ */
+void PigpioBackend::setPwm(int pin, std::uint8_t duty) {
+    if (duty == 0) {
+        gpioWrite(pin, 0);
+    } else {
+        gpioPWM(pin, duty);
+    }
+}
+
+/**
+ * @brief Reports that pins can be watched through pigpio's alerts.
+ *
+ * @return True.
+ */
+bool PigpioBackend::supportsEdges() const {
+    return true;
+}
+
+/**
+ * @brief Registers an alert on every watched pin.
+ *
+ * Alerts rather than gpioSetISRFunc(): pigpio samples the pins on its own clock, so every
+ * edge carries the tick at which it was seen, even though the alert thread delivers them
+ * in batches about a millisecond apart. The alerts of the pins watched before are removed
+ * first. The handler is replaced under the mutex the alert thread holds while it calls the
+ * handler, so an edge that is being delivered finishes before this returns.
+ *
+ * @param pins Pins to watch.
+ * @param handler Receives every edge.
+ * @param context Passed to the handler.
+ * @return True if every pin is watched.
+ */
+bool PigpioBackend::watchEdges(std::uint32_t pins, GpioEdgeHandler handler, void* context) {
+    for (std::uint32_t watched = watchedPins; watched != 0; watched &= watched - 1) {
+        gpioSetAlertFuncEx(static_cast<unsigned>(__builtin_ctz(watched)), nullptr, nullptr);
+    }
+    watchedPins = 0;
+    {
+        std::lock_guard<std::mutex> lock(edgeMutex);
+        edgeHandler = handler;
+        edgeContext = context;
+    }
+    bool watching = true;
+    for (; pins != 0; pins &= pins - 1) {
+        unsigned pin = static_cast<unsigned>(__builtin_ctz(pins));
+        gpioSetMode(pin, PI_INPUT);
+        gpioSetPullUpDown(pin, PI_PUD_UP);
+        if (gpioSetAlertFuncEx(pin, &PigpioBackend::onAlert, this) < 0) {
+            watching = false;
+            continue;
+        }
+        watchedPins |= 1u << pin;
+    }
+    return watching;
+}
+
+/**
+ * @brief Alert function of the watched pins.
+ *
+ * The tick is pigpio's microsecond counter, which wraps every 72 minutes and does not run
+ * on CLOCK_MONOTONIC. Its age is taken against gpioTick() at once, which the unsigned
+ * subtraction keeps right across a wrap, and subtracted from steady_clock's now. Level 2
+ * is a watchdog timeout, not an edge.
+ */
+void PigpioBackend::onAlert(int gpio, int level, std::uint32_t tick, void* self) {
+    auto* backend = static_cast<PigpioBackend*>(self);
+    if (level != 0 && level != 1) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    std::uint32_t age = gpioTick() - tick;
+    std::lock_guard<std::mutex> lock(backend->edgeMutex);
+    if (backend->edgeHandler) {
+        backend->edgeHandler(GpioEdge{now - std::chrono::microseconds(age), gpio, level}, backend->edgeContext);
+    }
+}
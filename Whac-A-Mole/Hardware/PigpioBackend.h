@@ -0,0 +1,117 @@
+#ifndef PIGPIOBACKEND_H
+#define PIGPIOBACKEND_H
+
+#include "GpioBackend.h"
+#include <pigpio.h>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class PigpioBackend
+ * @brief GpioBackend that drives the Raspberry Pi pins through the pigpio library.
+ *
+ * pigpio maps the GPIO registers directly, which requires root privileges. Waveforms are
+ * played by pigpio's DMA engine, which changes the pins on its own microsecond clock while
+ * the CPU sleeps. PWM uses pigpio's DMA-timed software PWM, which works on every GPIO.
+ * Button edges come from pigpio's alerts: pigpio samples the pins every few microseconds
+ * and stamps each change with its microsecond tick, which is converted to steady_clock.
+ * @author Anubhav Aery
+ */
+class PigpioBackend : public GpioBackend {
+public:
+    /**
+     * @brief Constructor for PigpioBackend. No waveform is playing.
+     */
+    PigpioBackend();
+
+    bool initialise() override;
+    void terminate() override;
+    void setOutput(int pin) override;
+    void write(int pin, int level) override;
+
+    /**
+     * @brief Drives several pins with one write to the set and one to the clear register.
+     *
+     * @param setMask Pins to drive high.
+     * @param clearMask Pins to drive low.
+     */
+    void writeBank(std::uint32_t setMask, std::uint32_t clearMask) override;
+
+    /**
+     * @brief Reports that waveforms are played by the DMA engine.
+     *
+     * @return True.
+     */
+    bool supportsWaves() const override;
+
+    /**
+     * @brief Builds a pigpio wave from the pulses and transmits it once.
+     *
+     * @param pulses The steps, in order.
+     * @param count Number of pulses.
+     * @return True if the wave is being transmitted.
+     */
+    bool sendWave(const GpioPulse* pulses, std::size_t count) override;
+
+    /**
+     * @brief Stops the wave being transmitted and frees it.
+     */
+    void cancelWave() override;
+
+    /**
+     * @brief Reports that pins are dimmed by the DMA engine.
+     *
+     * @return True.
+     */
+    bool supportsPwm() const override;
+
+    /**
+     * @brief Sets the PWM frequency of a pin with gpioSetPWMfrequency().
+     *
+     * @param pin The GPIO pin number.
+     * @param frequencyHz The requested frequency; pigpio picks the nearest it supports.
+     */
+    void setPwmFrequency(int pin, int frequencyHz) override;
+
+    /**
+     * @brief Sets the duty cycle of a pin with gpioPWM().
+     *
+     * @param pin The GPIO pin number.
+     * @param duty The duty cycle, out of 255.
+     */
+    void setPwm(int pin, std::uint8_t duty) override;
+
+    /**
+     * @brief Reports that pins can be watched through pigpio's alerts.
+     *
+     * @return True.
+     */
+    bool supportsEdges() const override;
+
+    /**
+     * @brief Registers an alert with gpioSetAlertFuncEx() on every watched pin.
+     *
+     * Waits for an alert that is still calling the previous handler.
+     *
+     * @param pins Pins to watch.
+     * @param handler Receives every edge, on pigpio's alert thread.
+     * @param context Passed to the handler.
+     * @return True if every pin is watched.
+     */
+    bool watchEdges(std::uint32_t pins, GpioEdgeHandler handler, void* context) override;
+
+private:
+    /**
+     * @brief Alert function of the watched pins; converts the tick and calls the handler.
+     */
+    static void onAlert(int gpio, int level, std::uint32_t tick, void* self);
+
+    int waveId; ///< Wave being transmitted, or -1.
+    std::vector<gpioPulse_t> pulseBuffer; ///< Pulses handed to pigpio, reused between waves.
+    std::uint32_t watchedPins;  ///< Pins with an alert function.
+    std::mutex edgeMutex;       ///< Held by the alert thread while it calls the handler, and to replace it.
+    GpioEdgeHandler edgeHandler; ///< Receives the edges of the watched pins; guarded by edgeMutex.
+    void* edgeContext;          ///< Passed to edgeHandler; guarded by edgeMutex.
+};
+
+#endif // PIGPIOBACKEND_H
@@ -58,3 +58,12 @@ void Player::decrementScore() {
         score--;
     }
 }
+
+/**
+ * @brief Adds points to the player's score, not allowing it to go below zero.
+ *
+ * @param points The points to add; negative for a penalty.
+ */
+void Player::addPoints(int points) {
+    score = score + points > 0 ? score + points : 0;
+}
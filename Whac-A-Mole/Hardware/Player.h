@@ -57,6 +57,13 @@ public:
      */
     void decrementScore();
 
+    /**
+     * @brief Adds points to the player's score, not allowing it to go below zero.
+     *
+     * @param points The points to add; negative for a penalty.
+     */
+    void addPoints(int points);
+
 private:
     std::string name; ///< The name of the player.
     int score; ///< The score of the player.
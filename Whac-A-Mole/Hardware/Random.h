@@ -0,0 +1,167 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+/**
+ * @class Random
+ * @brief Small, fast xoshiro256** random engine for mole placement.
+ *
+ * The engine is seeded once per game controller and then produces numbers with a few
+ * arithmetic instructions and 32 bytes of state, instead of opening the entropy source and
+ * initialising a 5 KB Mersenne Twister for every mole. Re-seeding with a fixed value makes
+ * a run fully deterministic. The class satisfies UniformRandomBitGenerator, so it also
+ * works with the <random> distributions.
+ * @author Anubhav Aery
+ */
+class Random {
+public:
+    using result_type = std::uint64_t; ///< Type produced by operator().
+
+    /**
+     * @brief Constructs an engine seeded from std::random_device.
+     */
+    Random() : Random(std::random_device{}() | (static_cast<std::uint64_t>(std::random_device{}()) << 32)) {}
+
+    /**
+     * @brief Constructs an engine with a fixed seed.
+     *
+     * @param seedValue The seed; equal seeds produce equal sequences.
+     */
+    explicit Random(std::uint64_t seedValue) : state(), seedValue(0) {
+        seed(seedValue);
+    }
+
+    /**
+     * @brief Re-seeds the engine.
+     *
+     * The four state words are derived from the seed with splitmix64, as recommended by the
+     * xoshiro authors, so even small or similar seeds give well mixed states.
+     *
+     * @param value The new seed.
+     */
+    void seed(std::uint64_t value) {
+        seedValue = value;
+        std::uint64_t x = value;
+        for (auto& word : state) {
+            x += 0x9e3779b97f4a7c15ULL;
+            std::uint64_t z = x;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    /**
+     * @brief Retrieves the seed the engine was last seeded with.
+     *
+     * @return The seed, which can be recorded to reproduce a run.
+     */
+    std::uint64_t getSeed() const {
+        return seedValue;
+    }
+
+    /**
+     * @brief Produces the next 64 random bits.
+     *
+     * @return A uniformly distributed 64-bit value.
+     */
+    std::uint64_t next() {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief Produces a uniformly distributed value in [0, bound).
+     *
+     * Uses Lemire's multiply-and-reject method, which needs no division in the common case.
+     *
+     * @param bound The exclusive upper bound, greater than zero.
+     * @return A value in [0, bound).
+     */
+    std::uint32_t nextBelow(std::uint32_t bound) {
+        std::uint64_t product = (next() >> 32) * bound;
+        auto low = static_cast<std::uint32_t>(product);
+        if (low < bound) {
+            const std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+            while (low < threshold) {
+                product = (next() >> 32) * bound;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+    /**
+     * @brief Picks a random cell that differs from the current one.
+     *
+     * @param current The current cell, or a negative value if no cell is lit.
+     * @param cellCount The number of cells to choose from.
+     * @return A cell in [0, cellCount) that is not @p current.
+     */
+    int nextCell(int current, int cellCount) {
+        if (current < 0 || current >= cellCount || cellCount < 2) {
+            return static_cast<int>(nextBelow(static_cast<std::uint32_t>(cellCount)));
+        }
+        int cell = static_cast<int>(nextBelow(static_cast<std::uint32_t>(cellCount - 1)));
+        return cell >= current ? cell + 1 : cell;
+    }
+
+    /**
+     * @brief Generates the cells of the next moles in one batch.
+     *
+     * Consecutive cells always differ, exactly as with repeated calls to nextCell().
+     *
+     * @param out Destination for @p count cell indices.
+     * @param count Number of cells to generate.
+     * @param current The currently lit cell, or a negative value if none.
+     * @param cellCount The number of cells to choose from.
+     */
+    void nextCells(std::uint8_t* out, std::size_t count, int current, int cellCount) {
+        for (std::size_t i = 0; i < count; ++i) {
+            current = nextCell(current, cellCount);
+            out[i] = static_cast<std::uint8_t>(current);
+        }
+    }
+
+    /**
+     * @brief Smallest value produced by operator().
+     */
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    /**
+     * @brief Largest value produced by operator().
+     */
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    /**
+     * @brief Produces the next 64 random bits, for use with <random> distributions.
+     */
+    result_type operator()() {
+        return next();
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t state[4]; ///< The xoshiro256** state.
+    std::uint64_t seedValue; ///< The seed the state was derived from.
+};
+
+#endif // RANDOM_H
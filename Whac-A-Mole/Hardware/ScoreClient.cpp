@@ -0,0 +1,173 @@
+#include "ScoreClient.h"
+#include "ScoreProtocol.h"
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+/**
+ * @class ScoreClient
+ * @brief Blocking client of the whac-scored leaderboard daemon.
+ * @author Eseosa Emmanuel Atekha
+ */
+ScoreClient::ScoreClient() : fd(-1) {}
+
+/**
+ * @brief Closes the connection.
+ */
+ScoreClient::~ScoreClient() {
+    close();
+}
+
+/**
+ * @brief Connects to the daemon.
+ *
+ * @param socketPath Path of the daemon's socket.
+ * @param timeout Timeout of every later send and receive.
+ * @return True on success, false if no daemon listens on the path.
+ */
+bool ScoreClient::connect(const std::string& socketPath, std::chrono::milliseconds timeout) {
+    close();
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    timeval limit{};
+    limit.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    limit.tv_usec = static_cast<suseconds_t>(timeout.count() % 1000 * 1000);
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &limit, sizeof(limit));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &limit, sizeof(limit));
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Closes the connection.
+ */
+void ScoreClient::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+/**
+ * @brief Checks whether the client is connected.
+ *
+ * @return True if connected.
+ */
+bool ScoreClient::isConnected() const {
+    return fd >= 0;
+}
+
+/**
+ * @brief Submits scores and waits until the daemon has made them durable.
+ *
+ * The header and the records go out in one message.
+ *
+ * @param records The scores; the daemon assigns the sequence numbers.
+ * @param count Number of scores, at most ScoreProtocol::kMaxRecords.
+ * @param firstSequence Receives the sequence number of the first score.
+ * @return True once the scores are on disk, false on any error.
+ */
+bool ScoreClient::submit(const ScoreRecord* records, std::size_t count, std::uint32_t* firstSequence) {
+    if (!isConnected() || count == 0 || count > ScoreProtocol::kMaxRecords) {
+        return false;
+    }
+    std::vector<char> frame(sizeof(ScoreProtocol::FrameHeader) + count * sizeof(ScoreRecord));
+    ScoreProtocol::FrameHeader header =
+            ScoreProtocol::makeHeader(ScoreProtocol::Type::Submit, static_cast<std::uint32_t>(count));
+    std::memcpy(frame.data(), &header, sizeof(header));
+    std::memcpy(frame.data() + sizeof(header), records, count * sizeof(ScoreRecord));
+
+    ScoreProtocol::FrameHeader reply{};
+    if (!sendAll(frame.data(), frame.size()) || !receiveAll(&reply, sizeof(reply)) ||
+        reply.magic != ScoreProtocol::kMagic || reply.type != ScoreProtocol::Type::SubmitAck || reply.count != count) {
+        close();
+        return false;
+    }
+    if (firstSequence) {
+        *firstSequence = reply.value;
+    }
+    return true;
+}
+
+/**
+ * @brief Retrieves the best scores.
+ *
+ * @param limit Maximum number of scores.
+ * @param bestPerPlayer If true, only the best score of each player.
+ * @param records Receives the scores, best first.
+ * @return True on success, false on any error.
+ */
+bool ScoreClient::top(std::size_t limit, bool bestPerPlayer, std::vector<ScoreRecord>& records) {
+    if (!isConnected()) {
+        return false;
+    }
+    auto count = static_cast<std::uint32_t>(std::min<std::size_t>(limit, ScoreProtocol::kMaxRecords));
+    ScoreProtocol::FrameHeader request = ScoreProtocol::makeHeader(
+            ScoreProtocol::Type::Top, count, bestPerPlayer ? ScoreProtocol::kBestPerPlayer : 0);
+    ScoreProtocol::FrameHeader reply{};
+    if (!sendAll(&request, sizeof(request)) || !receiveAll(&reply, sizeof(reply)) ||
+        reply.magic != ScoreProtocol::kMagic || reply.type != ScoreProtocol::Type::TopReply || reply.count > count) {
+        close();
+        return false;
+    }
+    records.resize(reply.count);
+    if (!receiveAll(records.data(), reply.count * sizeof(ScoreRecord))) {
+        records.clear();
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sends a whole buffer, retrying after interrupts and short writes.
+ */
+bool ScoreClient::sendAll(const void* data, std::size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t sent = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        bytes += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+/**
+ * @brief Receives a whole buffer, retrying after interrupts and short reads.
+ */
+bool ScoreClient::receiveAll(void* data, std::size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t received = recv(fd, bytes, size, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<std::size_t>(received);
+    }
+    return true;
+}
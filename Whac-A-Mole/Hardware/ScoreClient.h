@@ -0,0 +1,84 @@
+#ifndef SCORECLIENT_H
+#define SCORECLIENT_H
+
+#include "ScoreStore.h"
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @class ScoreClient
+ * @brief Blocking client of the whac-scored leaderboard daemon.
+ *
+ * Talks to the daemon over a Unix domain socket with the frames of ScoreProtocol. Every
+ * call waits for the reply, and every send and receive has a timeout, so a hung daemon
+ * turns into a failed call rather than a frozen game. After a failure the connection is
+ * closed and isConnected() returns false.
+ * @author Eseosa Emmanuel Atekha
+ */
+class ScoreClient {
+public:
+    /**
+     * @brief Constructs an unconnected client.
+     */
+    ScoreClient();
+
+    /**
+     * @brief Closes the connection.
+     */
+    ~ScoreClient();
+
+    ScoreClient(const ScoreClient&) = delete;
+    ScoreClient& operator=(const ScoreClient&) = delete;
+
+    /**
+     * @brief Connects to the daemon.
+     *
+     * @param socketPath Path of the daemon's socket.
+     * @param timeout Timeout of every later send and receive.
+     * @return True on success, false if no daemon listens on the path.
+     */
+    bool connect(const std::string& socketPath,
+                 std::chrono::milliseconds timeout = std::chrono::milliseconds(2000));
+
+    /**
+     * @brief Closes the connection.
+     */
+    void close();
+
+    /**
+     * @brief Checks whether the client is connected.
+     *
+     * @return True if connect() succeeded and no call has failed since.
+     */
+    bool isConnected() const;
+
+    /**
+     * @brief Submits scores and waits until the daemon has made them durable.
+     *
+     * @param records The scores; the daemon assigns the sequence numbers.
+     * @param count Number of scores, at most ScoreProtocol::kMaxRecords.
+     * @param firstSequence Receives the sequence number of the first score.
+     * @return True once the scores are on disk, false on any error.
+     */
+    bool submit(const ScoreRecord* records, std::size_t count, std::uint32_t* firstSequence = nullptr);
+
+    /**
+     * @brief Retrieves the best scores.
+     *
+     * @param limit Maximum number of scores.
+     * @param bestPerPlayer If true, only the best score of each player.
+     * @param records Receives the scores, best first.
+     * @return True on success, false on any error.
+     */
+    bool top(std::size_t limit, bool bestPerPlayer, std::vector<ScoreRecord>& records);
+
+private:
+    bool sendAll(const void* data, std::size_t size);
+    bool receiveAll(void* data, std::size_t size);
+
+    int fd; ///< Connected socket, or -1.
+};
+
+#endif // SCORECLIENT_H
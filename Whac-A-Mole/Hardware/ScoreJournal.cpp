@@ -0,0 +1,408 @@
+#include "ScoreJournal.h"
+#include "Leaderboard.h"
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+const std::uint32_t kFrameMagic = 0x314c4157; ///< "WAL1" in little-endian byte order.
+
+/**
+ * @brief Builds the lookup table of the reflected CRC-32 polynomial used by zlib and Ethernet.
+ */
+constexpr std::array<std::uint32_t, 256> makeCrcTable() {
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320u : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<std::uint32_t, 256> kCrcTable = makeCrcTable();
+
+} // namespace
+
+/**
+ * @class ScoreJournal
+ * @brief Write-ahead log with CRC-checked frames, group commit and a background compactor.
+ *
+ * @param basePath Path of the store without extension.
+ * @param compactThreshold Durable scores that trigger a fold at once.
+ * @param compactDelay Longest time a durable score waits for its fold.
+ * @author Eseosa Emmanuel Atekha
+ */
+ScoreJournal::ScoreJournal(const std::string& basePath, std::size_t compactThreshold,
+                           std::chrono::milliseconds compactDelay)
+        : path(basePath + ".wal"), compactThreshold(std::max<std::size_t>(1, compactThreshold)),
+          compactDelay(compactDelay), store(nullptr), fd(-1), recovered(0), nextSequence(0), durableSequence(0),
+          writeFailed(false), foldFailed(false), committing(false), stopping(false), commits(0), compactions(0) {}
+
+/**
+ * @brief Destructor for ScoreJournal.
+ */
+ScoreJournal::~ScoreJournal() {
+    close();
+}
+
+/**
+ * @brief Takes the journal lock without starting the threads.
+ *
+ * @return True if the lock is held, false if another owner holds it or the journal cannot be opened.
+ */
+bool ScoreJournal::lock() {
+    if (fd >= 0) {
+        return true;
+    }
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Unable to open " << path << std::endl;
+        return false;
+    }
+    // Another owner is a normal case, for example the daemon or another game process
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Locks the journal, recovers it into the store and starts the threads.
+ *
+ * @param target The open store the journal folds into.
+ * @return True on success, false if the journal is locked by another owner or cannot be opened.
+ */
+bool ScoreJournal::open(ScoreStore& target) {
+    if (isOpen()) {
+        return true;
+    }
+    if (!lock()) {
+        return false;
+    }
+    if (!recover(target)) {
+        std::cerr << "Unable to recover " << path << std::endl;
+        close();
+        return false;
+    }
+    writeFailed = false;
+    foldFailed = false;
+    committing = false;
+    stopping = false;
+    committer = std::thread(&ScoreJournal::commitLoop, this);
+    compactor = std::thread(&ScoreJournal::compactLoop, this);
+    return true;
+}
+
+/**
+ * @brief Commits and folds everything submitted, stops the threads and unlocks the journal.
+ */
+void ScoreJournal::close() {
+    if (isOpen()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        queuedChanged.notify_all();
+        durableChanged.notify_all();
+        committer.join();
+        compactor.join();
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    store = nullptr;
+}
+
+/**
+ * @brief Checks whether the journal is open.
+ *
+ * @return True if the threads are running.
+ */
+bool ScoreJournal::isOpen() const {
+    return committer.joinable();
+}
+
+/**
+ * @brief Queues a score for the committer. The journal must be open.
+ *
+ * @param record The score; its sequence field is assigned here.
+ * @return The sequence number of the score.
+ */
+std::uint32_t ScoreJournal::submit(ScoreRecord record) {
+    std::uint32_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sequence = nextSequence++;
+        record.sequence = sequence;
+        queued.push_back(record);
+    }
+    queuedChanged.notify_one();
+    return sequence;
+}
+
+/**
+ * @brief Waits until every score submitted so far is durable.
+ *
+ * @return True if they are all on disk, false if a write failed.
+ */
+bool ScoreJournal::flush() {
+    if (!isOpen()) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    std::uint32_t target = nextSequence;
+    durableChanged.wait(lock, [&] { return durableSequence >= target; });
+    return !writeFailed;
+}
+
+/**
+ * @brief Retrieves the number of scores recovered by open().
+ *
+ * @return The number of valid frames found in the journal.
+ */
+std::size_t ScoreJournal::getRecovered() const {
+    return recovered;
+}
+
+/**
+ * @brief Retrieves the number of group commits so far.
+ *
+ * @return The number of fdatasync calls on the journal.
+ */
+std::uint64_t ScoreJournal::getCommits() const {
+    return commits.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Retrieves the number of folds into the store so far.
+ *
+ * @return The number of compactions.
+ */
+std::uint64_t ScoreJournal::getCompactions() const {
+    return compactions.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Offers the scores of a journal owned by someone else to a leaderboard.
+ *
+ * @param basePath Path of the store without extension.
+ * @param store The store the journal folds into, open for reading.
+ * @param board The leaderboard to fill.
+ * @return The number of scores offered.
+ */
+std::size_t ScoreJournal::loadUnfolded(const std::string& basePath, const ScoreStore& store, Leaderboard& board) {
+    int journalFd = ::open((basePath + ".wal").c_str(), O_RDONLY | O_CLOEXEC);
+    if (journalFd < 0) {
+        return 0;
+    }
+    off_t validBytes = 0;
+    std::size_t offered = 0;
+    for (const ScoreRecord& record : readFrames(journalFd, validBytes)) {
+        if (record.sequence >= store.size()) {
+            board.offer(record);
+            ++offered;
+        }
+    }
+    ::close(journalFd);
+    return offered;
+}
+
+/**
+ * @brief Computes the CRC-32 of everything in a frame after the crc field.
+ */
+std::uint32_t ScoreJournal::checksum(const Frame& frame) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(&frame.record);
+    const auto* end = reinterpret_cast<const unsigned char*>(&frame) + sizeof(Frame);
+    std::uint32_t crc = 0xffffffffu;
+    for (; bytes != end; ++bytes) {
+        crc = kCrcTable[(crc ^ *bytes) & 0xff] ^ (crc >> 8);
+    }
+    return crc ^ 0xffffffffu;
+}
+
+/**
+ * @brief Reads the valid frames from the start of a journal.
+ *
+ * Stops at the first frame with a bad magic or CRC, or whose sequence does not follow the
+ * previous one; that frame and everything after it are the torn tail of an interrupted write.
+ *
+ * @param journalFd The journal file.
+ * @param validBytes Receives the length of the valid prefix.
+ * @return The scores of the valid frames, in order.
+ */
+std::vector<ScoreRecord> ScoreJournal::readFrames(int journalFd, off_t& validBytes) {
+    std::vector<ScoreRecord> records;
+    std::vector<Frame> chunk(1024);
+    validBytes = 0;
+    for (;;) {
+        ssize_t got = pread(journalFd, chunk.data(), chunk.size() * sizeof(Frame), validBytes);
+        std::size_t frames = got > 0 ? static_cast<std::size_t>(got) / sizeof(Frame) : 0;
+        for (std::size_t i = 0; i < frames; ++i) {
+            const Frame& frame = chunk[i];
+            bool follows = records.empty() || frame.record.sequence == records.back().sequence + 1;
+            if (frame.magic != kFrameMagic || frame.crc != checksum(frame) || !follows) {
+                return records;
+            }
+            records.push_back(frame.record);
+            validBytes += static_cast<off_t>(sizeof(Frame));
+        }
+        if (frames < chunk.size()) {
+            return records;
+        }
+    }
+}
+
+/**
+ * @brief Cuts off a torn tail, folds the valid frames into the store and empties the journal.
+ *
+ * If the store already holds scores from the first frame on, a fold was interrupted after
+ * some of its records reached the store; they are dropped and folded again from the journal.
+ * Only the holder of the lock writes to the store, so nothing else can have appended them.
+ *
+ * @param target The open store to fold into.
+ * @return True on success.
+ */
+bool ScoreJournal::recover(ScoreStore& target) {
+    if (fd < 0) {
+        return false;
+    }
+    store = &target;
+    off_t validBytes = 0;
+    std::vector<ScoreRecord> records = readFrames(fd, validBytes);
+    struct stat info;
+    fstat(fd, &info);
+    if (info.st_size > validBytes) {
+        std::cerr << "Discarding " << info.st_size - validBytes << " bytes of an interrupted write at the end of "
+                  << path << std::endl;
+    }
+    recovered = records.size();
+    if (!records.empty()) {
+        if (store->size() > records.front().sequence && !store->truncate(records.front().sequence)) {
+            return false;
+        }
+        if (!store->append(records.data(), records.size()) || !store->sync()) {
+            return false;
+        }
+        std::cout << "Recovered " << records.size() << " scores from " << path << std::endl;
+    }
+    if (info.st_size > 0 && (ftruncate(fd, 0) < 0 || fdatasync(fd) < 0)) {
+        return false;
+    }
+    nextSequence = static_cast<std::uint32_t>(store->size());
+    durableSequence = nextSequence;
+    return true;
+}
+
+/**
+ * @brief Writes every queued group to the journal with one write and one fdatasync.
+ *
+ * Scores that arrive while a group is being synced form the next group. After a failed
+ * write the journal may end in a torn frame, so later groups skip it and go straight to
+ * the compactor, which still makes them durable in the store.
+ */
+void ScoreJournal::commitLoop() {
+    std::vector<ScoreRecord> group;
+    std::vector<Frame> frames;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queuedChanged.wait(lock, [&] { return stopping || !queued.empty(); });
+            if (queued.empty()) {
+                return;
+            }
+            group.swap(queued);
+            committing = true;
+        }
+
+        std::lock_guard<std::mutex> file(fileMutex);
+        bool failed = writeFailed;
+        if (!failed) {
+            frames.resize(group.size());
+            for (std::size_t i = 0; i < group.size(); ++i) {
+                frames[i] = Frame{kFrameMagic, 0, group[i], 0};
+                frames[i].crc = checksum(frames[i]);
+            }
+            auto bytes = static_cast<ssize_t>(frames.size() * sizeof(Frame));
+            failed = write(fd, frames.data(), static_cast<std::size_t>(bytes)) != bytes || fdatasync(fd) != 0;
+            if (failed) {
+                std::cerr << "Unable to write to " << path << "; scores go straight to the store" << std::endl;
+            } else {
+                commits.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            durable.insert(durable.end(), group.begin(), group.end());
+            durableSequence = group.back().sequence + 1;
+            writeFailed = failed;
+            committing = false;
+        }
+        durableChanged.notify_all();
+        group.clear();
+    }
+}
+
+/**
+ * @brief Folds durable scores into the store once enough have gathered or they waited long enough.
+ *
+ * Returns when close() was called and every submitted score has been folded.
+ */
+void ScoreJournal::compactLoop() {
+    std::vector<ScoreRecord> group;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            auto drained = [&] { return !committing && queued.empty(); };
+            durableChanged.wait_for(lock, compactDelay, [&] {
+                return durable.size() >= compactThreshold || (stopping && (!durable.empty() || drained()));
+            });
+            if (durable.empty()) {
+                if (stopping && drained()) {
+                    return;
+                }
+                continue;
+            }
+            group.swap(durable);
+        }
+        if (store->append(group.data(), group.size()) && store->sync()) {
+            compactions.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            std::lock_guard<std::mutex> lock(mutex);
+            foldFailed = true;
+        }
+        group.clear();
+        truncateIfFolded();
+    }
+}
+
+/**
+ * @brief Empties the journal if every frame in it has been folded into the store.
+ *
+ * The committer only adds to the durable list while it holds the file mutex, so with the
+ * file mutex held an empty durable list means the file holds nothing unfolded.
+ */
+void ScoreJournal::truncateIfFolded() {
+    std::lock_guard<std::mutex> file(fileMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (foldFailed || !durable.empty()) {
+            return;
+        }
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0 && (ftruncate(fd, 0) < 0 || fdatasync(fd) < 0)) {
+        std::cerr << "Unable to truncate " << path << std::endl;
+    }
+}
@@ -0,0 +1,194 @@
+#ifndef SCOREJOURNAL_H
+#define SCOREJOURNAL_H
+
+#include "ScoreStore.h"
+#include <sys/types.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Leaderboard;
+
+/**
+ * @class ScoreJournal
+ * @brief Write-ahead log in front of a ScoreStore, so saving a score never waits for the disk.
+ *
+ * submit() queues a score and returns at once. A committer thread writes everything queued
+ * to "<base>.wal" as fixed 64-byte frames, each with a CRC-32, and makes the whole group
+ * durable with one fdatasync. A compactor thread later folds the durable scores into the
+ * ScoreStore, which is the sorted snapshot, syncs it, and empties the journal once nothing
+ * in it is left unfolded.
+ *
+ * open() recovers from a crash with one pass over the journal: frames are read up to the
+ * first one with a bad magic, CRC or sequence, the torn tail after it is cut off, and the
+ * valid frames are folded into the store. A fold that the crash interrupted is undone first,
+ * so every score ends up in the store exactly once.
+ *
+ * Only one ScoreJournal can own a journal at a time; the file is locked with flock. The
+ * lock also decides who writes to the store: its holder is the only writer, and everyone
+ * else opens the store read-only. Once the journal is open, the compactor is the only writer.
+ * @author Eseosa Emmanuel Atekha
+ */
+class ScoreJournal {
+public:
+    /**
+     * @brief Constructor for ScoreJournal.
+     *
+     * @param basePath Path of the store without extension; the journal is "<basePath>.wal".
+     * @param compactThreshold Durable scores that trigger a fold at once.
+     * @param compactDelay Longest time a durable score waits for its fold.
+     */
+    explicit ScoreJournal(const std::string& basePath, std::size_t compactThreshold = 256,
+                          std::chrono::milliseconds compactDelay = std::chrono::milliseconds(1000));
+
+    /**
+     * @brief Destructor for ScoreJournal. Calls close().
+     */
+    ~ScoreJournal();
+
+    ScoreJournal(const ScoreJournal&) = delete;
+    ScoreJournal& operator=(const ScoreJournal&) = delete;
+
+    /**
+     * @brief Takes the journal lock without starting the threads.
+     *
+     * Whoever holds the lock is the only writer of the store, so it is taken before the store
+     * is opened for writing. close() releases it.
+     *
+     * @return True if the lock is held, false if another owner holds it or the journal cannot be opened.
+     */
+    bool lock();
+
+    /**
+     * @brief Folds the scores a crash left in the journal into the store and empties the journal.
+     *
+     * The journal must be locked. open() calls it; an owner that writes to the store itself
+     * calls lock() and recover() instead of open().
+     *
+     * @param store The open store to fold into.
+     * @return True on success.
+     */
+    bool recover(ScoreStore& store);
+
+    /**
+     * @brief Locks the journal, recovers it into the store and starts the threads.
+     *
+     * Until close(), the caller may still read the store but must not write to it.
+     *
+     * @param store The open store the journal folds into.
+     * @return True on success, false if the journal is locked by another owner or cannot be opened.
+     */
+    bool open(ScoreStore& store);
+
+    /**
+     * @brief Commits and folds everything submitted, stops the threads and unlocks the journal.
+     */
+    void close();
+
+    /**
+     * @brief Checks whether the journal is open.
+     *
+     * @return True if open() succeeded and close() has not been called.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Queues a score. Does not wait for the disk.
+     *
+     * @param record The score; its sequence field is assigned here.
+     * @return The sequence number of the score.
+     */
+    std::uint32_t submit(ScoreRecord record);
+
+    /**
+     * @brief Waits until every score submitted so far is durable.
+     *
+     * @return True if they are all on disk, false if a write failed.
+     */
+    bool flush();
+
+    /**
+     * @brief Retrieves the number of scores recovered by open().
+     *
+     * @return The number of valid frames found in the journal.
+     */
+    std::size_t getRecovered() const;
+
+    /**
+     * @brief Retrieves the number of group commits so far.
+     *
+     * @return The number of fdatasync calls on the journal.
+     */
+    std::uint64_t getCommits() const;
+
+    /**
+     * @brief Retrieves the number of folds into the store so far.
+     *
+     * @return The number of compactions.
+     */
+    std::uint64_t getCompactions() const;
+
+    /**
+     * @brief Offers the scores of a journal owned by someone else to a leaderboard.
+     *
+     * Reads the valid frames without locking or changing the journal, and offers those that
+     * the owner has not folded into the store yet. The result is a snapshot.
+     *
+     * @param basePath Path of the store without extension.
+     * @param store The store the journal folds into, open for reading.
+     * @param board The leaderboard to fill.
+     * @return The number of scores offered.
+     */
+    static std::size_t loadUnfolded(const std::string& basePath, const ScoreStore& store, Leaderboard& board);
+
+private:
+    /**
+     * @brief One journal entry; a multiple of the sector size, so a torn write never splits two frames.
+     */
+    struct Frame {
+        std::uint32_t magic;    ///< Always kFrameMagic.
+        std::uint32_t crc;      ///< CRC-32 of the record and the padding.
+        ScoreRecord record;     ///< The score.
+        std::uint64_t reserved; ///< Padding to 64 bytes, always zero.
+    };
+
+    static_assert(sizeof(Frame) == 64, "ScoreJournal frames must stay 64 bytes");
+
+    static std::uint32_t checksum(const Frame& frame);
+    static std::vector<ScoreRecord> readFrames(int fd, off_t& validBytes);
+    void commitLoop();
+    void compactLoop();
+    void truncateIfFolded();
+
+    std::string path;                      ///< Path of the journal file.
+    std::size_t compactThreshold;          ///< Durable scores that trigger a fold.
+    std::chrono::milliseconds compactDelay; ///< Longest wait before a fold.
+    ScoreStore* store;                     ///< The store folded into; owned by the compactor while open.
+    int fd;                                ///< Locked journal file, or -1.
+    std::size_t recovered;                 ///< Frames found by open().
+
+    std::mutex fileMutex;                  ///< Held while the journal file is written or truncated.
+    std::mutex mutex;                      ///< Guards the members below.
+    std::condition_variable queuedChanged; ///< Wakes the committer.
+    std::condition_variable durableChanged; ///< Wakes flush() and the compactor.
+    std::vector<ScoreRecord> queued;       ///< Submitted, not yet written.
+    std::vector<ScoreRecord> durable;      ///< In the journal, not yet folded.
+    std::uint32_t nextSequence;            ///< Sequence of the next submitted score.
+    std::uint32_t durableSequence;         ///< Every score before this sequence has been committed.
+    bool writeFailed;                      ///< True once a journal write failed; later groups skip the journal.
+    bool foldFailed;                       ///< True once a fold failed; the journal is then never emptied.
+    bool committing;                       ///< True while the committer holds a group it has not committed.
+    bool stopping;                         ///< True while close() shuts the threads down.
+    std::thread committer;                 ///< Runs commitLoop().
+    std::thread compactor;                 ///< Runs compactLoop().
+    std::atomic<std::uint64_t> commits;    ///< Group commits so far.
+    std::atomic<std::uint64_t> compactions; ///< Folds so far.
+};
+
+#endif // SCOREJOURNAL_H
@@ -0,0 +1,66 @@
+#ifndef SCOREPROTOCOL_H
+#define SCOREPROTOCOL_H
+
+#include "ScoreStore.h"
+#include <cstdint>
+
+/**
+ * @namespace ScoreProtocol
+ * @brief Wire format between the ScoreClient and the whac-scored leaderboard daemon.
+ *
+ * Every message is a 16-byte FrameHeader followed by count ScoreRecords for Submit and
+ * TopReply frames, and by nothing for the others. Records travel in their on-disk layout, so
+ * the daemon appends a batch to its log without converting it. Client and daemon always run
+ * on the same machine, so the fields are in host byte order.
+ *
+ *   Submit     client -> daemon  count records; their sequence fields are ignored
+ *   SubmitAck  daemon -> client  count records are durable; value is the first sequence
+ *   Top        client -> daemon  count is the limit; flags carry kBestPerPlayer
+ *   TopReply   daemon -> client  count records, best first
+ *   Error      daemon -> client  the request was rejected
+ * @author Eseosa Emmanuel Atekha
+ */
+namespace ScoreProtocol {
+
+inline constexpr std::uint32_t kMagic = 0x31435357;      ///< "WSC1" in little-endian byte order.
+inline constexpr std::uint32_t kMaxRecords = 4096;       ///< Largest count accepted in one frame.
+inline constexpr std::uint16_t kBestPerPlayer = 1;       ///< Top flag: one entry per player.
+inline constexpr const char* kDefaultSocket = "/tmp/whac-scored.sock"; ///< Used unless WHAC_SCORE_SOCKET is set.
+
+/**
+ * @brief Kind of a frame.
+ */
+enum class Type : std::uint16_t { Submit = 1, SubmitAck = 2, Top = 3, TopReply = 4, Error = 5 };
+
+/**
+ * @struct FrameHeader
+ * @brief Start of every frame.
+ */
+struct FrameHeader {
+    std::uint32_t magic; ///< Always kMagic.
+    Type type;           ///< Kind of frame.
+    std::uint16_t flags; ///< Type-specific flags.
+    std::uint32_t count; ///< Number of records, or the limit of a Top request.
+    std::uint32_t value; ///< Type-specific value.
+};
+
+static_assert(sizeof(FrameHeader) == 16, "FrameHeader must stay 16 bytes");
+
+/**
+ * @brief Builds a header.
+ */
+inline FrameHeader makeHeader(Type type, std::uint32_t count, std::uint16_t flags = 0, std::uint32_t value = 0) {
+    return FrameHeader{kMagic, type, flags, count, value};
+}
+
+/**
+ * @brief Retrieves the number of payload bytes that follow a header.
+ */
+inline std::size_t payloadSize(const FrameHeader& header) {
+    bool hasRecords = header.type == Type::Submit || header.type == Type::TopReply;
+    return hasRecords ? header.count * sizeof(ScoreRecord) : 0;
+}
+
+} // namespace ScoreProtocol
+
+#endif // SCOREPROTOCOL_H
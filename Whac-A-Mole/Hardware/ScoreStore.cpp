@@ -0,0 +1,425 @@
+#include "ScoreStore.h"
+#include "Leaderboard.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+const char kLogMagic[8] = {'W', 'H', 'A', 'C', 'L', 'O', 'G', '1'};
+const char kIndexMagic[8] = {'W', 'H', 'A', 'C', 'I', 'D', 'X', '1'};
+const std::uint32_t kFormatVersion = 1;
+
+} // namespace
+
+/**
+ * @brief Retrieves the player name.
+ *
+ * @return The name as a std::string.
+ */
+std::string ScoreRecord::getName() const {
+    return std::string(name, strnlen(name, kNameLength));
+}
+
+/**
+ * @brief Builds a zero-padded record, truncating the name to fit.
+ *
+ * @param score The score achieved by the player.
+ * @param playerName The name of the player.
+ * @param sequence Position of the record in the log.
+ * @param reaction Reaction-time percentiles of the game.
+ * @return The record.
+ */
+ScoreRecord ScoreRecord::make(int score, const std::string& playerName, std::uint32_t sequence,
+                              const ReactionSummary& reaction) {
+    ScoreRecord record{};
+    record.score = score;
+    record.sequence = sequence;
+    record.reaction = reaction;
+    std::size_t length = std::min(playerName.size(), kNameLength - 1);
+    std::memcpy(record.name, playerName.data(), length);
+    return record;
+}
+
+/**
+ * @class ScoreStore
+ * @brief Stores scores in a binary log and keeps a sorted, memory-mapped top-N index.
+ * @author Eseosa Emmanuel Atekha
+ */
+ScoreStore::ScoreStore(const std::string& basePath, std::uint32_t indexCapacity)
+        : basePath(basePath), capacity(std::max<std::uint32_t>(1, indexCapacity)), logFd(-1), indexFd(-1),
+          indexMap(nullptr), indexMapSize(0), indexHeader(nullptr), indexEntries(nullptr), logRecords(0),
+          created(false), writable(true) {}
+
+/**
+ * @brief Destructor for ScoreStore.
+ */
+ScoreStore::~ScoreStore() {
+    close();
+}
+
+/**
+ * @brief Opens the log and maps the index, rebuilding the index if it is stale.
+ *
+ * A read-only store only opens the log.
+ *
+ * @param readOnly True to only read a store that someone else owns.
+ * @return True on success, false otherwise.
+ */
+bool ScoreStore::open(bool readOnly) {
+    if (isOpen()) {
+        return true;
+    }
+    writable = !readOnly;
+    if (!openLog() || (writable && !mapIndex())) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Unmaps the index and closes both files.
+ */
+void ScoreStore::close() {
+    if (indexMap) {
+        munmap(indexMap, indexMapSize);
+        indexMap = nullptr;
+        indexHeader = nullptr;
+        indexEntries = nullptr;
+    }
+    if (indexFd >= 0) {
+        ::close(indexFd);
+        indexFd = -1;
+    }
+    if (logFd >= 0) {
+        ::close(logFd);
+        logFd = -1;
+    }
+}
+
+/**
+ * @brief Checks whether the store is open.
+ *
+ * @return True if the store is open.
+ */
+bool ScoreStore::isOpen() const {
+    return writable ? indexMap != nullptr : logFd >= 0;
+}
+
+/**
+ * @brief Checks whether open() created a new log.
+ *
+ * @return True if the log was created.
+ */
+bool ScoreStore::wasCreated() const {
+    return created;
+}
+
+/**
+ * @brief Appends a score to the log and inserts it into the index.
+ *
+ * The log is written first, so a crash between the two writes leaves an index that is
+ * detected as stale and rebuilt on the next open().
+ *
+ * @param score The score achieved by the player.
+ * @param playerName The name of the player.
+ * @param reaction Reaction-time percentiles of the game.
+ * @return True if the record was written.
+ */
+bool ScoreStore::append(int score, const std::string& playerName, const ReactionSummary& reaction) {
+    if (!isOpen() || !writable) {
+        return false;
+    }
+    ScoreRecord record = ScoreRecord::make(score, playerName, static_cast<std::uint32_t>(logRecords), reaction);
+    if (write(logFd, &record, sizeof(record)) != static_cast<ssize_t>(sizeof(record))) {
+        std::cerr << "Unable to write to " << basePath << ".log" << std::endl;
+        return false;
+    }
+    ++logRecords;
+    insertIntoIndex(record);
+    indexHeader->logRecords = logRecords;
+    return true;
+}
+
+/**
+ * @brief Appends several records to the log with one write and updates the index.
+ *
+ * @param records The records; their sequence fields are overwritten.
+ * @param count Number of records.
+ * @return True if every record was written, false otherwise.
+ */
+bool ScoreStore::append(ScoreRecord* records, std::size_t count) {
+    if (!isOpen() || !writable) {
+        return false;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        records[i].sequence = static_cast<std::uint32_t>(logRecords + i);
+    }
+    auto bytes = static_cast<ssize_t>(count * sizeof(ScoreRecord));
+    if (write(logFd, records, static_cast<std::size_t>(bytes)) != bytes) {
+        std::cerr << "Unable to write to " << basePath << ".log" << std::endl;
+        return false;
+    }
+    logRecords += count;
+    for (std::size_t i = 0; i < count; ++i) {
+        insertIntoIndex(records[i]);
+    }
+    indexHeader->logRecords = logRecords;
+    return true;
+}
+
+/**
+ * @brief Makes the appended records durable.
+ *
+ * @return True on success.
+ */
+bool ScoreStore::sync() {
+    if (!isOpen() || !writable || fdatasync(logFd) != 0) {
+        std::cerr << "Unable to sync " << basePath << ".log" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Drops the records at and after a position of the log and rebuilds the index.
+ *
+ * @param count Number of records to keep.
+ * @return True on success.
+ */
+bool ScoreStore::truncate(std::size_t count) {
+    if (!isOpen() || !writable || count >= logRecords) {
+        return isOpen() && writable;
+    }
+    if (ftruncate(logFd, static_cast<off_t>(sizeof(LogHeader) + count * sizeof(ScoreRecord))) < 0) {
+        std::cerr << "Unable to truncate " << basePath << ".log" << std::endl;
+        return false;
+    }
+    logRecords = count;
+    return rebuildIndex();
+}
+
+/**
+ * @brief Imports a legacy text score file.
+ *
+ * All scores are appended with a single write and the index is rebuilt once.
+ *
+ * @param textPath Path to the text file.
+ * @return The number of imported scores.
+ */
+std::size_t ScoreStore::importText(const std::string& textPath) {
+    std::ifstream inputFile(textPath);
+    if (!isOpen() || !writable || !inputFile.is_open()) {
+        return 0;
+    }
+    std::vector<ScoreRecord> records;
+    std::string line;
+    while (std::getline(inputFile, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        int score;
+        if (fields >> name >> score) {
+            records.push_back(ScoreRecord::make(score, name, static_cast<std::uint32_t>(logRecords + records.size())));
+        }
+    }
+    if (records.empty()) {
+        return 0;
+    }
+    auto bytes = static_cast<ssize_t>(records.size() * sizeof(ScoreRecord));
+    if (write(logFd, records.data(), bytes) != bytes) {
+        std::cerr << "Unable to import " << textPath << std::endl;
+        return 0;
+    }
+    logRecords += records.size();
+    rebuildIndex();
+    return records.size();
+}
+
+/**
+ * @brief Retrieves the number of scores in the log.
+ *
+ * @return The number of records.
+ */
+std::size_t ScoreStore::size() const {
+    return static_cast<std::size_t>(logRecords);
+}
+
+/**
+ * @brief Retrieves the number of scores in the index.
+ *
+ * @return The number of indexed records.
+ */
+std::size_t ScoreStore::topCount() const {
+    return indexHeader ? indexHeader->count : 0;
+}
+
+/**
+ * @brief Retrieves the best scores, best first.
+ *
+ * @return Pointer to the sorted records in the mapped index.
+ */
+const ScoreRecord* ScoreStore::top() const {
+    return indexEntries;
+}
+
+/**
+ * @brief Opens or creates the log and counts its records.
+ *
+ * A partial record left by an interrupted write is cut off. A read-only store ignores it,
+ * since the owner may still be writing it.
+ */
+bool ScoreStore::openLog() {
+    std::string path = basePath + ".log";
+    logFd = writable ? ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644)
+                     : ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (logFd < 0) {
+        // A reader that comes before the owner has created the log has nothing to read yet
+        if (writable || errno != ENOENT) {
+            std::cerr << "Unable to open " << path << std::endl;
+        }
+        return false;
+    }
+    struct stat info;
+    fstat(logFd, &info);
+    if (!writable && info.st_size < static_cast<off_t>(sizeof(LogHeader))) {
+        logRecords = 0;
+        return true;
+    }
+    created = info.st_size == 0;
+    if (created) {
+        LogHeader header{};
+        std::memcpy(header.magic, kLogMagic, sizeof(kLogMagic));
+        header.version = kFormatVersion;
+        header.recordSize = sizeof(ScoreRecord);
+        if (write(logFd, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header))) {
+            std::cerr << "Unable to write to " << path << std::endl;
+            return false;
+        }
+        logRecords = 0;
+        return true;
+    }
+    LogHeader header{};
+    if (pread(logFd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+        || std::memcmp(header.magic, kLogMagic, sizeof(kLogMagic)) != 0) {
+        std::cerr << path << " is not a score log." << std::endl;
+        return false;
+    }
+    if (header.version != kFormatVersion || header.recordSize != sizeof(ScoreRecord)) {
+        std::cerr << path << " has an unsupported format version." << std::endl;
+        return false;
+    }
+    logRecords = (static_cast<std::uint64_t>(info.st_size) - sizeof(LogHeader)) / sizeof(ScoreRecord);
+    off_t whole = static_cast<off_t>(sizeof(LogHeader) + logRecords * sizeof(ScoreRecord));
+    if (writable && whole != info.st_size && ftruncate(logFd, whole) < 0) {
+        std::cerr << "Unable to repair " << path << std::endl;
+    }
+    return true;
+}
+
+/**
+ * @brief Maps the index file, sizing it and rebuilding it when needed.
+ */
+bool ScoreStore::mapIndex() {
+    std::string path = basePath + ".idx";
+    indexFd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (indexFd < 0) {
+        std::cerr << "Unable to open " << path << std::endl;
+        return false;
+    }
+    indexMapSize = sizeof(IndexHeader) + static_cast<std::size_t>(capacity) * sizeof(ScoreRecord);
+    struct stat info;
+    fstat(indexFd, &info);
+    if (static_cast<std::size_t>(info.st_size) != indexMapSize && ftruncate(indexFd, indexMapSize) < 0) {
+        std::cerr << "Unable to resize " << path << std::endl;
+        return false;
+    }
+    indexMap = mmap(nullptr, indexMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, indexFd, 0);
+    if (indexMap == MAP_FAILED) {
+        indexMap = nullptr;
+        std::cerr << "Unable to map " << path << std::endl;
+        return false;
+    }
+    indexHeader = static_cast<IndexHeader*>(indexMap);
+    indexEntries = reinterpret_cast<ScoreRecord*>(static_cast<char*>(indexMap) + sizeof(IndexHeader));
+    bool current = std::memcmp(indexHeader->magic, kIndexMagic, sizeof(kIndexMagic)) == 0
+                   && indexHeader->version == kFormatVersion
+                   && indexHeader->capacity == capacity
+                   && indexHeader->logRecords == logRecords;
+    return current || rebuildIndex();
+}
+
+/**
+ * @brief Offers every record in the log to a leaderboard.
+ *
+ * @param board The leaderboard to fill.
+ * @return The number of records read.
+ */
+std::size_t ScoreStore::load(Leaderboard& board) const {
+    std::vector<ScoreRecord> chunk(4096);
+    off_t offset = sizeof(LogHeader);
+    std::size_t total = 0;
+    for (std::uint64_t remaining = logRecords; remaining > 0;) {
+        std::size_t wanted = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, chunk.size()));
+        ssize_t got = pread(logFd, chunk.data(), wanted * sizeof(ScoreRecord), offset);
+        if (got <= 0) {
+            break;
+        }
+        std::size_t records = static_cast<std::size_t>(got) / sizeof(ScoreRecord);
+        for (std::size_t i = 0; i < records; ++i) {
+            board.offer(chunk[i]);
+        }
+        offset += static_cast<off_t>(records * sizeof(ScoreRecord));
+        remaining -= records;
+        total += records;
+    }
+    return total;
+}
+
+/**
+ * @brief Recomputes the index from the whole log.
+ *
+ * The log is streamed through a Leaderboard of the index capacity, so the rebuild is
+ * linear in the size of the log and needs memory proportional to the index only.
+ */
+bool ScoreStore::rebuildIndex() {
+    Leaderboard board(capacity);
+    load(board);
+
+    std::memcpy(indexHeader->magic, kIndexMagic, sizeof(kIndexMagic));
+    indexHeader->version = kFormatVersion;
+    indexHeader->capacity = capacity;
+    indexHeader->count = static_cast<std::uint32_t>(board.size());
+    indexHeader->reserved = 0;
+    std::copy(board.begin(), board.end(), indexEntries);
+    indexHeader->logRecords = logRecords;
+    return true;
+}
+
+/**
+ * @brief Inserts a record into the sorted index, dropping the worst entry if it is full.
+ */
+void ScoreStore::insertIntoIndex(const ScoreRecord& record) {
+    std::uint32_t count = indexHeader->count;
+    if (count == capacity && !record.isBetterThan(indexEntries[count - 1])) {
+        return;
+    }
+    ScoreRecord* end = indexEntries + count;
+    ScoreRecord* position = std::upper_bound(indexEntries, end, record,
+                                              [](const ScoreRecord& a, const ScoreRecord& b) { return a.isBetterThan(b); });
+    if (count == capacity) {
+        --end;
+    } else {
+        ++indexHeader->count;
+    }
+    std::memmove(position + 1, position, static_cast<std::size_t>(end - position) * sizeof(ScoreRecord));
+    *position = record;
+}
@@ -0,0 +1,245 @@
+#ifndef SCORESTORE_H
+#define SCORESTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "LatencyHistogram.h"
+
+class Leaderboard;
+
+/**
+ * @struct ScoreRecord
+ * @brief One fixed-size score entry as stored on disk.
+ *
+ * Records are 48 bytes so the log can be addressed by index and the index can be
+ * read straight out of the mapped file without parsing. Besides the score, a record keeps
+ * the player's reaction-time percentiles for the game.
+ */
+struct ScoreRecord {
+    static constexpr std::size_t kNameLength = 24; ///< Bytes reserved for the name, including the terminator.
+
+    std::int32_t score;      ///< The score achieved.
+    std::uint32_t sequence;  ///< Position of the record in the log; earlier scores win ties.
+    char name[kNameLength];  ///< Player name, NUL terminated and truncated to 23 bytes.
+    ReactionSummary reaction; ///< Reaction-time percentiles of the game; all zero if not measured.
+
+    /**
+     * @brief Retrieves the player name.
+     *
+     * @return The name as a std::string.
+     */
+    std::string getName() const;
+
+    /**
+     * @brief Checks whether this record ranks above another one.
+     *
+     * Higher scores rank first; equal scores are ordered by submission, earliest first.
+     *
+     * @param other The record to compare with.
+     * @return True if this record ranks above @p other.
+     */
+    bool isBetterThan(const ScoreRecord& other) const {
+        return score != other.score ? score > other.score : sequence < other.sequence;
+    }
+
+    /**
+     * @brief Builds a zero-padded record, truncating the name to fit.
+     *
+     * @param score The score achieved by the player.
+     * @param playerName The name of the player.
+     * @param sequence Position of the record in the log.
+     * @param reaction Reaction-time percentiles of the game.
+     * @return The record.
+     */
+    static ScoreRecord make(int score, const std::string& playerName, std::uint32_t sequence,
+                            const ReactionSummary& reaction = ReactionSummary{});
+};
+
+static_assert(sizeof(ScoreRecord) == 48, "ScoreRecord must stay 48 bytes");
+
+/**
+ * @class ScoreStore
+ * @brief Compact binary score storage: an append-only log plus a persisted top-N index.
+ *
+ * Every score ever submitted is appended to "<base>.log". The best scores are kept,
+ * sorted, in "<base>.idx", which is opened with a single mmap, so reading the top ten is
+ * ten array reads and no parsing. The index is updated in place on every append and is
+ * rebuilt from the log if it is missing or out of date.
+ *
+ * Only one owner may write to a store at a time; ScoreJournal's lock decides which. Everyone
+ * else opens the store read-only and reads the log, never the index the owner is updating.
+ * @author Eseosa Emmanuel Atekha
+ */
+class ScoreStore {
+public:
+    /**
+     * @brief Constructor for ScoreStore.
+     *
+     * @param basePath Path of the store without extension, for example "highScores".
+     * @param indexCapacity Number of top scores kept in the index.
+     */
+    explicit ScoreStore(const std::string& basePath, std::uint32_t indexCapacity = 1000);
+
+    /**
+     * @brief Destructor for ScoreStore. Unmaps the index and closes the files.
+     */
+    ~ScoreStore();
+
+    ScoreStore(const ScoreStore&) = delete;
+    ScoreStore& operator=(const ScoreStore&) = delete;
+
+    /**
+     * @brief Opens the store, creating the files if they do not exist.
+     *
+     * A read-only store creates, repairs and rebuilds nothing and does not map the index, so
+     * topCount() is zero and every write fails; load() reads the records the log held at open().
+     *
+     * @param readOnly True to only read a store that someone else owns.
+     * @return True on success, false if a file cannot be opened or mapped.
+     */
+    bool open(bool readOnly = false);
+
+    /**
+     * @brief Unmaps the index and closes the files.
+     */
+    void close();
+
+    /**
+     * @brief Checks whether the store is open.
+     *
+     * @return True if open() succeeded and close() has not been called.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Checks whether open() had to create a new, empty log.
+     *
+     * @return True if the log did not exist before open().
+     */
+    bool wasCreated() const;
+
+    /**
+     * @brief Appends a score to the log and updates the index.
+     *
+     * @param score The score achieved by the player.
+     * @param playerName The name of the player; truncated to 23 bytes.
+     * @param reaction Reaction-time percentiles of the game.
+     * @return True if the record was written, false otherwise.
+     */
+    bool append(int score, const std::string& playerName, const ReactionSummary& reaction = ReactionSummary{});
+
+    /**
+     * @brief Appends several records to the log with one write and updates the index.
+     *
+     * The sequence numbers of the records are assigned by the store.
+     *
+     * @param records The records; their sequence fields are overwritten.
+     * @param count Number of records.
+     * @return True if every record was written, false otherwise.
+     */
+    bool append(ScoreRecord* records, std::size_t count);
+
+    /**
+     * @brief Makes the appended records durable.
+     *
+     * Only the log is synced; an index that is behind the log is rebuilt on the next open().
+     *
+     * @return True on success.
+     */
+    bool sync();
+
+    /**
+     * @brief Drops the records at and after a position of the log and rebuilds the index.
+     *
+     * Used by ScoreJournal recovery to undo a fold that a crash interrupted.
+     *
+     * @param count Number of records to keep.
+     * @return True on success.
+     */
+    bool truncate(std::size_t count);
+
+    /**
+     * @brief Imports the "name score" lines of a legacy highScores.txt file.
+     *
+     * Lines without a name are skipped.
+     *
+     * @param textPath Path to the text file.
+     * @return The number of imported scores.
+     */
+    std::size_t importText(const std::string& textPath);
+
+    /**
+     * @brief Retrieves the number of scores in the log.
+     *
+     * @return The number of records ever appended.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Retrieves the number of scores in the index.
+     *
+     * @return At most the index capacity.
+     */
+    std::size_t topCount() const;
+
+    /**
+     * @brief Retrieves the best scores, best first.
+     *
+     * The pointer refers to the mapped index and stays valid until the next append() or close().
+     *
+     * @return Pointer to topCount() records sorted by descending score.
+     */
+    const ScoreRecord* top() const;
+
+    /**
+     * @brief Offers every record in the log to a leaderboard.
+     *
+     * The log is read in large chunks; memory use does not depend on the size of the log.
+     *
+     * @param board The leaderboard to fill.
+     * @return The number of records read.
+     */
+    std::size_t load(Leaderboard& board) const;
+
+private:
+    /**
+     * @brief Header at the start of the log file.
+     */
+    struct LogHeader {
+        char magic[8];            ///< "WHACLOG1".
+        std::uint32_t version;    ///< Format version.
+        std::uint32_t recordSize; ///< sizeof(ScoreRecord).
+    };
+
+    /**
+     * @brief Header at the start of the mapped index file.
+     */
+    struct IndexHeader {
+        char magic[8];            ///< "WHACIDX1".
+        std::uint32_t version;    ///< Format version.
+        std::uint32_t capacity;   ///< Number of record slots after the header.
+        std::uint32_t count;      ///< Number of slots in use.
+        std::uint32_t reserved;   ///< Padding, always zero.
+        std::uint64_t logRecords; ///< Number of log records the index reflects.
+    };
+
+    bool openLog();
+    bool mapIndex();
+    bool rebuildIndex();
+    void insertIntoIndex(const ScoreRecord& record);
+
+    std::string basePath;       ///< Path of the store without extension.
+    std::uint32_t capacity;     ///< Number of top scores kept in the index.
+    int logFd;                  ///< Append-only log, or -1.
+    int indexFd;                ///< Index file, or -1.
+    void* indexMap;             ///< Mapping of the whole index file.
+    std::size_t indexMapSize;   ///< Size of the mapping in bytes.
+    IndexHeader* indexHeader;   ///< Header inside the mapping.
+    ScoreRecord* indexEntries;  ///< Sorted records inside the mapping.
+    std::uint64_t logRecords;   ///< Number of records in the log.
+    bool created;               ///< True if open() created the log.
+    bool writable;              ///< False if the store was opened read-only.
+};
+
+#endif // SCORESTORE_H
@@ -0,0 +1,281 @@
+#include "SimulatedGpioBackend.h"
+
+/**
+ * @class SimulatedGpioBackend
+ * @brief Keeps pin levels in memory and logs their transitions.
+ * @author Anubhav Aery
+ */
+SimulatedGpioBackend::SimulatedGpioBackend()
+        : levels(0), outputs(0), recording(true), registerWrites(0), transitions(), wave(), wavePosition(0),
+          waveNextAt(), wavesSent(0), pwm(), pwmWrites(0), watchedPins(0), edgeHandler(nullptr), edgeContext(nullptr) {}
+
+/**
+ * @brief Always succeeds; the simulated board needs no initialisation.
+ *
+ * @return True.
+ */
+bool SimulatedGpioBackend::initialise() {
+    return true;
+}
+
+/**
+ * @brief Does nothing; the simulated board holds no resources.
+ */
+void SimulatedGpioBackend::terminate() {}
+
+/**
+ * @brief Marks a pin as an output.
+ *
+ * @param pin The GPIO pin number.
+ */
+void SimulatedGpioBackend::setOutput(int pin) {
+    outputs |= 1u << pin;
+    ++registerWrites;
+}
+
+/**
+ * @brief Drives a single pin.
+ *
+ * Like gpioWrite(), stops the PWM of the pin.
+ *
+ * @param pin The GPIO pin number.
+ * @param level 1 for high, 0 for low.
+ */
+void SimulatedGpioBackend::write(int pin, int level) {
+    auto now = std::chrono::steady_clock::now();
+    replayWave(now);
+    std::uint32_t bit = 1u << pin;
+    pwm[pin] = 0;
+    ++registerWrites;
+    apply(level ? bit : 0, level ? 0 : bit, now);
+}
+
+/**
+ * @brief Drives several pins with one write per non-empty mask.
+ *
+ * @param setMask Pins to drive high.
+ * @param clearMask Pins to drive low.
+ */
+void SimulatedGpioBackend::writeBank(std::uint32_t setMask, std::uint32_t clearMask) {
+    auto now = std::chrono::steady_clock::now();
+    replayWave(now);
+    registerWrites += (setMask != 0) + (clearMask != 0);
+    apply(setMask, clearMask, now);
+}
+
+/**
+ * @brief Reports that waveforms are replayed.
+ *
+ * @return True.
+ */
+bool SimulatedGpioBackend::supportsWaves() const {
+    return true;
+}
+
+/**
+ * @brief Starts replaying a pulse list.
+ *
+ * The wave starts now and its first pulse is applied at once. Pulses applied by the wave
+ * are not counted as register writes, as the CPU does not make them.
+ *
+ * @param pulses The steps, in order.
+ * @param count Number of pulses.
+ * @return True.
+ */
+bool SimulatedGpioBackend::sendWave(const GpioPulse* pulses, std::size_t count) {
+    auto now = std::chrono::steady_clock::now();
+    cancelWave();
+    wave.assign(pulses, pulses + count);
+    wavePosition = 0;
+    waveNextAt = now;
+    ++wavesSent;
+    replayWave(now);
+    return true;
+}
+
+/**
+ * @brief Replays the wave up to now and drops its remaining pulses.
+ */
+void SimulatedGpioBackend::cancelWave() {
+    replayWave(std::chrono::steady_clock::now());
+    wave.clear();
+    wavePosition = 0;
+}
+
+/**
+ * @brief Applies every pulse of the wave that starts by a given time, each at its own start time.
+ *
+ * @param until Time up to which the DMA engine would have run.
+ */
+void SimulatedGpioBackend::replayWave(std::chrono::steady_clock::time_point until) {
+    while (wavePosition < wave.size() && waveNextAt <= until) {
+        const GpioPulse& pulse = wave[wavePosition++];
+        apply(pulse.setMask, pulse.clearMask, waveNextAt);
+        waveNextAt += std::chrono::microseconds(pulse.delayUs);
+    }
+}
+
+/**
+ * @brief Reports that pins can be dimmed.
+ *
+ * @return True.
+ */
+bool SimulatedGpioBackend::supportsPwm() const {
+    return true;
+}
+
+/**
+ * @brief Sets the duty cycle of a pin and logs it as high or low.
+ *
+ * @param pin The GPIO pin number.
+ * @param duty The duty cycle, out of 255.
+ */
+void SimulatedGpioBackend::setPwm(int pin, std::uint8_t duty) {
+    auto now = std::chrono::steady_clock::now();
+    replayWave(now);
+    std::uint32_t bit = 1u << pin;
+    pwm[pin] = duty;
+    ++pwmWrites;
+    apply(duty ? bit : 0, duty ? 0 : bit, now);
+}
+
+/**
+ * @brief Retrieves the duty cycle of a pin.
+ *
+ * @param pin The GPIO pin number.
+ * @return The last duty cycle set, or 0.
+ */
+std::uint8_t SimulatedGpioBackend::getPwm(int pin) const {
+    return pwm[pin];
+}
+
+/**
+ * @brief Retrieves the number of duty cycle changes.
+ *
+ * @return The number of setPwm() calls.
+ */
+std::uint64_t SimulatedGpioBackend::getPwmWrites() const {
+    return pwmWrites;
+}
+
+/**
+ * @brief Reports that input pins can be watched.
+ *
+ * @return True.
+ */
+bool SimulatedGpioBackend::supportsEdges() const {
+    return true;
+}
+
+/**
+ * @brief Keeps the handler of the watched pins.
+ *
+ * @param pins Pins to watch.
+ * @param handler Receives the injected edges.
+ * @param context Passed to the handler.
+ * @return True.
+ */
+bool SimulatedGpioBackend::watchEdges(std::uint32_t pins, GpioEdgeHandler handler, void* context) {
+    std::lock_guard<std::mutex> lock(edgeMutex);
+    watchedPins = pins;
+    edgeHandler = handler;
+    edgeContext = context;
+    return true;
+}
+
+/**
+ * @brief Hands an edge of a watched pin to the handler.
+ *
+ * @param pin The GPIO pin number.
+ * @param level The new level.
+ * @param at When the pin changed.
+ */
+void SimulatedGpioBackend::injectEdge(int pin, int level, std::chrono::steady_clock::time_point at) {
+    std::lock_guard<std::mutex> lock(edgeMutex);
+    if (edgeHandler && (watchedPins & (1u << pin))) {
+        edgeHandler(GpioEdge{at, pin, level}, edgeContext);
+    }
+}
+
+/**
+ * @brief Retrieves the number of waves started.
+ *
+ * @return The number of sendWave() calls.
+ */
+std::uint64_t SimulatedGpioBackend::getWavesSent() const {
+    return wavesSent;
+}
+
+/**
+ * @brief Updates the pin levels and logs the pins whose level changed.
+ *
+ * @param setMask Pins to drive high.
+ * @param clearMask Pins to drive low.
+ * @param time Time of the change, logged with each transition.
+ */
+void SimulatedGpioBackend::apply(std::uint32_t setMask, std::uint32_t clearMask,
+                                 std::chrono::steady_clock::time_point time) {
+    std::uint32_t next = (levels & ~clearMask) | setMask;
+    std::uint32_t changed = next ^ levels;
+    levels = next;
+    if (!recording || changed == 0) {
+        return;
+    }
+    for (int pin = 0; changed != 0; ++pin, changed >>= 1) {
+        if (changed & 1u) {
+            transitions.push_back({time, pin, static_cast<int>((next >> pin) & 1u)});
+        }
+    }
+}
+
+/**
+ * @brief Enables or disables recording of transitions.
+ *
+ * @param enabled True to record transitions.
+ */
+void SimulatedGpioBackend::setRecording(bool enabled) {
+    recording = enabled;
+}
+
+/**
+ * @brief Retrieves the current level of every pin.
+ *
+ * @return Bit n is the level of GPIO n.
+ */
+std::uint32_t SimulatedGpioBackend::getLevels() const {
+    return levels;
+}
+
+/**
+ * @brief Retrieves the pins configured as outputs.
+ *
+ * @return Bit n is set if GPIO n is an output.
+ */
+std::uint32_t SimulatedGpioBackend::getOutputs() const {
+    return outputs;
+}
+
+/**
+ * @brief Retrieves the transition log.
+ *
+ * @return Every recorded transition, oldest first.
+ */
+const std::vector<PinTransition>& SimulatedGpioBackend::getTransitions() const {
+    return transitions;
+}
+
+/**
+ * @brief Empties the transition log.
+ */
+void SimulatedGpioBackend::clearTransitions() {
+    transitions.clear();
+}
+
+/**
+ * @brief Retrieves the number of register writes.
+ *
+ * @return The number of register writes.
+ */
+std::uint64_t SimulatedGpioBackend::getRegisterWrites() const {
+    return registerWrites;
+}
@@ -0,0 +1,214 @@
+#ifndef SIMULATEDGPIOBACKEND_H
+#define SIMULATEDGPIOBACKEND_H
+
+#include "GpioBackend.h"
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @struct PinTransition
+ * @brief A level change recorded by the SimulatedGpioBackend.
+ */
+struct PinTransition {
+    std::chrono::steady_clock::time_point time; ///< When the pin changed.
+    int pin;   ///< The GPIO pin number.
+    int level; ///< The new level, 1 for high and 0 for low.
+};
+
+/**
+ * @class SimulatedGpioBackend
+ * @brief In-process board that records every pin transition with a timestamp.
+ *
+ * Needs no hardware and no root, so the whole game loop can run, be tested and be
+ * benchmarked on an ordinary machine. Transitions of all pins written together carry
+ * the same timestamp, mirroring a single register write.
+ *
+ * Waveforms are replayed from their pulse list: each pulse is applied at the time the DMA
+ * engine would apply it, the start of the wave plus the delays of the pulses before it,
+ * and its transitions are logged with that time rather than the time of the replay. The
+ * wave is replayed up to the current time before every write, and up to any time by
+ * replayWave(), so the log shows exactly when a real board would have changed its pins.
+ *
+ * PWM is not simulated pulse by pulse: the duty cycle of each pin is kept, and a pin with a
+ * duty cycle above 0 counts as high.
+ *
+ * Watched input pins change only when the caller calls injectEdge(), which hands the edge
+ * to the handler on the calling thread, as pigpio's alert thread would.
+ * @author Anubhav Aery
+ */
+class SimulatedGpioBackend : public GpioBackend {
+public:
+    /**
+     * @brief Constructor for SimulatedGpioBackend.
+     *
+     * Starts with every pin low and an empty transition log.
+     */
+    SimulatedGpioBackend();
+
+    bool initialise() override;
+    void terminate() override;
+    void setOutput(int pin) override;
+    void write(int pin, int level) override;
+    void writeBank(std::uint32_t setMask, std::uint32_t clearMask) override;
+    bool supportsWaves() const override;
+
+    /**
+     * @brief Starts replaying a pulse list, as pigpio transmits a one-shot wave.
+     *
+     * The previous wave is replayed up to now and its remaining pulses are dropped.
+     *
+     * @param pulses The steps, in order; the first one is applied immediately.
+     * @param count Number of pulses.
+     * @return True.
+     */
+    bool sendWave(const GpioPulse* pulses, std::size_t count) override;
+
+    /**
+     * @brief Replays the wave up to now and drops its remaining pulses.
+     */
+    void cancelWave() override;
+
+    /**
+     * @brief Applies every pulse of the wave that starts by a given time.
+     *
+     * getLevels() and getTransitions() reflect the wave up to the last replay.
+     *
+     * @param until Time up to which the DMA engine would have run.
+     */
+    void replayWave(std::chrono::steady_clock::time_point until);
+
+    /**
+     * @brief Reports that pins can be dimmed.
+     *
+     * @return True.
+     */
+    bool supportsPwm() const override;
+
+    /**
+     * @brief Sets the duty cycle of a pin.
+     *
+     * The pin is logged as high while the duty cycle is above 0. Duty cycle changes are
+     * not register writes; they are counted by getPwmWrites().
+     *
+     * @param pin The GPIO pin number.
+     * @param duty The duty cycle, out of 255.
+     */
+    void setPwm(int pin, std::uint8_t duty) override;
+
+    /**
+     * @brief Retrieves the duty cycle of a pin.
+     *
+     * @param pin The GPIO pin number.
+     * @return The last duty cycle set, or 0.
+     */
+    std::uint8_t getPwm(int pin) const;
+
+    /**
+     * @brief Retrieves the number of duty cycle changes.
+     *
+     * @return The number of setPwm() calls.
+     */
+    std::uint64_t getPwmWrites() const;
+
+    /**
+     * @brief Reports that input pins can be watched.
+     *
+     * @return True.
+     */
+    bool supportsEdges() const override;
+
+    /**
+     * @brief Keeps the handler of the watched pins.
+     *
+     * Waits for an injectEdge() on another thread that is still calling the previous handler.
+     *
+     * @param pins Pins to watch.
+     * @param handler Receives the edges passed to injectEdge().
+     * @param context Passed to the handler.
+     * @return True.
+     */
+    bool watchEdges(std::uint32_t pins, GpioEdgeHandler handler, void* context) override;
+
+    /**
+     * @brief Simulates an edge on an input pin, as a button press or release.
+     *
+     * May be called from any thread, like the edges of a real backend.
+     *
+     * @param pin The GPIO pin number; edges on pins not watched are dropped.
+     * @param level The new level; a pressed button reads 0.
+     * @param at When the pin changed.
+     */
+    void injectEdge(int pin, int level, std::chrono::steady_clock::time_point at);
+
+    /**
+     * @brief Retrieves the number of waves started.
+     *
+     * @return The number of sendWave() calls.
+     */
+    std::uint64_t getWavesSent() const;
+
+    /**
+     * @brief Enables or disables recording of transitions.
+     *
+     * Long load tests can disable recording and still observe the pin levels.
+     *
+     * @param enabled True to record transitions.
+     */
+    void setRecording(bool enabled);
+
+    /**
+     * @brief Retrieves the current level of every pin.
+     *
+     * @return Bit n is the level of GPIO n.
+     */
+    std::uint32_t getLevels() const;
+
+    /**
+     * @brief Retrieves the pins configured as outputs.
+     *
+     * @return Bit n is set if GPIO n is an output.
+     */
+    std::uint32_t getOutputs() const;
+
+    /**
+     * @brief Retrieves every recorded transition, oldest first.
+     *
+     * @return The transition log.
+     */
+    const std::vector<PinTransition>& getTransitions() const;
+
+    /**
+     * @brief Empties the transition log.
+     */
+    void clearTransitions();
+
+    /**
+     * @brief Retrieves the number of register writes the real board would have seen.
+     *
+     * @return The number of register writes.
+     */
+    std::uint64_t getRegisterWrites() const;
+
+private:
+    void apply(std::uint32_t setMask, std::uint32_t clearMask, std::chrono::steady_clock::time_point time);
+
+    std::uint32_t levels;  ///< Current level of every pin.
+    std::uint32_t outputs; ///< Pins configured as outputs.
+    bool recording;        ///< True if transitions are logged.
+    std::uint64_t registerWrites; ///< Register writes so far.
+    std::vector<PinTransition> transitions; ///< Transition log.
+    std::vector<GpioPulse> wave;            ///< Pulses of the wave being replayed.
+    std::size_t wavePosition;               ///< Next pulse of the wave to apply.
+    std::chrono::steady_clock::time_point waveNextAt; ///< Start time of that pulse.
+    std::uint64_t wavesSent;                ///< Waves started so far.
+    std::uint8_t pwm[32];                   ///< Duty cycle of every pin.
+    std::uint64_t pwmWrites;                ///< setPwm() calls so far.
+    std::mutex edgeMutex;                   ///< Guards the three members below while an edge is delivered.
+    std::uint32_t watchedPins;              ///< Input pins passed to watchEdges().
+    GpioEdgeHandler edgeHandler;            ///< Receives the injected edges.
+    void* edgeContext;                      ///< Passed to edgeHandler.
+};
+
+#endif // SIMULATEDGPIOBACKEND_H
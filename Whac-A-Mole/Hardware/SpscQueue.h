@@ -0,0 +1,100 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @class SpscQueue
+ * @brief Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * The elements live in a fixed ring inside the object, so pushing and popping never
+ * allocate. The producer only writes the tail index and the consumer only writes the head
+ * index; each side keeps a cached copy of the other side's index and only reloads it when
+ * the ring looks full or empty, so in the common case an operation touches no cache line
+ * owned by the other thread. The two indices sit on separate cache lines for the same reason.
+ *
+ * @tparam T Element type; must be trivially copyable.
+ * @tparam Capacity Number of slots; a power of two. One slot is never used.
+ * @author Anubhav Aery
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "SpscQueue elements must be trivially copyable");
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Appends an element. Producer thread only.
+     *
+     * @param value The element to append.
+     * @return True if the element was queued, false if the queue is full.
+     */
+    bool tryPush(const T& value) {
+        const std::size_t tail = tailIndex.load(std::memory_order_relaxed);
+        const std::size_t next = (tail + 1) & kMask;
+        if (next == cachedHead) {
+            cachedHead = headIndex.load(std::memory_order_acquire);
+            if (next == cachedHead) {
+                return false;
+            }
+        }
+        ring[tail] = value;
+        tailIndex.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element. Consumer thread only.
+     *
+     * @param value Receives the element.
+     * @return True if an element was removed, false if the queue is empty.
+     */
+    bool tryPop(T& value) {
+        const std::size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == cachedTail) {
+            cachedTail = tailIndex.load(std::memory_order_acquire);
+            if (head == cachedTail) {
+                return false;
+            }
+        }
+        value = ring[head];
+        headIndex.store((head + 1) & kMask, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Checks whether the queue is empty. Exact only on the consumer thread.
+     *
+     * @return True if no element is queued.
+     */
+    bool empty() const {
+        return headIndex.load(std::memory_order_acquire) == tailIndex.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Retrieves the number of elements the queue can hold.
+     *
+     * @return Capacity - 1.
+     */
+    static constexpr std::size_t capacity() {
+        return Capacity - 1;
+    }
+
+private:
+    static constexpr std::size_t kMask = Capacity - 1;
+    static constexpr std::size_t kCacheLine = 64;
+
+    alignas(kCacheLine) std::atomic<std::size_t> headIndex{0}; ///< Next slot to read, written by the consumer.
+    std::size_t cachedTail = 0;                                ///< Consumer's copy of tailIndex.
+    alignas(kCacheLine) std::atomic<std::size_t> tailIndex{0}; ///< Next slot to write, written by the producer.
+    std::size_t cachedHead = 0;                                ///< Producer's copy of headIndex.
+    alignas(kCacheLine) T ring[Capacity];                      ///< The ring.
+};
+
+#endif // SPSCQUEUE_H
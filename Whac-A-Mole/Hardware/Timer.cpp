@@ -1,17 +1,49 @@
 #include "Timer.h"
-#include <iostream>
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <time.h>
 
 /**
  * @class Timer
  * @brief Manages a countdown timer for a game.
  *
- * This class provides functionalities for starting, stopping, and checking a countdown timer.
+ * This class provides functionalities for starting, stopping, pausing and checking a countdown timer.
  * It is used to keep track of the remaining time in a game scenario.
  * @author Anubhav Aery
  */
-Timer::Timer() : timeLeft(30) {}
+Timer::Timer() : duration(std::chrono::seconds(30)), endTime(), pausedAt(), paused(false) {}
+
+/**
+ * @brief Reads the monotonic clock.
+ *
+ * CLOCK_MONOTONIC is the clock behind std::chrono::steady_clock on Linux and is answered
+ * by the vDSO, so a reading costs a few nanoseconds and no system call.
+ *
+ * @return The current time on the monotonic clock.
+ */
+Timer::Clock::time_point Timer::now() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return Clock::time_point(std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec));
+}
+
+/**
+ * @brief Sleeps until a time on the monotonic clock.
+ *
+ * @param deadline The time to wake up.
+ */
+void Timer::sleepUntil(Clock::time_point deadline) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    if (ns <= 0) {
+        return;
+    }
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+}
 
 /**
  * @brief Starts the countdown timer.
@@ -20,30 +52,102 @@ Timer::Timer() : timeLeft(30) {}
  * The end time is set based on the current time plus the countdown duration.
  */
 void Timer::start() {
-    endTime = std::chrono::system_clock::now() + std::chrono::seconds(timeLeft);
-    std::cout << "Timer started!\n";
+    endTime = now() + duration;
+    paused = false;
 }
 
 /**
  * @brief Stops the countdown timer.
  *
- * Stops the timer and prints a message indicating that the timer has been stopped.
+ * Freezes the time left where it was, as pause() does. Nothing is printed, as the timer
+ * runs on the game thread.
  */
 void Timer::stop() {
-    std::cout << "Timer stopped!\n";
+    pause();
+}
+
+/**
+ * @brief Pauses the countdown.
+ *
+ * Records the moment of the pause so the time left stays frozen until resume().
+ */
+void Timer::pause() {
+    if (!paused) {
+        pausedAt = now();
+        paused = true;
+    }
+}
+
+/**
+ * @brief Resumes a paused countdown.
+ *
+ * Pushes the end time back by however long the timer was paused.
+ */
+void Timer::resume() {
+    if (paused) {
+        endTime += now() - pausedAt;
+        paused = false;
+    }
+}
+
+/**
+ * @brief Checks whether the countdown is paused.
+ *
+ * @return True while the countdown is paused.
+ */
+bool Timer::isPaused() const {
+    return paused;
 }
 
 /**
  * @brief Retrieves the time left on the timer.
  *
- * Calculates and returns the remaining time in seconds. If the time is up, returns zero.
+ * Calculates and returns the remaining time in seconds, rounded up. If the time is up, returns zero.
  *
  * @return The time left in seconds, or zero if the time is up.
  */
 int Timer::getTimeLeft() const {
-    auto now = std::chrono::system_clock::now();
-    auto durationLeft = std::chrono::duration_cast<std::chrono::seconds>(endTime - now);
-    return std::max(0, static_cast<int>(durationLeft.count()));
+    auto durationLeft = std::chrono::ceil<std::chrono::seconds>(getTimeLeftNs());
+    return static_cast<int>(durationLeft.count());
+}
+
+/**
+ * @brief Retrieves the time left on the timer with nanosecond resolution.
+ *
+ * @return The time left, or zero if the time is up.
+ */
+std::chrono::nanoseconds Timer::getTimeLeftNs() const {
+    return getTimeLeftNs(now());
+}
+
+/**
+ * @brief Retrieves the time left relative to a clock reading taken by the caller.
+ *
+ * @param at A reading of Timer::now().
+ * @return The time left at that moment, or zero if the time is up.
+ */
+std::chrono::nanoseconds Timer::getTimeLeftNs(Clock::time_point at) const {
+    auto reference = paused ? pausedAt : at;
+    return std::max(std::chrono::nanoseconds::zero(), std::chrono::nanoseconds(endTime - reference));
+}
+
+/**
+ * @brief Retrieves the time elapsed since start(), excluding time spent paused.
+ *
+ * @return The elapsed time.
+ */
+std::chrono::nanoseconds Timer::getElapsed() const {
+    return getElapsed(now());
+}
+
+/**
+ * @brief Retrieves the elapsed time relative to a clock reading taken by the caller.
+ *
+ * @param at A reading of Timer::now().
+ * @return The elapsed time at that moment.
+ */
+std::chrono::nanoseconds Timer::getElapsed(Clock::time_point at) const {
+    return duration - getTimeLeftNs(at);
 }
 
 /**
@@ -54,5 +158,24 @@ int Timer::getTimeLeft() const {
  * @return True if the timer's time is up, false otherwise.
  */
 bool Timer::isTimeUp() const {
-    return std::chrono::system_clock::now() >= endTime;
+    return isTimeUp(now());
+}
+
+/**
+ * @brief Checks if the countdown had completed at a clock reading taken by the caller.
+ *
+ * @param at A reading of Timer::now().
+ * @return True if the timer's time was up at that moment, false otherwise.
+ */
+bool Timer::isTimeUp(Clock::time_point at) const {
+    return !paused && at >= endTime;
+}
+
+/**
+ * @brief Retrieves the moment the countdown ends on the monotonic clock.
+ *
+ * @return The end of the countdown, or time_point::max() while paused.
+ */
+Timer::Clock::time_point Timer::getDeadline() const {
+    return paused ? Clock::time_point::max() : endTime;
 }
@@ -7,13 +7,16 @@
  * @class Timer
  * @brief Manages a countdown timer for timing events in a game.
  *
- * This class is responsible for starting a countdown timer, stopping it,
+ * This class is responsible for starting a countdown timer, stopping, pausing and resuming it,
  * and providing information about the time left and whether the time is up.
- * It uses the std::chrono library for time measurements.
+ * It runs on the monotonic std::chrono::steady_clock, so wall-clock adjustments such as
+ * NTP steps cannot shorten or stretch a round.
  * @author Anubhav Aery
  */
 class Timer {
 public:
+    using Clock = std::chrono::steady_clock; ///< Monotonic clock used for every measurement.
+
     /**
      * @brief Constructor for Timer.
      *
@@ -21,6 +24,27 @@ public:
      */
     Timer();
 
+    /**
+     * @brief Reads the monotonic clock.
+     *
+     * Uses clock_gettime(CLOCK_MONOTONIC), which Linux serves from the vDSO without entering
+     * the kernel. Loops that query the timer several times per tick can read the clock once
+     * and pass the result to the overloads that take a time point.
+     *
+     * @return The current time on the monotonic clock.
+     */
+    static Clock::time_point now();
+
+    /**
+     * @brief Sleeps until a time on the monotonic clock.
+     *
+     * Uses clock_nanosleep() with TIMER_ABSTIME, so the wake-up time does not drift by the
+     * time taken to compute a relative delay, and a signal does not end the sleep early.
+     *
+     * @param deadline The time to wake up; a time already past returns at once.
+     */
+    static void sleepUntil(Clock::time_point deadline);
+
     /**
      * @brief Starts the countdown timer.
      *
@@ -31,19 +55,68 @@ public:
     /**
      * @brief Stops the countdown timer.
      *
-     * Stops the timer, preventing any further countdown.
+     * Stops the timer, preventing any further countdown; the time left stays frozen until
+     * the next start().
      */
     void stop();
 
+    /**
+     * @brief Pauses the countdown, freezing the time left.
+     */
+    void pause();
+
+    /**
+     * @brief Resumes a paused countdown, moving the deadline by the time spent paused.
+     */
+    void resume();
+
+    /**
+     * @brief Checks whether the countdown is paused.
+     *
+     * @return True if pause() was called and resume() has not been called since.
+     */
+    bool isPaused() const;
+
     /**
      * @brief Retrieves the time left on the timer.
      *
-     * Calculates and returns the remaining time in seconds. If the time is up, returns zero.
+     * Calculates and returns the remaining time in whole seconds, rounded up so a countdown
+     * shows 30 for the whole first second. If the time is up, returns zero.
      *
      * @return The time left in seconds, or zero if the time is up.
      */
     int getTimeLeft() const;
 
+    /**
+     * @brief Retrieves the time left on the timer with nanosecond resolution.
+     *
+     * @return The time left, or zero if the time is up.
+     */
+    std::chrono::nanoseconds getTimeLeftNs() const;
+
+    /**
+     * @brief Retrieves the time left relative to a clock reading taken by the caller.
+     *
+     * @param at A reading of Timer::now().
+     * @return The time left at that moment, or zero if the time is up.
+     */
+    std::chrono::nanoseconds getTimeLeftNs(Clock::time_point at) const;
+
+    /**
+     * @brief Retrieves the time elapsed since start(), excluding time spent paused.
+     *
+     * @return The elapsed time, capped at the countdown duration.
+     */
+    std::chrono::nanoseconds getElapsed() const;
+
+    /**
+     * @brief Retrieves the elapsed time relative to a clock reading taken by the caller.
+     *
+     * @param at A reading of Timer::now().
+     * @return The elapsed time at that moment, capped at the countdown duration.
+     */
+    std::chrono::nanoseconds getElapsed(Clock::time_point at) const;
+
     /**
      * @brief Checks if the timer's countdown has completed.
      *
@@ -53,9 +126,30 @@ public:
      */
     bool isTimeUp() const;
 
+    /**
+     * @brief Checks if the countdown had completed at a clock reading taken by the caller.
+     *
+     * @param at A reading of Timer::now().
+     * @return True if the timer's time was up at that moment, false otherwise.
+     */
+    bool isTimeUp(Clock::time_point at) const;
+
+    /**
+     * @brief Retrieves the moment the countdown ends on the monotonic clock.
+     *
+     * Used by event loops that sleep until the round is over instead of polling isTimeUp().
+     * While the timer is paused the countdown has no deadline and time_point::max() is
+     * returned, so callers should query it again after resume().
+     *
+     * @return The end of the countdown as a steady_clock time point.
+     */
+    Clock::time_point getDeadline() const;
+
 private:
-    int timeLeft; ///< The initial time left for the countdown in seconds.
-    std::chrono::time_point<std::chrono::system_clock> endTime; ///< The end time point for the timer.
+    std::chrono::nanoseconds duration; ///< The length of the countdown.
+    Clock::time_point endTime; ///< The end time point for the timer.
+    Clock::time_point pausedAt; ///< The moment pause() was called.
+    bool paused; ///< True while the countdown is paused.
 };
 
 #endif // TIMER_H
@@ -1,6 +1,6 @@
 #include "HardwareInterface.h"
-#include <QTimer>
-#include <QThread>
+#include <iostream>
+#include <stdexcept>
 
 /**
  * @class HardwareInterface
@@ -12,83 +12,144 @@
  * @author Anubhav Aery
  */
 HardwareInterface::HardwareInterface(QObject *parent)
-        : QObject(parent), gameController(), player(), highScore() {
-    // Initialization, if needed
+        : QObject(parent), gameController(), player(), gameOver(GameOverPipeline::instance()),
+          drainTimer(new QTimer(this)), lastCountdown(-1) {
+    gameController.setEventQueue(&events);
+    drainTimer->setInterval(kDrainIntervalMs);
+    connect(drainTimer, &QTimer::timeout, this, &HardwareInterface::drainEvents);
+    connect(&gameOver, &GameOverPipeline::scoreSaved, this, &HardwareInterface::scoreSaved);
 }
 
 /**
  * @brief Destructor for HardwareInterface.
  *
- * Responsible for cleaning up resources used by the HardwareInterface instance.
+ * Ends a running round early and waits for the game thread, so the thread never outlives
+ * the controller it uses. The queue is drained up to the Ended event first: the game
+ * thread retries Ended until it fits, so joining with a full queue would never return.
  */
 HardwareInterface::~HardwareInterface() {
-    // Clean up, if needed
+    if (gameThread.joinable()) {
+        gameController.requestStop();
+        GameEvent event;
+        while (!events.tryPop(event) || event.type != GameEvent::Type::Ended) {
+            std::this_thread::yield();
+        }
+        gameThread.join();
+    }
 }
 
 /**
  * @brief Starts the game with a given player name.
  *
- * Sets up the game environment, initializes the game controller, starts the game timer,
- * and emits a signal indicating the game has started.
- *
  * @param playerName The name of the player as a QString.
  */
 void HardwareInterface::startGame(const QString& playerName) {
-    player.setName(playerName.toStdString());
-    gameController.setup();
-    gameController.startGame();
-    emit gameStarted();
-
-    // QTimer should be created in the thread it's going to be used in
-    QTimer *countdownTimer = new QTimer(this);
-    countdownTimer->moveToThread(QThread::currentThread()); // Ensure timer is in the correct thread
-    connect(countdownTimer, &QTimer::timeout, this, [this, countdownTimer]() {
-        if (!gameController.timer.isTimeUp()) {
-            emit countdownUpdated(gameController.timer.getTimeLeft());
-        } else {
-            countdownTimer->stop();
-            countdownTimer->deleteLater();
-            stopGame();
-        }
-    });
-    countdownTimer->start(1000);
+    handleGame(playerName);
 }
 
 /**
  * @brief Stops the game.
  *
- * Ends the game, calculates the final score, and emits a signal indicating the game has ended.
+ * Asks the game thread to end the round; gameEnded is emitted when its Ended event is drained.
  */
 void HardwareInterface::stopGame() {
-    gameController.endGame(player);
-    //highScore.add(player.getScore(), player.getName());
-    emit gameEnded();
+    gameController.requestStop();
 }
 
 /**
  * @brief Handles the game logic in a separate thread.
  *
- * This method sets up a new thread for running the game logic. It manages the starting
- * and stopping of the game and the interaction between the game controller and other components.
+ * Starts a round for the player on the game thread and starts the drain timer. This object
+ * stays in the GUI thread.
  *
  * @param playerName The name of the player as a QString.
  */
 void HardwareInterface::handleGame(const QString& playerName) {
-    // Creating a thread for game logic
-    QThread *gameThread = new QThread();
-    moveToThread(gameThread); // Move this object to the new thread
+    if (gameThread.joinable()) {
+        return;
+    }
+    player = Player();
+    player.setName(playerName.toStdString());
+    lastCountdown = -1;
+    gameController.clearStop();
+    gameThread = std::thread(&HardwareInterface::runGame, this);
+    drainTimer->start();
+}
+
+/**
+ * @brief Runs one round on the game thread.
+ *
+ * Only touches the game controller and the player until the Ended event is published;
+ * the GUI thread reads them again after joining the thread. The attract sweep plays once
+ * across the matrix before the round starts. A failure of the hardware or the input
+ * sources ends the round early, and Ended is still published.
+ */
+void HardwareInterface::runGame() {
+    try {
+        gameController.setup();
+        gameController.attract(GameController::kAttractIntro);
+        gameController.startGame();
+        gameController.inGame(player);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+    }
+    gameController.endGame(player);
+}
 
-    // Connecting signals and slots for thread management
-    connect(gameThread, &QThread::started, this, [this, playerName]() {
-        startGame(playerName);
-        // Add game logic here
-        // This can include interaction with LEDMatrix and GameController
-        gameController.inGame(player, highScore);
-        stopGame();
-    });
-    connect(this, &HardwareInterface::gameEnded, gameThread, &QThread::quit);
-    connect(gameThread, &QThread::finished, gameThread, &QThread::deleteLater);
+/**
+ * @brief Drains the event queue and emits the matching signals.
+ *
+ * Runs in the GUI thread. Score changes are emitted as scoreUpdated, ticks as
+ * countdownUpdated whenever the whole seconds left change.
+ */
+void HardwareInterface::drainEvents() {
+    GameEvent event;
+    while (events.tryPop(event)) {
+        switch (event.type) {
+            case GameEvent::Type::Started:
+                emit gameStarted();
+                emit scoreUpdated(event.score);
+                break;
+            case GameEvent::Type::Score:
+                emit scoreUpdated(event.score);
+                break;
+            case GameEvent::Type::Tick: {
+                int countdown = (event.timeLeftMs + 999) / 1000;
+                if (countdown != lastCountdown) {
+                    lastCountdown = countdown;
+                    emit countdownUpdated(countdown);
+                }
+                break;
+            }
+            case GameEvent::Type::Ended:
+                emit scoreUpdated(event.score);
+                finishGame();
+                emit gameEnded();
+                return;
+            case GameEvent::Type::MoleSpawned:
+            case GameEvent::Type::Hit:
+            case GameEvent::Type::Miss:
+                break;
+        }
+    }
+}
 
-    // Start the thread
-    gameThread->start();
+/**
+ * @brief Waits for the game thread, stops the drain timer and hands the round to the pipeline.
+ *
+ * The thread has published its last event, so the join returns immediately. The score and
+ * the reaction-time percentiles are copied out before the next round can reuse the
+ * controller; saving them happens on the pipeline's threads.
+ */
+void HardwareInterface::finishGame() {
+    drainTimer->stop();
+    if (gameThread.joinable()) {
+        gameThread.join();
+    }
+    GameOverResult result;
+    result.playerName = player.getName();
+    result.score = player.getScore();
+    result.game = gameController.getGameLatency().summary();
+    result.session = gameController.getSessionLatency().summary();
+    gameOver.submit(result);
 }
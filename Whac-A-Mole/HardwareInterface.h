@@ -2,9 +2,12 @@
 #define HARDWAREINTERFACE_H
 
 #include <QObject>
+#include <QTimer>
+#include <thread>
 #include "Hardware/GameController.h"
+#include "Hardware/GameEvent.h"
 #include "Hardware/Player.h"
-#include "Hardware/HighScore.h"
+#include "GameOverPipeline.h"
 
 /**
  * @class HardwareInterface
@@ -13,6 +16,15 @@
  * This class encapsulates the interaction with the game hardware, including the game controller,
  * player data, and high score management. It offers functionality to start and stop the game,
  * handle the game's logic, and emit relevant signals during the game's lifecycle.
+ *
+ * The round runs on a dedicated game thread, which publishes GameEvents into a lock-free
+ * single-producer/single-consumer queue. The object itself stays in the GUI thread, where
+ * a timer drains the queue once per frame and emits the signals, so no event allocates or
+ * crosses threads through a queued connection.
+ *
+ * At the end of a round the score, the sound and the report are handed to a
+ * GameOverPipeline, so the GUI thread never waits for the disk and the next round can
+ * start while the last score is still being saved.
  * @author Anubhav Aery
  */
 class HardwareInterface : public QObject {
@@ -31,15 +43,15 @@ public:
     /**
      * @brief Destructor for HardwareInterface.
      *
-     * Cleans up resources used by the HardwareInterface instance.
+     * Ends a running round early, drains its events and waits for the game thread.
      */
     ~HardwareInterface();
 
     /**
      * @brief Handles the overall game logic.
      *
-     * This method is responsible for setting up and managing the game logic,
-     * including starting and stopping the game.
+     * Starts the round on the game thread and starts draining its events. Does nothing if
+     * a round is already running.
      *
      * @param playerName The name of the player as a QString.
      */
@@ -49,7 +61,7 @@ public slots:
             /**
              * @brief Slot to start the game with a given player name.
              *
-             * This slot sets up the game environment, initializes the game controller, and starts the game.
+             * Same as handleGame().
              *
              * @param playerName The name of the player as a QString.
              */
@@ -58,10 +70,18 @@ public slots:
     /**
      * @brief Slot to stop the game.
      *
-     * This slot is responsible for ending the game and handling any necessary cleanup.
+     * Asks a running round to end early. The game thread finishes within one tick and
+     * gameEnded is emitted once its last events have been drained.
      */
     void stopGame();
 
+    /**
+     * @brief Slot that drains the event queue and emits the matching signals.
+     *
+     * Called by the drain timer once per frame while a round runs.
+     */
+    void drainEvents();
+
     signals:
             /**
              * @brief Signal emitted when the score is updated.
@@ -80,6 +100,14 @@ public slots:
      */
     void gameEnded();
 
+    /**
+     * @brief Signal emitted once the score of the last round is saved.
+     *
+     * @param score The score that was saved.
+     * @param rank Its position on the leaderboard, starting at 1, or 0 if it did not make the board.
+     */
+    void scoreSaved(int score, int rank);
+
     /**
      * @brief Signal emitted to update the countdown timer.
      *
@@ -87,10 +115,26 @@ public slots:
      */
     void countdownUpdated(int timeLeft);
 
+    static constexpr int kDrainIntervalMs = 16; ///< Drain period, about one frame at 60 Hz.
+
 private:
+    /**
+     * @brief Runs one round. Executes on the game thread.
+     */
+    void runGame();
+
+    /**
+     * @brief Waits for the game thread, stops draining and hands the round to the pipeline.
+     */
+    void finishGame();
+
     GameController gameController; ///< Manages game control logic.
     Player player;                 ///< Represents the player in the game.
-    HighScore highScore;           ///< Manages high score data.
+    GameOverPipeline &gameOver;    ///< Saves the score and plays the game-over sound in the background.
+    GameEventQueue events;         ///< Events from the game thread to the GUI thread.
+    std::thread gameThread;        ///< Runs the round, joinable while a round runs.
+    QTimer *drainTimer;            ///< Drains the event queue in the GUI thread.
+    int lastCountdown;             ///< Last countdown value emitted, in seconds.
 };
 
 #endif // HARDWAREINTERFACE_H
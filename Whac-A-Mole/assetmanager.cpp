@@ -0,0 +1,151 @@
+#include "assetmanager.h"
+#include <QBuffer>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImageReader>
+#include <QMovie>
+
+/**
+ * @brief Retrieves the application's asset manager.
+ *
+ * @return The single instance, created on first use.
+ */
+AssetManager& AssetManager::instance() {
+    static AssetManager manager;
+    return manager;
+}
+
+/**
+ * @brief Starts decoding files in the background.
+ *
+ * Each file is decoded into a QImage on its own thread; QImage, unlike QPixmap, may be
+ * created outside the GUI thread.
+ *
+ * @param paths Paths of the image files.
+ */
+void AssetManager::preload(const QStringList &paths) {
+    for (const QString &path : paths) {
+        if (!assets.contains(path)) {
+            assets[path].pending = std::async(std::launch::async, &AssetManager::decode, path).share();
+        }
+    }
+}
+
+/**
+ * @brief Retrieves an image at its original size.
+ *
+ * @param path Path of the image file.
+ * @return The pixmap, or a null pixmap if the file cannot be decoded.
+ */
+QPixmap AssetManager::pixmap(const QString &path) {
+    return resolve(path).pixmap;
+}
+
+/**
+ * @brief Retrieves an image scaled with smooth transformation.
+ *
+ * @param path Path of the image file.
+ * @param size Size to scale to.
+ * @param mode How the aspect ratio is handled.
+ * @return The scaled pixmap, or a null pixmap if the file cannot be decoded.
+ */
+QPixmap AssetManager::scaled(const QString &path, const QSize &size, Qt::AspectRatioMode mode) {
+    Asset &asset = resolve(path);
+    if (asset.pixmap.isNull()) {
+        return asset.pixmap;
+    }
+    quint64 key = (static_cast<quint64>(static_cast<quint32>(size.width())) << 32)
+                  | (static_cast<quint64>(static_cast<quint32>(size.height())) << 2)
+                  | static_cast<quint64>(mode);
+    auto cached = asset.scaledCopies.constFind(key);
+    if (cached != asset.scaledCopies.constEnd()) {
+        return cached.value();
+    }
+    QPixmap scaledPixmap = asset.pixmap.scaled(size, mode, Qt::SmoothTransformation);
+    asset.scaledCopies.insert(key, scaledPixmap);
+    return scaledPixmap;
+}
+
+/**
+ * @brief Creates a movie for an animated image.
+ *
+ * @param path Path of the animated image.
+ * @param parent Owner of the returned movie.
+ * @return The movie.
+ */
+QMovie *AssetManager::movie(const QString &path, QObject *parent) {
+    auto bytes = movies.find(path);
+    if (bytes == movies.end()) {
+        QFile file(path);
+        bytes = movies.insert(path, file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray());
+    }
+    QMovie *animation = new QMovie(parent);
+    QBuffer *buffer = new QBuffer(animation);
+    buffer->setData(bytes.value());
+    animation->setDevice(buffer);
+    animation->setCacheMode(QMovie::CacheAll);
+    return animation;
+}
+
+/**
+ * @brief Retrieves the time spent decoding a file.
+ *
+ * @param path Path of the image file.
+ * @return The decode time in milliseconds, or -1 if the file has not been decoded yet.
+ */
+double AssetManager::decodeTime(const QString &path) const {
+    auto asset = assets.constFind(path);
+    return asset == assets.constEnd() ? -1 : asset.value().decodeMilliseconds;
+}
+
+/**
+ * @brief Releases every cached pixmap.
+ *
+ * Waits for decodes that are still running so no worker outlives the cache.
+ */
+void AssetManager::clear() {
+    for (Asset &asset : assets) {
+        if (asset.pending.valid()) {
+            asset.pending.wait();
+        }
+    }
+    assets.clear();
+    movies.clear();
+}
+
+/**
+ * @brief Decodes one file. Runs on a worker thread.
+ */
+AssetManager::Decoded AssetManager::decode(const QString &path) {
+    QElapsedTimer timer;
+    timer.start();
+    QImageReader reader(path);
+    Decoded decoded;
+    decoded.image = reader.read();
+    decoded.nanoseconds = timer.nsecsElapsed();
+    return decoded;
+}
+
+/**
+ * @brief Finds a cache entry, finishing its decode on first use.
+ *
+ * Waits for a preloaded file that is still decoding, or decodes a file that was never
+ * preloaded, then converts the image to a pixmap and logs the decode time.
+ */
+AssetManager::Asset &AssetManager::resolve(const QString &path) {
+    Asset &asset = assets[path];
+    if (asset.decodeMilliseconds >= 0) {
+        return asset;
+    }
+    Decoded decoded = asset.pending.valid() ? asset.pending.get() : decode(path);
+    asset.pending = std::shared_future<Decoded>();
+    asset.decodeMilliseconds = decoded.nanoseconds / 1e6;
+    if (decoded.image.isNull()) {
+        qDebug() << "Failed to load" << path;
+    } else {
+        asset.pixmap = QPixmap::fromImage(decoded.image);
+        qDebug() << "Decoded" << path << "in" << asset.decodeMilliseconds << "ms";
+    }
+    return asset;
+}
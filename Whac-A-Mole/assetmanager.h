@@ -0,0 +1,134 @@
+/**
+ * @file assetmanager.h
+ * @brief Header file for the AssetManager class.
+ *
+ * This file contains the declaration of the AssetManager class, which decodes the
+ * images used by the pages once and keeps scaled copies of them.
+ * @author Yangxiuye Gu
+ */
+
+#ifndef ASSETMANAGER_H
+#define ASSETMANAGER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <future>
+
+class QMovie;
+class QObject;
+
+/**
+ * @class AssetManager
+ * @brief Application-wide cache of decoded and pre-scaled images.
+ *
+ * preload() starts decoding a list of files on worker threads, so the PNGs decode in
+ * parallel while the window is being built. Pages then ask for a pixmap at the size they
+ * display it; the first request waits for the decode if it is still running, converts the
+ * image to a pixmap and scales it, and every later request for the same size is a hash
+ * lookup. Files that were not preloaded are decoded on first use. The time taken to decode
+ * each file is logged and can be queried with decodeTime().
+ *
+ * All methods must be called from the GUI thread.
+ */
+class AssetManager {
+public:
+    /**
+     * @brief Retrieves the application's asset manager.
+     *
+     * @return The single instance.
+     */
+    static AssetManager& instance();
+
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    /**
+     * @brief Starts decoding files in the background.
+     *
+     * Files that are already cached or being decoded are skipped.
+     *
+     * @param paths Paths of the image files.
+     */
+    void preload(const QStringList &paths);
+
+    /**
+     * @brief Retrieves an image at its original size.
+     *
+     * @param path Path of the image file.
+     * @return The pixmap, or a null pixmap if the file cannot be decoded.
+     */
+    QPixmap pixmap(const QString &path);
+
+    /**
+     * @brief Retrieves an image scaled with smooth transformation.
+     *
+     * The scaled copy is cached, so asking again for the same size costs a lookup.
+     *
+     * @param path Path of the image file.
+     * @param size Size to scale to.
+     * @param mode How the aspect ratio is handled.
+     * @return The scaled pixmap, or a null pixmap if the file cannot be decoded.
+     */
+    QPixmap scaled(const QString &path, const QSize &size, Qt::AspectRatioMode mode = Qt::KeepAspectRatio);
+
+    /**
+     * @brief Creates a movie for an animated image.
+     *
+     * The file is read from disk once; every movie created for it plays from the cached bytes
+     * and keeps its decoded frames.
+     *
+     * @param path Path of the animated image, for example a GIF.
+     * @param parent Owner of the returned movie.
+     * @return The movie. Check QMovie::isValid().
+     */
+    QMovie *movie(const QString &path, QObject *parent);
+
+    /**
+     * @brief Retrieves the time spent decoding a file.
+     *
+     * @param path Path of the image file.
+     * @return The decode time in milliseconds, or -1 if the file has not been decoded yet.
+     */
+    double decodeTime(const QString &path) const;
+
+    /**
+     * @brief Releases every cached pixmap.
+     *
+     * Must be called before the QApplication is destroyed, since pixmaps cannot outlive it.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Result of decoding one file on a worker thread.
+     */
+    struct Decoded {
+        QImage image;       ///< The decoded image, null on failure.
+        qint64 nanoseconds; ///< Time spent in the decoder.
+    };
+
+    /**
+     * @brief Cache entry of one file.
+     */
+    struct Asset {
+        std::shared_future<Decoded> pending;  ///< Running decode, valid until resolved.
+        QPixmap pixmap;                       ///< Pixmap at the original size.
+        QHash<quint64, QPixmap> scaledCopies; ///< Scaled pixmaps keyed by size and aspect mode.
+        double decodeMilliseconds = -1;       ///< Decode time, -1 until resolved.
+    };
+
+    AssetManager() = default;
+
+    static Decoded decode(const QString &path);
+    Asset &resolve(const QString &path);
+
+    QHash<QString, Asset> assets;       ///< Cached images keyed by path.
+    QHash<QString, QByteArray> movies;  ///< Raw bytes of animated images keyed by path.
+};
+
+#endif // ASSETMANAGER_H
@@ -0,0 +1,191 @@
+#include "audioengine.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Sounds decoded by initialise().
+ */
+const char *const kPreloadedSounds[] = {"Click.wav", "over.wav", "gameSound.mp3"};
+
+} // namespace
+
+/**
+ * @brief Retrieves the application's audio engine.
+ *
+ * @return The single instance, created on first use.
+ */
+AudioEngine& AudioEngine::instance()
+{
+    static AudioEngine engine;
+    return engine;
+}
+
+/**
+ * @brief Constructs a closed AudioEngine.
+ */
+AudioEngine::AudioEngine() : open(false)
+{
+}
+
+/**
+ * @brief Destructor for AudioEngine. Closes the device if it is still open.
+ */
+AudioEngine::~AudioEngine()
+{
+    shutdown();
+}
+
+/**
+ * @brief Opens the audio device and preloads the game's sounds.
+ *
+ * @param headless If true, use SDL's dummy audio driver.
+ * @return True if the device is open, false otherwise.
+ */
+bool AudioEngine::initialise(bool headless)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (open)
+    {
+        return true;
+    }
+
+    const char *driver = std::getenv("WHAC_AUDIO_DRIVER");
+    if (headless || (driver && std::strcmp(driver, "dummy") == 0))
+    {
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    }
+
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0)
+    {
+        std::cerr << "SDL could not initialize! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    Mix_Init(MIX_INIT_MP3);
+    if (Mix_OpenAudio(kFrequency, MIX_DEFAULT_FORMAT, 2, kChunkSamples) < 0)
+    {
+        std::cerr << "SDL_mixer could not initialize! SDL_mixer Error: " << Mix_GetError() << std::endl;
+        Mix_Quit();
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+    Mix_AllocateChannels(kChannelCount);
+    open = true;
+
+    for (const char *sound : kPreloadedSounds)
+    {
+        preload(sound);
+    }
+    return true;
+}
+
+/**
+ * @brief Frees every sound and closes the audio device.
+ */
+void AudioEngine::shutdown()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (!open)
+    {
+        return;
+    }
+    Mix_HaltChannel(-1);
+    for (auto &entry : chunks)
+    {
+        Mix_FreeChunk(entry.second);
+    }
+    chunks.clear();
+    Mix_CloseAudio();
+    Mix_Quit();
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    open = false;
+}
+
+/**
+ * @brief Checks whether the audio device is open.
+ *
+ * @return True after a successful initialise().
+ */
+bool AudioEngine::isOpen() const
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return open;
+}
+
+/**
+ * @brief Decodes a sound file into the cache.
+ *
+ * Mix_LoadWAV() decodes every format SDL_mixer supports, including MP3, into raw samples,
+ * so nothing is decoded while the sound plays.
+ *
+ * @param audioPath Path to the audio file.
+ * @return True if the sound is cached, false if it could not be decoded.
+ */
+bool AudioEngine::preload(const std::string &audioPath)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (!open)
+    {
+        return false;
+    }
+    if (chunks.count(audioPath))
+    {
+        return true;
+    }
+    Mix_Chunk *chunk = Mix_LoadWAV(audioPath.c_str());
+    if (chunk == NULL)
+    {
+        std::cerr << "Failed to load " << audioPath << "! SDL_mixer Error: " << Mix_GetError() << std::endl;
+        return false;
+    }
+    chunks.emplace(audioPath, chunk);
+    return true;
+}
+
+/**
+ * @brief Plays a sound on a free channel of the pool.
+ *
+ * If every channel is busy, the channel that has been playing the longest is stopped
+ * and reused. Does nothing unless initialise() has opened the device; a failed
+ * initialise() is only retried by calling it again, so playing without a sound card
+ * costs nothing and prints nothing.
+ *
+ * @param audioPath Path to the audio file.
+ * @return True if the sound started, false otherwise.
+ */
+bool AudioEngine::play(const std::string &audioPath)
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (!open || !preload(audioPath))
+    {
+        return false;
+    }
+    Mix_Chunk *chunk = chunks[audioPath];
+    if (Mix_PlayChannel(-1, chunk, 0) == -1)
+    {
+        int oldest = Mix_GroupOldest(-1);
+        if (oldest == -1 || Mix_PlayChannel(oldest, chunk, 0) == -1)
+        {
+            std::cerr << "Failed to play " << audioPath << "! SDL_mixer Error: " << Mix_GetError() << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Stops every channel.
+ */
+void AudioEngine::stopAll()
+{
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (open)
+    {
+        Mix_HaltChannel(-1);
+    }
+}
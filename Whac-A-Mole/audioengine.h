@@ -0,0 +1,106 @@
+/**
+ * @file audioengine.h
+ * @brief Header file for the AudioEngine class.
+ *
+ * This file contains the declaration of the AudioEngine class, which keeps the
+ * audio device open for the lifetime of the application and plays pre-decoded
+ * sound effects.
+ * @author Nasri Hussein
+ */
+
+#ifndef AUDIOENGINE_H
+#define AUDIOENGINE_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+struct Mix_Chunk;
+
+/**
+ * @class AudioEngine
+ * @brief Process-wide SDL_mixer device with a cache of decoded sounds.
+ *
+ * The device is opened once by initialise() and the sounds are decoded into Mix_Chunk
+ * buffers ahead of time, so playing a sound is a table lookup and a Mix_PlayChannel() call.
+ * Sounds are mixed on a pool of channels; when every channel is busy, the oldest sound is
+ * cut off. The mixer runs with a small buffer so a sound starts within about 6 ms.
+ *
+ * Setting WHAC_AUDIO_DRIVER=dummy (or passing headless to initialise()) selects SDL's
+ * dummy driver, which consumes the audio without a sound card, for headless runs and tests.
+ *
+ * Every method may be called from any thread; the cache and the device state are guarded
+ * by one mutex, so the GUI thread and background tasks can play sounds at the same time.
+ */
+class AudioEngine {
+public:
+    /**
+     * @brief Retrieves the application's audio engine.
+     *
+     * @return The single instance.
+     */
+    static AudioEngine& instance();
+
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+
+    /**
+     * @brief Opens the audio device and preloads the game's sounds.
+     *
+     * Calling it again after a successful call does nothing.
+     *
+     * @param headless If true, use SDL's dummy audio driver.
+     * @return True if the device is open, false otherwise.
+     */
+    bool initialise(bool headless = false);
+
+    /**
+     * @brief Frees every sound and closes the audio device.
+     */
+    void shutdown();
+
+    /**
+     * @brief Checks whether the audio device is open.
+     *
+     * @return True after a successful initialise().
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Decodes a sound file into the cache.
+     *
+     * @param audioPath Path to the audio file.
+     * @return True if the sound is cached, false if it could not be decoded.
+     */
+    bool preload(const std::string &audioPath);
+
+    /**
+     * @brief Plays a sound on a free channel of the pool.
+     *
+     * Sounds that were not preloaded are decoded on first use and then cached. Does nothing
+     * until initialise() has opened the device.
+     *
+     * @param audioPath Path to the audio file.
+     * @return True if the sound started, false otherwise.
+     */
+    bool play(const std::string &audioPath);
+
+    /**
+     * @brief Stops every channel.
+     */
+    void stopAll();
+
+    static constexpr int kFrequency = 44100;    ///< Output sample rate in Hz.
+    static constexpr int kChunkSamples = 256;   ///< Mixer buffer; 256 samples is 5.8 ms at 44.1 kHz.
+    static constexpr int kChannelCount = 16;    ///< Number of sounds that can play at once.
+
+private:
+    AudioEngine();
+    ~AudioEngine();
+
+    mutable std::recursive_mutex mutex;                 ///< Guards the members below; recursive as play() calls preload().
+    std::unordered_map<std::string, Mix_Chunk*> chunks; ///< Decoded sounds keyed by path.
+    bool open;                                          ///< True while the device is open.
+};
+
+#endif // AUDIOENGINE_H
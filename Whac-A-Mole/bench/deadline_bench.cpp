@@ -0,0 +1,177 @@
+/**
+ * @file deadline_bench.cpp
+ * @brief Checks that a round plays the same however late the game loop wakes up.
+ *
+ * Each mode plays a seeded 30 second round on a simulated clock, the way
+ * GameController::inGame() drives the MoleEngine: the loop sleeps until the next mole
+ * deadline or key, advances the engine, and on a key whacks the lowest lit cell. The
+ * player presses a key every 700 ms. The first run wakes up exactly at every deadline; the
+ * others wake up late by a random delay of up to 1, 10 and 50 ms, as a loaded scheduler
+ * would. Keys keep their own time, as hardware timestamps do. Every spawn is logged with its
+ * cell and escape time, and each run is compared with the exact one. The report also gives
+ * the loop passes per second of play, which is all the CPU the schedule asks for.
+ *
+ * A second check feeds keys that are older than the last advance, as a button edge that
+ * waited in the queue while the loop was busy: a key before a mole's escape must still hit
+ * it and take the penalty back, and a key before a mole's spawn must miss it.
+ *
+ * Usage: deadline_bench [rounds per delay]
+ * @author Anubhav Aery
+ */
+
+#include "GameMode.h"
+#include "MoleEngine.h"
+#include "Random.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::chrono::seconds kRoundLength{30};     ///< Same as the Timer's countdown.
+constexpr std::chrono::milliseconds kKeyPeriod{700}; ///< Time between two keys of the player.
+
+/**
+ * @brief What a round did, for comparison between runs.
+ */
+struct Outcome {
+    std::vector<std::int64_t> spawns; ///< Cell and escape time of every spawn, in order.
+    int score;                        ///< Points of the round.
+    long passes;                      ///< Loop passes.
+};
+
+/**
+ * @brief Plays one round, waking up late by up to @p maxLate for every deadline.
+ */
+Outcome play(const GameMode& mode, std::uint64_t seed, std::chrono::microseconds maxLate, Random& lateness) {
+    Outcome outcome{{}, 0, 0};
+    MoleEngine moles;
+    Random random(seed);
+    Clock::time_point start = Clock::time_point() + std::chrono::hours(1);
+    Clock::time_point end = start + kRoundLength;
+    Clock::time_point nextKey = start + kKeyPeriod;
+    moles.start(mode, start, kRoundLength);
+
+    auto advance = [&](Clock::time_point now) {
+        MoleEngine::Step step = moles.advance(now, random);
+        outcome.score += step.scoreDelta;
+        for (std::uint16_t spawned = step.spawned; spawned != 0; spawned &= spawned - 1) {
+            int cell = __builtin_ctz(spawned);
+            outcome.spawns.push_back(cell);
+            outcome.spawns.push_back((moles.getEscapeTime(cell) - start).count());
+        }
+    };
+
+    Clock::time_point now = start;
+    while (now < end) {
+        ++outcome.passes;
+        advance(now);
+        Clock::time_point deadline = std::min(moles.nextDeadline(), end);
+        if (nextKey <= deadline) {
+            // The key arrives on time and is applied after the moles are advanced to it
+            advance(nextKey);
+            std::uint16_t lit = moles.getMask();
+            outcome.score += moles.whack(lit ? __builtin_ctz(lit) : 0, nextKey).scoreDelta;
+            now = nextKey;
+            nextKey += kKeyPeriod;
+            continue;
+        }
+        std::chrono::microseconds late(maxLate.count() ? lateness.nextBelow(static_cast<std::uint32_t>(maxLate.count())) : 0);
+        now = std::min(deadline + late, nextKey);
+    }
+    return outcome;
+}
+
+/**
+ * @brief Whacks with keys older than the last advance and checks the verdicts.
+ *
+ * The first mole of a round is left to escape, and the engine is advanced 50 ms past the
+ * escape. A key at the escape time misses it, a key 1 ms before hits it and takes back the
+ * penalty, and a second such key misses. A key 1 ns before a later spawn misses that mole.
+ *
+ * @return True if every verdict is right.
+ */
+bool checkOldKeys(const GameMode& mode, std::uint64_t seed) {
+    MoleEngine moles;
+    Random random(seed);
+    Clock::time_point start = Clock::time_point() + std::chrono::hours(1);
+    moles.start(mode, start, kRoundLength);
+    moles.advance(start, random);
+    int first = __builtin_ctz(moles.getMask());
+    Clock::time_point escapesAt = moles.getEscapeTime(first);
+    Clock::time_point busyUntil = escapesAt + std::chrono::milliseconds(50);
+
+    int later = -1;
+    Clock::time_point laterAt;
+    while (moles.nextDeadline() <= busyUntil) {
+        Clock::time_point at = moles.nextDeadline();
+        MoleEngine::Step step = moles.advance(at, random);
+        auto fresh = static_cast<std::uint16_t>(step.spawned & ~step.escaped & ~(1u << first));
+        if (later < 0 && fresh) {
+            later = __builtin_ctz(fresh);
+            laterAt = at;
+        }
+    }
+    moles.advance(busyUntil, random);
+    std::uint32_t escapes = moles.getEscapes();
+
+    bool ok = later >= 0 && escapes >= 1 && !moles.whack(first, escapesAt).hit;
+    MoleEngine::Whack beforeEscape = moles.whack(first, escapesAt - std::chrono::milliseconds(1));
+    ok = ok && beforeEscape.hit && beforeEscape.scoreDelta == mode.hitPoints + mode.escapePenalty &&
+         beforeEscape.reaction == escapesAt - std::chrono::milliseconds(1) - start && moles.getEscapes() == escapes - 1;
+    ok = ok && !moles.whack(first, escapesAt - std::chrono::milliseconds(2)).hit;
+    ok = ok && !moles.whack(later, laterAt - std::chrono::nanoseconds(1)).hit;
+    return ok && moles.getHits() == 1 && moles.getMisses() == 3;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+    const std::chrono::microseconds lates[] = {std::chrono::microseconds(1000), std::chrono::microseconds(10000),
+                                               std::chrono::microseconds(50000)};
+    Random lateness(25);
+    bool allSame = true;
+    for (const GameMode& mode : kGameModes) {
+        long passes = 0;
+        long spawns = 0;
+        long score = 0;
+        int same[3] = {0, 0, 0};
+        for (int round = 0; round < rounds; ++round) {
+            Outcome exact = play(mode, 1000 + round, std::chrono::microseconds(0), lateness);
+            passes += exact.passes;
+            spawns += static_cast<long>(exact.spawns.size() / 2);
+            score += exact.score;
+            for (int i = 0; i < 3; ++i) {
+                Outcome late = play(mode, 1000 + round, lates[i], lateness);
+                same[i] += late.spawns == exact.spawns && late.score == exact.score;
+            }
+        }
+        double seconds = static_cast<double>(rounds) * kRoundLength.count();
+        std::printf("%-7s %6.1f passes/s  %5.1f spawns/s  mean score %6.1f  same round when late by "
+                    "<=1 ms %d/%d  <=10 ms %d/%d  <=50 ms %d/%d\n",
+                    mode.name, passes / seconds, spawns / seconds, static_cast<double>(score) / rounds,
+                    same[0], rounds, same[1], rounds, same[2], rounds);
+        allSame = allSame && same[0] == rounds && same[1] == rounds && same[2] == rounds;
+    }
+    std::printf("every round independent of wake-up delays: %s\n", allSame ? "ok" : "FAILED");
+
+    bool oldKeysOk = true;
+    for (const GameMode& mode : kGameModes) {
+        int right = 0;
+        for (int round = 0; round < rounds; ++round) {
+            right += checkOldKeys(mode, 1000 + round);
+        }
+        std::printf("%-7s keys older than the last advance judged at their own time %d/%d\n", mode.name, right,
+                    rounds);
+        oldKeysOk = oldKeysOk && right == rounds;
+    }
+    std::printf("old keys hit moles that escaped since and miss moles spawned since: %s\n",
+                oldKeysOk ? "ok" : "FAILED");
+    return allSame && oldKeysOk ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file event_queue_bench.cpp
+ * @brief Compares the GameEvent SpscQueue with a locked queue of heap-allocated calls.
+ *
+ * The locked path models a queued signal: every event allocates a callable and is handed
+ * over under a mutex, and the consumer runs it. The SpscQueue path copies a GameEvent into
+ * the ring. A producer thread publishes events while the consumer drains in batches, as
+ * the GUI timer does. Heap allocations are counted with a replaced operator new.
+ *
+ * Usage: event_queue_bench [events]
+ * @author Anubhav Aery
+ */
+
+#include "GameEvent.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace {
+
+std::atomic<long> allocations{0};
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Builds the n-th event of the stream.
+ */
+GameEvent makeEvent(long n) {
+    GameEvent event{};
+    event.type = GameEvent::Type::Score;
+    event.cell = -1;
+    event.score = static_cast<std::int32_t>(n);
+    return event;
+}
+
+/**
+ * @brief Prints the cost per event and the allocations of one strategy.
+ */
+void report(const char* name, long events, Clock::duration elapsed, long allocated, long checksum) {
+    std::chrono::duration<double, std::nano> total = elapsed;
+    std::printf("%-24s %8.2f ns/event  %6.2f allocations/event  (checksum %ld)\n", name, total.count() / events,
+                static_cast<double>(allocated) / events, checksum);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+int main(int argc, char* argv[]) {
+    long events = argc > 1 ? std::atol(argv[1]) : 2000000;
+
+    // Locked queue of callables, one allocation per event like a queued connection
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>*> queue;
+        long checksum = 0;
+        long before = allocations.load();
+        auto begin = Clock::now();
+        std::thread producer([&]() {
+            for (long n = 0; n < events; ++n) {
+                GameEvent event = makeEvent(n);
+                auto* call = new std::function<void()>([&checksum, event]() { checksum += event.score; });
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(call);
+            }
+        });
+        for (long received = 0; received < events;) {
+            std::function<void()>* call = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!queue.empty()) {
+                    call = queue.front();
+                    queue.pop_front();
+                }
+            }
+            if (call) {
+                (*call)();
+                delete call;
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        report("mutex + heap callable", events, Clock::now() - begin, allocations.load() - before, checksum);
+    }
+
+    {
+        static GameEventQueue queue;
+        long checksum = 0;
+        long before = allocations.load();
+        auto begin = Clock::now();
+        std::thread producer([&]() {
+            for (long n = 0; n < events; ++n) {
+                GameEvent event = makeEvent(n);
+                while (!queue.tryPush(event)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        long threadAllocations = allocations.load() - before;
+        for (long received = 0; received < events;) {
+            GameEvent event;
+            if (queue.tryPop(event)) {
+                checksum += event.score;
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        report("SpscQueue<GameEvent>", events, Clock::now() - begin,
+               allocations.load() - before - threadAllocations, checksum);
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file gpio_button_bench.cpp
+ * @brief Measures how late GPIO button edges reach the game loop, and what that does to their times.
+ *
+ * A thread plays the GPIO backend: buttons on two pins are pressed and released at random
+ * times, and the thread hands the edges to the InputEngine through a SimulatedGpioBackend,
+ * each with the time it happened. The first run delivers every edge as it happens, like an
+ * interrupt handler; the second delivers them in batches once a millisecond, like pigpio's
+ * alert thread. The main thread waits on the engine as GameController::inGame() does and
+ * records, for every event, how long after the edge it got it. That delay is what a press
+ * stamped on wake-up, as keys from the terminal are, would add to its reaction time; a
+ * button's event keeps the time of the edge instead, and the run checks that it does.
+ *
+ * Usage: gpio_button_bench [edges]
+ * @author Anubhav Aery
+ */
+
+#include "InputEngine.h"
+#include "SimulatedGpioBackend.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kPins[] = {4, 9}; ///< Button pins, on cells 0 and 1.
+
+/**
+ * @brief Presses and releases the buttons at random times.
+ *
+ * @param batch Period of the deliveries, or zero to deliver every edge as it happens.
+ */
+void pressButtons(SimulatedGpioBackend& board, int edges, std::chrono::microseconds batch) {
+    int levels[] = {1, 1};
+    Clock::time_point at = Clock::now();
+    Clock::time_point delivered = at;
+    for (int i = 0; i < edges; ++i) {
+        at += std::chrono::microseconds(200 + std::rand() % 2000);
+        if (batch.count() > 0) {
+            // The alert thread wakes up on its own period and reports what it has sampled
+            while (delivered < at) {
+                delivered += batch;
+            }
+        } else {
+            delivered = at;
+        }
+        std::this_thread::sleep_until(delivered);
+        int button = std::rand() % 2;
+        levels[button] ^= 1;
+        board.injectEdge(kPins[button], levels[button], batch.count() > 0 ? at : Clock::now());
+    }
+}
+
+/**
+ * @brief Runs one delivery mode and prints how late the events were seen.
+ */
+void run(const char* name, int edges, std::chrono::microseconds batch) {
+    SimulatedGpioBackend board;
+    InputEngine input;
+    std::array<int, LedLayout::kCellCount> buttonPins;
+    buttonPins.fill(-1);
+    buttonPins[0] = kPins[0];
+    buttonPins[1] = kPins[1];
+    if (!input.addGpioButtons(board, buttonPins)) {
+        std::fprintf(stderr, "The simulated board cannot watch buttons\n");
+        std::exit(1);
+    }
+
+    std::thread thread(pressButtons, std::ref(board), edges, batch);
+    std::vector<double> late;
+    late.reserve(edges);
+    long backwards = 0;
+    Clock::time_point previous;
+    while (static_cast<int>(late.size()) < edges) {
+        InputEvent event = input.waitForEvent(Clock::now() + std::chrono::seconds(5));
+        if (event.type == InputEvent::Type::Timeout) {
+            break;
+        }
+        if (event.type != InputEvent::Type::Key && event.type != InputEvent::Type::Release) {
+            continue;
+        }
+        Clock::time_point seen = Clock::now();
+        late.push_back(std::chrono::duration<double, std::micro>(seen - event.timestamp).count());
+        backwards += event.timestamp < previous;
+        previous = event.timestamp;
+    }
+    thread.join();
+
+    std::sort(late.begin(), late.end());
+    auto at = [&late](double share) { return late[static_cast<std::size_t>(share * (late.size() - 1))]; };
+    std::printf("%-22s %5zu/%d edges  seen after p50 %8.1f us  p99 %8.1f us  max %8.1f us  %ld out of order\n",
+                name, late.size(), edges, at(0.5), at(0.99), late.back(), backwards);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int edges = argc > 1 ? std::atoi(argv[1]) : 2000;
+    std::srand(24);
+    run("as they happen", edges, std::chrono::microseconds(0));
+    run("1 ms alert batches", edges, std::chrono::microseconds(1000));
+    return 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file input_conditioner_bench.cpp
+ * @brief Measures the InputConditioner at 10k events/s and checks what it drops.
+ *
+ * The load run feeds a stream of presses and releases on random cells, 10000 a second on
+ * a simulated clock, and reports the time per event and the share of one core it would
+ * take. The accuracy run plays labelled gestures, far enough apart not to overlap:
+ * button taps with contact bounce on press and release, terminal keys held down until
+ * they auto-repeat, and chords of two to six cells in the hard mode. It reports how many
+ * intended presses were dropped and how many unintended ones got through. The first
+ * repeat of a held terminal key is indistinguishable from a second press, so it counts as
+ * getting through.
+ *
+ * Usage: input_conditioner_bench [seconds of load]
+ * @author Anubhav Aery
+ */
+
+#include "GameMode.h"
+#include "InputConditioner.h"
+#include "LedLayout.h"
+#include "Random.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+using Clock = InputConditioner::Clock;
+
+constexpr long kEventsPerSecond = 10000; ///< Rate of the load run.
+
+/**
+ * @brief One input edge of the generated stream.
+ */
+struct Edge {
+    Clock::time_point at; ///< Time of the edge.
+    std::int8_t cell;     ///< Cell of the edge.
+    bool press;           ///< True for a press, false for a release.
+    bool intended;        ///< True if the player meant this press.
+};
+
+/**
+ * @brief Appends the edges of a button tap: a press and a release, each with some bounce.
+ */
+void tap(std::vector<Edge>& edges, Random& random, int cell, Clock::time_point at) {
+    edges.push_back({at, static_cast<std::int8_t>(cell), true, true});
+    for (std::uint32_t i = 0, n = random.nextBelow(4); i < n; ++i) {
+        edges.push_back({at + std::chrono::microseconds(500 + random.nextBelow(5000)), static_cast<std::int8_t>(cell), true, false});
+    }
+    Clock::time_point up = at + std::chrono::milliseconds(60 + random.nextBelow(80));
+    edges.push_back({up, static_cast<std::int8_t>(cell), false, false});
+    for (std::uint32_t i = 0, n = random.nextBelow(4); i < n; ++i) {
+        edges.push_back({up + std::chrono::microseconds(500 + random.nextBelow(5000)), static_cast<std::int8_t>(cell), true, false});
+    }
+}
+
+/**
+ * @brief Appends a terminal key held down: a press, then repeats after the typematic delay.
+ */
+void hold(std::vector<Edge>& edges, Random& random, int cell, Clock::time_point at) {
+    edges.push_back({at, static_cast<std::int8_t>(cell), true, true});
+    Clock::time_point repeat = at + std::chrono::milliseconds(250 + random.nextBelow(350));
+    for (std::uint32_t i = 0, n = 5 + random.nextBelow(20); i < n; ++i) {
+        edges.push_back({repeat, static_cast<std::int8_t>(cell), true, false});
+        repeat += std::chrono::milliseconds(33);
+    }
+}
+
+/**
+ * @brief Appends a chord: several cells pressed within a few milliseconds, as taps.
+ *
+ * @param limit Presses of the chord that are meant; the rest are mashing.
+ */
+void chord(std::vector<Edge>& edges, Random& random, int limit, Clock::time_point at) {
+    std::uint16_t used = 0;
+    int size = 2 + static_cast<int>(random.nextBelow(5));
+    for (int i = 0; i < size; ++i) {
+        int cell;
+        do {
+            cell = static_cast<int>(random.nextBelow(LedLayout::kCellCount));
+        } while (used & (1u << cell));
+        used |= static_cast<std::uint16_t>(1u << cell);
+        Clock::time_point pressAt = at + std::chrono::milliseconds(i * 4);
+        edges.push_back({pressAt, static_cast<std::int8_t>(cell), true, i < limit});
+        edges.push_back({pressAt + std::chrono::milliseconds(80), static_cast<std::int8_t>(cell), false, false});
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long seconds = argc > 1 ? std::atol(argv[1]) : 60;
+    Random random(23);
+    Clock::time_point start = Clock::time_point() + std::chrono::hours(1);
+
+    // Load: random edges, 10000 a second, three presses to one release
+    std::vector<Edge> load(static_cast<std::size_t>(seconds * kEventsPerSecond));
+    for (std::size_t i = 0; i < load.size(); ++i) {
+        load[i] = {start + std::chrono::microseconds(i * 1000000 / kEventsPerSecond),
+                   static_cast<std::int8_t>(random.nextBelow(LedLayout::kCellCount)), random.nextBelow(4) != 0, false};
+    }
+    InputConditioner conditioner;
+    conditioner.reset(gameMode(GameModeId::Hard).concurrentMoles);
+    std::uint64_t accepted = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (const Edge& edge : load) {
+        if (edge.press) {
+            accepted += conditioner.press(edge.cell, edge.at) == InputConditioner::Verdict::Accepted;
+        } else {
+            conditioner.release(edge.cell, edge.at);
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+    double perEvent = elapsed.count() / load.size();
+    std::printf("load      %ld events/s for %ld s  %6.2f ns/event  %.5f%% of a core  (%llu accepted)\n",
+                kEventsPerSecond, seconds, perEvent, perEvent * kEventsPerSecond / 1e7,
+                static_cast<unsigned long long>(accepted));
+
+    // Accuracy: labelled gestures, one every 2 s, after the longest repeat run has ended
+    int limit = gameMode(GameModeId::Hard).concurrentMoles;
+    std::vector<Edge> gestures;
+    long holds = 0;
+    for (int i = 0; i < 3000; ++i) {
+        Clock::time_point at = start + std::chrono::milliseconds(2000 * i);
+        switch (random.nextBelow(3)) {
+            case 0:
+                tap(gestures, random, static_cast<int>(random.nextBelow(LedLayout::kCellCount)), at);
+                break;
+            case 1:
+                ++holds;
+                hold(gestures, random, static_cast<int>(random.nextBelow(LedLayout::kCellCount)), at);
+                break;
+            default:
+                chord(gestures, random, limit, at);
+                break;
+        }
+    }
+    // The bounces and releases of a gesture overlap each other
+    std::stable_sort(gestures.begin(), gestures.end(), [](const Edge& a, const Edge& b) { return a.at < b.at; });
+    conditioner.reset(limit);
+    long intended = 0;
+    long dropped = 0;
+    long leaked = 0;
+    for (const Edge& edge : gestures) {
+        if (!edge.press) {
+            conditioner.release(edge.cell, edge.at);
+            continue;
+        }
+        bool accept = conditioner.press(edge.cell, edge.at) == InputConditioner::Verdict::Accepted;
+        intended += edge.intended;
+        dropped += edge.intended && !accept;
+        leaked += !edge.intended && accept;
+    }
+    std::printf("accuracy  %ld intended presses, %ld dropped; %ld unintended got through (%ld held keys)\n",
+                intended, dropped, leaked, holds);
+    std::printf("verdicts  accepted %llu  bounce %llu  repeat %llu  chord limit %llu  chords %llu\n",
+                static_cast<unsigned long long>(conditioner.getCount(InputConditioner::Verdict::Accepted)),
+                static_cast<unsigned long long>(conditioner.getCount(InputConditioner::Verdict::Bounce)),
+                static_cast<unsigned long long>(conditioner.getCount(InputConditioner::Verdict::Repeat)),
+                static_cast<unsigned long long>(conditioner.getCount(InputConditioner::Verdict::ChordLimit)),
+                static_cast<unsigned long long>(conditioner.getChords()));
+    return 0;
+}
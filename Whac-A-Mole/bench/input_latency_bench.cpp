@@ -0,0 +1,135 @@
+/**
+ * @file input_latency_bench.cpp
+ * @brief Measures how long a keystroke takes to register in the game loop.
+ *
+ * Synthetic keystrokes are written to the master side of a pseudo terminal while a
+ * reader thread waits on the slave side, exactly like GameController::inGame waits on
+ * stdin. The time between the write and the moment the reader sees the key is
+ * recorded for every keystroke and summarised as p50 and p99.
+ *
+ * Usage: input_latency_bench [samples]
+ * @author Anubhav Aery
+ */
+
+#include "InputEngine.h"
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+std::atomic<Clock::rep> sentAt{0};     ///< Time the current keystroke was written.
+std::atomic<Clock::rep> receivedAt{0}; ///< Time the reader registered it, 0 while pending.
+
+/**
+ * @brief Reader loop using the event-driven InputEngine.
+ */
+void engineReader(int fd, int samples) {
+    InputEngine input;
+    input.addTerminal(fd);
+    for (int i = 0; i < samples;) {
+        InputEvent event = input.waitForEvent(Clock::now() + std::chrono::seconds(5));
+        if (event.type == InputEvent::Type::Key) {
+            receivedAt.store(event.timestamp.time_since_epoch().count());
+            ++i;
+        }
+    }
+}
+
+/**
+ * @brief Reader loop reproducing the previous read-then-sleep(100 ms) polling.
+ */
+void pollingReader(int fd, int samples) {
+    for (int i = 0; i < samples;) {
+        unsigned char key;
+        if (read(fd, &key, 1) == 1) {
+            receivedAt.store(Clock::now().time_since_epoch().count());
+            ++i;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+/**
+ * @brief Injects keystrokes and collects their registration latency in microseconds.
+ */
+std::vector<double> run(void (*reader)(int, int), int samples, bool nonBlocking, int maxGapUs) {
+    int master = -1;
+    int slave = -1;
+    if (openpty(&master, &slave, nullptr, nullptr, nullptr) < 0) {
+        std::perror("openpty");
+        std::exit(1);
+    }
+    termios mode;
+    tcgetattr(slave, &mode);
+    cfmakeraw(&mode);
+    if (nonBlocking) {
+        mode.c_cc[VMIN] = 0;
+        mode.c_cc[VTIME] = 0;
+    }
+    tcsetattr(slave, TCSANOW, &mode);
+
+    std::thread thread(reader, slave, samples);
+    std::vector<double> latencies;
+    latencies.reserve(samples);
+    for (int i = 0; i < samples; ++i) {
+        // Stagger keystrokes so they land at arbitrary points of the reader's cycle
+        std::this_thread::sleep_for(std::chrono::microseconds(200 + std::rand() % maxGapUs));
+        receivedAt.store(0);
+        sentAt.store(Clock::now().time_since_epoch().count());
+        const char key = 'g';
+        if (write(master, &key, 1) != 1) {
+            std::perror("write");
+            std::exit(1);
+        }
+        while (receivedAt.load() == 0) {
+            std::this_thread::yield();
+        }
+        Clock::duration latency(receivedAt.load() - sentAt.load());
+        latencies.push_back(std::chrono::duration<double, std::micro>(latency).count());
+    }
+    thread.join();
+    close(master);
+    close(slave);
+    return latencies;
+}
+
+/**
+ * @brief Prints the median and 99th percentile of a latency sample.
+ */
+void report(const char* name, std::vector<double> latencies) {
+    if (latencies.empty()) {
+        std::printf("%-22s no samples\n", name);
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+    };
+    std::printf("%-22s samples=%-6zu p50=%10.1f us  p99=%10.1f us\n",
+                name, latencies.size(), percentile(0.50), percentile(0.99));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int samples = argc > 1 ? std::atoi(argv[1]) : 2000;
+    if (samples < 1) {
+        std::fprintf(stderr, "Usage: input_latency_bench [samples], with at least one sample\n");
+        return 1;
+    }
+    std::srand(42);
+    report("epoll InputEngine", run(engineReader, samples, false, 1000));
+    // The polling loop needs ~100 ms per keystroke, so it gets a smaller sample
+    report("getch + sleep(100 ms)", run(pollingReader, std::max(1, samples / 40), true, 100000));
+    return 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file leaderboard_bench.cpp
+ * @brief Compares the old multimap high score table with the bounded Leaderboard.
+ *
+ * A season of scores is fed to both. The multimap path is what HighScore used to do: insert
+ * every score as a node and copy the whole map into a vector to show the table. The
+ * Leaderboard keeps the best K in fixed storage and is read through its iterators; it is
+ * measured both with every score and with one entry per player.
+ *
+ * Usage: leaderboard_bench [scores] [K]
+ * @author Eseosa Emmanuel Atekha
+ */
+
+#include "Leaderboard.h"
+#include "Random.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Prints the cost per score of one strategy.
+ */
+void report(const char* name, long scores, Clock::duration elapsed, long checksum) {
+    std::chrono::duration<double, std::nano> total = elapsed;
+    std::printf("%-28s %8.2f ns/score  %9.3f ms total  (checksum %ld)\n", name, total.count() / scores,
+                total.count() / 1e6, checksum);
+}
+
+/**
+ * @brief Feeds every score to a leaderboard and reads the table once per 1000 scores.
+ */
+long runLeaderboard(Leaderboard& board, const std::vector<ScoreRecord>& records) {
+    long checksum = 0;
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        board.offer(records[i]);
+        if (i % 1000 == 999) {
+            int shown = 0;
+            for (auto it = board.begin(); it != board.end() && shown < 10; ++it, ++shown) {
+                checksum += it->score;
+            }
+        }
+    }
+    return checksum;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long scores = argc > 1 ? std::atol(argv[1]) : 100000;
+    std::size_t k = argc > 2 ? static_cast<std::size_t>(std::atol(argv[2])) : 10;
+
+    Random random(7);
+    std::vector<ScoreRecord> records;
+    records.reserve(scores);
+    for (long i = 0; i < scores; ++i) {
+        records.push_back(ScoreRecord::make(static_cast<int>(random.nextBelow(200)),
+                                            "player" + std::to_string(random.nextBelow(5000)),
+                                            static_cast<std::uint32_t>(i)));
+    }
+
+    // Old path: every score becomes a multimap node, the whole map is copied to show the table
+    auto begin = Clock::now();
+    std::multimap<int, std::string, std::greater<int>> highScoresMap;
+    long checksum = 0;
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        highScoresMap.insert(std::make_pair(records[i].score, records[i].getName()));
+        if (i % 1000 == 999) {
+            std::vector<std::pair<int, std::string>> table(highScoresMap.begin(), highScoresMap.end());
+            for (std::size_t row = 0; row < table.size() && row < 10; ++row) {
+                checksum += table[row].first;
+            }
+        }
+    }
+    report("multimap + copy", scores, Clock::now() - begin, checksum);
+
+    Leaderboard board(k);
+    begin = Clock::now();
+    checksum = runLeaderboard(board, records);
+    report("Leaderboard", scores, Clock::now() - begin, checksum);
+
+    Leaderboard perPlayer(k, true);
+    begin = Clock::now();
+    checksum = runLeaderboard(perPlayer, records);
+    report("Leaderboard, best per player", scores, Clock::now() - begin, checksum);
+    return 0;
+}
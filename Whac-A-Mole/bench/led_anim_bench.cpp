@@ -0,0 +1,111 @@
+/**
+ * @file led_anim_bench.cpp
+ * @brief Measures what animating the LED matrix with the LedAnimator costs the CPU.
+ *
+ * All 16 cells play the attract sweep, each column a little later than the one to its left,
+ * on a SimulatedGpioBackend. The first run drives a simulated clock one animation frame at
+ * a time and reports the time per update and the duty cycles written per second of
+ * animation. The second run plays in real time, sleeping between frames as
+ * GameController::attract() does, and reports the CPU time used as a share of the wall
+ * time. The curve kernel alone is timed too.
+ *
+ * Usage: led_anim_bench [seconds of animation]
+ * @author Anubhav Aery
+ */
+
+#include "LedAnimator.h"
+#include "LedCurve.h"
+#include "LedFrameBuffer.h"
+#include "LedLayout.h"
+#include "SimulatedGpioBackend.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::chrono::milliseconds kColumnDelay{150}; ///< Same as GameController::kAttractColumnDelay.
+
+/**
+ * @brief Starts the sweep on every cell.
+ */
+void playSweep(LedAnimator& animator, Clock::time_point start) {
+    for (int cell = 0; cell < LedLayout::kCellCount; ++cell) {
+        animator.play(cell, kAttractSweep, start + (cell % 4) * kColumnDelay);
+    }
+}
+
+/**
+ * @brief CPU time used by the process so far.
+ */
+std::chrono::nanoseconds cpuTime() {
+    timespec now{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::chrono::seconds length(argc > 1 ? std::atol(argv[1]) : 3);
+
+    // The kernel: one curve evaluated at every millisecond of many loops
+    constexpr std::uint32_t kEvaluations = 10000000;
+    std::uint32_t sum = 0;
+    auto begin = Clock::now();
+    for (std::uint32_t ms = 0; ms < kEvaluations; ++ms) {
+        sum += kAttractSweep.level(ms);
+    }
+    std::chrono::duration<double, std::nano> kernel = Clock::now() - begin;
+    std::printf("curve kernel        %7.2f ns/evaluation  (checksum %u)\n", kernel.count() / kEvaluations, sum);
+
+    // Simulated clock: every frame of the animation, back to back
+    {
+        SimulatedGpioBackend board;
+        board.setRecording(false);
+        LedFrameBuffer frame;
+        frame.setBackend(&board);
+        LedAnimator animator(frame);
+        animator.setBackend(&board);
+        Clock::time_point start = Clock::time_point() + std::chrono::hours(1);
+        playSweep(animator, start);
+        long frames = 0;
+        begin = Clock::now();
+        for (Clock::time_point now = start; now < start + length; now = animator.nextFrame()) {
+            animator.update(now);
+            ++frames;
+        }
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - begin;
+        std::printf("simulated clock     %7.2f ns/update  %5.1f updates/s  %6.1f duty cycles written/s\n",
+                    elapsed.count() / frames, static_cast<double>(frames) / length.count(),
+                    static_cast<double>(board.getPwmWrites()) / length.count());
+    }
+
+    // Real time: sleep between frames and compare CPU time with wall time
+    {
+        SimulatedGpioBackend board;
+        board.setRecording(false);
+        LedFrameBuffer frame;
+        frame.setBackend(&board);
+        LedAnimator animator(frame);
+        animator.setBackend(&board);
+        Clock::time_point start = Clock::now();
+        Clock::time_point end = start + length;
+        playSweep(animator, start);
+        std::chrono::nanoseconds cpuBefore = cpuTime();
+        for (Clock::time_point now = start; now < end; now = Clock::now()) {
+            animator.update(now);
+            std::this_thread::sleep_until(std::min(end, animator.nextFrame()));
+        }
+        std::chrono::duration<double> cpu = cpuTime() - cpuBefore;
+        std::chrono::duration<double> wall = Clock::now() - start;
+        std::printf("real time           %7.3f%% CPU over %.1f s\n", 100.0 * cpu.count() / wall.count(),
+                    wall.count());
+    }
+    return 0;
+}
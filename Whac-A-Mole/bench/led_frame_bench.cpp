@@ -0,0 +1,78 @@
+/**
+ * @file led_frame_bench.cpp
+ * @brief Compares per-pin LED writes with batched LedFrameBuffer flushes.
+ *
+ * A multi-mole game is simulated: every tick a random number of cells switches on or off.
+ * The per-pin path issues one write per changed LED, as the game did with gpioWrite();
+ * the frame path stages the changes and flushes one set/clear pair. Both run against the
+ * CountingGpioBackend, which reports the register writes the hardware would have seen.
+ *
+ * Usage: led_frame_bench [ticks]
+ * @author Anubhav Aery
+ */
+
+#include "CountingGpioBackend.h"
+#include "LedFrameBuffer.h"
+#include "LedLayout.h"
+#include "Random.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Prints the register writes and time per tick of one strategy.
+ */
+void report(const char* name, const CountingGpioBackend& backend, long ticks,
+            std::chrono::steady_clock::duration elapsed, std::uint32_t levels) {
+    std::chrono::duration<double, std::nano> total = elapsed;
+    std::printf("%-20s %6.2f register writes/tick  %7.2f ns/tick  (final levels %08x)\n",
+                name, static_cast<double>(backend.getRegisterWrites()) / ticks,
+                total.count() / ticks, levels);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long ticks = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+    // Pre-generate the frames so both strategies replay exactly the same sequence
+    std::vector<std::uint16_t> frames(ticks);
+    Random random(2024);
+    std::uint16_t frame = 0;
+    for (auto& entry : frames) {
+        int changes = 1 + static_cast<int>(random.nextBelow(8));
+        for (int i = 0; i < changes; ++i) {
+            frame ^= static_cast<std::uint16_t>(1u << random.nextBelow(LedLayout::kCellCount));
+        }
+        entry = frame;
+    }
+
+    CountingGpioBackend perPin;
+    std::uint16_t shown = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (std::uint16_t next : frames) {
+        std::uint16_t changed = next ^ shown;
+        for (int cell = 0; cell < LedLayout::kCellCount; ++cell) {
+            if (changed & (1u << cell)) {
+                perPin.write(kLedLayout.cellToPin[cell], (next >> cell) & 1);
+            }
+        }
+        shown = next;
+    }
+    report("per-pin gpioWrite", perPin, ticks, std::chrono::steady_clock::now() - begin, perPin.getLevels());
+
+    CountingGpioBackend batched;
+    LedFrameBuffer buffer;
+    buffer.setBackend(&batched);
+    begin = std::chrono::steady_clock::now();
+    for (std::uint16_t next : frames) {
+        buffer.setMask(next);
+        buffer.flush();
+    }
+    report("LedFrameBuffer", batched, ticks, std::chrono::steady_clock::now() - begin, batched.getLevels());
+    return 0;
+}
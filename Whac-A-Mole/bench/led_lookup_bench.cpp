@@ -0,0 +1,96 @@
+/**
+ * @file led_lookup_bench.cpp
+ * @brief Compares the unordered_map key lookups with the flat LedLayout tables.
+ *
+ * Three operations from the game loop are measured on both paths: resolving a keystroke
+ * to a pin (count() + at() before, one table load now), picking the pin of the N-th cell
+ * (walking the hash buckets before, one array load now) and mapping a pin back to its cell.
+ *
+ * Usage: led_lookup_bench [iterations]
+ * @author Anubhav Aery
+ */
+
+#include "LedLayout.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+volatile int sink; ///< Keeps results alive so the measured calls are not optimised out.
+
+/**
+ * @brief Runs a callable over a prepared input sequence and prints its mean cost.
+ */
+template <typename F>
+void measure(const char* name, const std::vector<int>& inputs, long iterations, F&& f) {
+    auto begin = std::chrono::steady_clock::now();
+    int acc = 0;
+    for (long i = 0; i < iterations; ++i) {
+        acc += f(inputs[i & (inputs.size() - 1)]);
+    }
+    sink = acc;
+    std::chrono::duration<double, std::nano> total = std::chrono::steady_clock::now() - begin;
+    std::printf("%-34s %8.2f ns/op\n", name, total.count() / iterations);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? std::atol(argv[1]) : 20000000;
+
+    // The map exactly as LEDMatrix used to build it
+    const std::unordered_map<char, int> keyToLedMap = {
+            {'4', 15}, {'5', 24}, {'6', 8}, {'7', 20},
+            {'r', 14}, {'t', 23}, {'y', 7}, {'u', 21},
+            {'f', 3}, {'g', 17}, {'h', 5}, {'j', 19},
+            {'v', 2}, {'b', 27}, {'n', 6}, {'m', 26}
+    };
+
+    // Mostly matrix keys with some strays, as typed by a player
+    std::vector<int> keys(4096);
+    std::vector<int> cells(4096);
+    std::vector<int> pins(4096);
+    std::srand(7);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        int cell = std::rand() % LedLayout::kCellCount;
+        keys[i] = std::rand() % 8 == 0 ? 'a' + std::rand() % 26 : kLedLayout.cellToKey[cell];
+        cells[i] = cell;
+        pins[i] = kLedLayout.cellToPin[cell];
+    }
+
+    measure("key->pin  unordered_map count+at", keys, iterations, [&keyToLedMap](int key) {
+        return keyToLedMap.count(static_cast<char>(key)) > 0 ? keyToLedMap.at(static_cast<char>(key)) : -1;
+    });
+    measure("key->pin  LedLayout", keys, iterations, [](int key) {
+        int cell = kLedLayout.cellForKey(key);
+        return cell == LedLayout::kNoCell ? -1 : kLedLayout.cellToPin[cell];
+    });
+
+    measure("cell->pin unordered_map walk", cells, iterations, [&keyToLedMap](int index) {
+        for (const auto& led : keyToLedMap) {
+            if (index-- == 0) {
+                return led.second;
+            }
+        }
+        return -1;
+    });
+    measure("cell->pin LedLayout", cells, iterations, [](int cell) {
+        return kLedLayout.cellToPin[cell];
+    });
+
+    measure("pin->cell unordered_map scan", pins, iterations, [&keyToLedMap](int pin) {
+        for (const auto& led : keyToLedMap) {
+            if (led.second == pin) {
+                return static_cast<int>(kLedLayout.cellForKey(led.first));
+            }
+        }
+        return -1;
+    });
+    measure("pin->cell LedLayout", pins, iterations, [](int pin) {
+        return kLedLayout.cellForPin(pin);
+    });
+    return 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file led_wave_bench.cpp
+ * @brief Measures how late the LEDs change after a mole deadline, with and without waveforms.
+ *
+ * A round of the selected mode runs in real time on a SimulatedGpioBackend, with no
+ * player, so every LED change is a spawn or an escape due at a known deadline. The write
+ * path sleeps until each deadline and writes the new frame when it wakes up, as the game
+ * did before waveforms; the LEDs change late by the wake-up latency. The wave path runs
+ * the loop of GameController::inGame(): the frames of the coming deadlines are compiled
+ * into a pulse list, and the simulated board replays it, logging each transition at the
+ * time the DMA engine would make it. The error of every transition is the distance between
+ * its logged time and the deadline it belongs to. The wave path also checks after every pass that the
+ * board shows the frame the loop expects.
+ *
+ * Usage: led_wave_bench [seconds per path] [mode]
+ * @author Anubhav Aery
+ */
+
+#include "GameMode.h"
+#include "LedFrameBuffer.h"
+#include "LedWaveform.h"
+#include "MoleEngine.h"
+#include "Random.h"
+#include "SimulatedGpioBackend.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::chrono::milliseconds kHorizon{500}; ///< Same as GameController::kWaveHorizon.
+
+/**
+ * @brief Prints how far every transition is from the deadline it belongs to.
+ */
+void report(const char* name, const std::vector<PinTransition>& transitions, std::vector<Clock::time_point> deadlines,
+            std::uint64_t registerWrites, std::uint64_t waves) {
+    std::sort(deadlines.begin(), deadlines.end());
+    std::vector<double> late;
+    for (const PinTransition& transition : transitions) {
+        auto after = std::upper_bound(deadlines.begin(), deadlines.end(), transition.time);
+        if (after == deadlines.begin()) {
+            continue; // The frame written when the board was attached
+        }
+        double error = std::chrono::duration<double, std::micro>(transition.time - *(after - 1)).count();
+        if (after != deadlines.end()) {
+            // Wave offsets are rounded to the microsecond, so a pulse may fire just before its step
+            error = std::min(error, std::chrono::duration<double, std::micro>(*after - transition.time).count());
+        }
+        late.push_back(error);
+    }
+    if (late.empty()) {
+        std::printf("%-8s no transitions\n", name);
+        return;
+    }
+    std::sort(late.begin(), late.end());
+    auto at = [&late](double share) { return late[static_cast<std::size_t>(share * (late.size() - 1))]; };
+    std::printf("%-8s %5zu transitions  off by p50 %8.2f us  p99 %8.2f us  max %8.2f us  %6llu register writes  %5llu waves\n",
+                name, late.size(), at(0.5), at(0.99), late.back(), static_cast<unsigned long long>(registerWrites),
+                static_cast<unsigned long long>(waves));
+}
+
+/**
+ * @brief Runs a round that writes each frame when the loop wakes up for its deadline.
+ */
+void runWrites(const GameMode& mode, std::chrono::seconds length) {
+    SimulatedGpioBackend board;
+    LedFrameBuffer frame;
+    frame.setBackend(&board);
+    frame.forceFlush();
+    MoleEngine moles;
+    Random random(7);
+    std::vector<Clock::time_point> deadlines;
+
+    Clock::time_point begin = Clock::now();
+    Clock::time_point end = begin + length;
+    moles.start(mode, begin, length);
+    while (Clock::now() < end) {
+        moles.advance(Clock::now(), random);
+        frame.setMask(moles.getMask());
+        frame.flush();
+        Clock::time_point deadline = std::min(moles.nextDeadline(), end);
+        deadlines.push_back(deadline);
+        std::this_thread::sleep_until(deadline);
+    }
+    report("writes", board.getTransitions(), deadlines, board.getRegisterWrites(), 0);
+}
+
+/**
+ * @brief Runs a round that schedules the coming frames on a waveform, like GameController.
+ *
+ * @return The number of passes after which the board did not show the expected frame.
+ */
+long runWaves(const GameMode& mode, std::chrono::seconds length) {
+    SimulatedGpioBackend board;
+    LedFrameBuffer frame;
+    frame.setBackend(&board);
+    frame.forceFlush();
+    LedWaveform waveform;
+    waveform.setBackend(&board);
+    MoleEngine moles;
+    Random random(7);
+    std::vector<Clock::time_point> deadlines;
+    long mismatches = 0;
+
+    Clock::time_point begin = Clock::now();
+    Clock::time_point end = begin + length;
+    moles.start(mode, begin, length);
+    while (Clock::now() < end) {
+        Clock::time_point now = Clock::now();
+        LedStep fired;
+        while (waveform.popFired(now, fired)) {
+            frame.assumeShown(fired.cells);
+            moles.advance(fired.at, random);
+            deadlines.push_back(fired.at);
+            frame.setMask(moles.getMask());
+            frame.flush();
+        }
+        if (moles.nextDeadline() <= now) {
+            deadlines.push_back(moles.nextDeadline()); // Missed by the wave, written late
+        }
+        moles.advance(now, random);
+        frame.setMask(moles.getMask());
+        frame.flush();
+        board.replayWave(now);
+        if (board.getLevels() != LedFrameBuffer::toPinMask(frame.getShownMask())) {
+            ++mismatches;
+        }
+
+        // The scheduling pass of GameController::scheduleWave()
+        LedStep steps[LedWaveform::kMaxSteps];
+        std::size_t count = 0;
+        MoleEngine preview = moles;
+        Random previewRandom = random;
+        Clock::time_point horizon = std::min(end, now + kHorizon);
+        while (count < LedWaveform::kMaxSteps) {
+            Clock::time_point at = preview.nextDeadline();
+            if (at <= now || at >= horizon) {
+                break;
+            }
+            preview.advance(at, previewRandom);
+            steps[count++] = LedStep{at, preview.getMask()};
+        }
+        waveform.schedule(frame.getShownMask(), steps, count);
+        std::this_thread::sleep_until(std::min(moles.nextDeadline(), end));
+    }
+    waveform.cancel();
+    report("waves", board.getTransitions(), deadlines, board.getRegisterWrites(), waveform.getWavesSent());
+    return mismatches;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::chrono::seconds length(argc > 1 ? std::atol(argv[1]) : 5);
+    const GameMode* mode = findGameMode(argc > 2 ? argv[2] : "hard");
+    if (!mode) {
+        std::fprintf(stderr, "Unknown game mode\n");
+        return 1;
+    }
+
+    runWrites(*mode, length);
+    long mismatches = runWaves(*mode, length);
+    std::printf("board matched the expected frame after every pass: %s\n", mismatches == 0 ? "ok" : "FAILED");
+    return mismatches == 0 ? 0 : 1;
+}
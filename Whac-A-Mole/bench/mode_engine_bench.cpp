@@ -0,0 +1,113 @@
+/**
+ * @file mode_engine_bench.cpp
+ * @brief Runs every GameMode headless through the MoleEngine.
+ *
+ * Each mode plays back-to-back 30 second rounds on a simulated clock that advances 1 ms per
+ * tick. Every tick advances the engine, shows its cell mask through an LedFrameBuffer on the
+ * CountingGpioBackend and, when the simulated player is due, whacks a cell: usually a lit
+ * one after a reaction time of 250-450 ms, sometimes a wrong one. The report gives the cost
+ * of a tick, the outcome of the rounds and the register writes the LEDs would have seen.
+ *
+ * Usage: mode_engine_bench [ticks]
+ * @author Anubhav Aery
+ */
+
+#include "CountingGpioBackend.h"
+#include "GameMode.h"
+#include "LedFrameBuffer.h"
+#include "MoleEngine.h"
+#include "Random.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::chrono::milliseconds kTick{1};
+constexpr std::chrono::seconds kRoundLength{30};
+
+/**
+ * @brief Picks one set bit of a non-empty mask.
+ */
+int anyCell(std::uint16_t mask, Random& random) {
+    std::uint32_t skip = random.nextBelow(static_cast<std::uint32_t>(__builtin_popcount(mask)));
+    for (; skip > 0; --skip) {
+        mask &= static_cast<std::uint16_t>(mask - 1);
+    }
+    return __builtin_ctz(mask);
+}
+
+/**
+ * @brief Plays one mode for the given number of ticks and prints the results.
+ */
+void run(const GameMode& mode, long ticks) {
+    CountingGpioBackend backend;
+    backend.initialise();
+    LedFrameBuffer frame;
+    frame.setBackend(&backend);
+
+    MoleEngine engine;
+    Random spawns(1);
+    Random player(2);
+    Clock::time_point now{};
+    Clock::time_point roundEnd = now + kRoundLength;
+    Clock::time_point nextWhack = now + std::chrono::milliseconds(250 + player.nextBelow(200));
+    engine.start(mode, now, kRoundLength);
+
+    long rounds = 1;
+    long score = 0;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t escapes = 0;
+
+    Clock::time_point started = Clock::now();
+    for (long tick = 0; tick < ticks; ++tick) {
+        now += kTick;
+        if (now >= roundEnd) {
+            hits += engine.getHits();
+            misses += engine.getMisses();
+            escapes += engine.getEscapes();
+            engine.start(mode, now, kRoundLength);
+            roundEnd = now + kRoundLength;
+            ++rounds;
+        }
+        MoleEngine::Step step = engine.advance(now, spawns);
+        score += step.scoreDelta;
+        if (now >= nextWhack) {
+            std::uint16_t lit = engine.getMask();
+            int cell = lit != 0 && player.nextBelow(10) != 0 ? anyCell(lit, player)
+                                                             : static_cast<int>(player.nextBelow(LedLayout::kCellCount));
+            score += engine.whack(cell, now).scoreDelta;
+            nextWhack = now + std::chrono::milliseconds(250 + player.nextBelow(200));
+        }
+        frame.setMask(engine.getMask());
+        frame.flush();
+    }
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - started;
+    hits += engine.getHits();
+    misses += engine.getMisses();
+    escapes += engine.getEscapes();
+
+    std::printf("%-8s %6.2f ns/tick  %5ld rounds  %8llu hits  %7llu misses  %7llu escapes  %6.3f writes/tick  "
+                "(score %ld)\n",
+                mode.name, elapsed.count() / ticks, rounds, static_cast<unsigned long long>(hits),
+                static_cast<unsigned long long>(misses), static_cast<unsigned long long>(escapes),
+                static_cast<double>(backend.getRegisterWrites()) / ticks, score);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long ticks = argc > 1 ? std::atol(argv[1]) : 1000000;
+    if (ticks <= 0) {
+        std::fprintf(stderr, "Usage: %s [ticks]\n", argv[0]);
+        return 1;
+    }
+    std::printf("%ld ticks of %lld ms per mode\n", ticks, static_cast<long long>(kTick.count()));
+    for (const GameMode& mode : kGameModes) {
+        run(mode, ticks);
+    }
+    return 0;
+}
@@ -0,0 +1,188 @@
+/**
+ * @file replay_bench.cpp
+ * @brief Records simulated rounds with the GameRecorder and replays them at maximum speed.
+ *
+ * The recording side runs the same loop as GameController::inGame() on a simulated clock:
+ * advance the MoleEngine, wake at the next key, tick or mole deadline, and whack. A simulated
+ * player presses a key every 250-450 ms, usually on a lit cell. Every round is recorded, and
+ * the log is then replayed with the GameReplayer. The replayed scores must be identical to
+ * the scores of the recording; the benchmark fails otherwise.
+ *
+ * With --replay, an existing log, for example one written with WHAC_RECORD, is replayed
+ * instead and every round is printed; --realtime replays it at its recorded pace.
+ *
+ * Usage: replay_bench [games] [log path]
+ *        replay_bench --replay <log path> [--realtime]
+ * @author Anubhav Aery
+ */
+
+#include "GameMode.h"
+#include "GameRecorder.h"
+#include "GameReplayer.h"
+#include "LedLayout.h"
+#include "MoleEngine.h"
+#include "Player.h"
+#include "Random.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::chrono::seconds kRoundLength{30};
+constexpr std::chrono::milliseconds kTickInterval{100};
+
+/**
+ * @brief Time until the simulated player's next key.
+ */
+Clock::duration reactionTime(Random& random) {
+    return std::chrono::milliseconds(250 + random.nextBelow(200)) + std::chrono::microseconds(random.nextBelow(1000));
+}
+
+/**
+ * @brief Picks the key the simulated player presses: a lit cell nine times out of ten.
+ */
+int pickKey(std::uint16_t lit, Random& random) {
+    if (random.nextBelow(50) == 0) {
+        return 'z'; // Not on the matrix
+    }
+    int cell = static_cast<int>(random.nextBelow(LedLayout::kCellCount));
+    if (lit != 0 && random.nextBelow(10) != 0) {
+        std::uint32_t skip = random.nextBelow(static_cast<std::uint32_t>(__builtin_popcount(lit)));
+        for (; skip > 0; --skip) {
+            lit &= static_cast<std::uint16_t>(lit - 1);
+        }
+        cell = __builtin_ctz(lit);
+    }
+    return kLedLayout.cellToKey[cell];
+}
+
+/**
+ * @brief Plays and records one round in the way GameController::inGame() does.
+ *
+ * @return The final score.
+ */
+int playRound(GameRecorder& recorder, const GameMode& mode, std::uint64_t seed, Clock::time_point start,
+              Random& playerRandom) {
+    MoleEngine moles;
+    Random random(seed);
+    Player player;
+    moles.start(mode, start, kRoundLength);
+    recorder.beginRound(seed, mode, kRoundLength, start, player.getScore());
+
+    Clock::time_point end = start + kRoundLength;
+    Clock::time_point nextTick = start + kTickInterval;
+    Clock::time_point nextKey = start + reactionTime(playerRandom);
+    Clock::time_point now = start;
+    while (now < end) {
+        MoleEngine::Step step = moles.advance(now, random);
+        recorder.recordAdvance(now, step.spawned);
+        player.addPoints(step.scoreDelta);
+
+        now = std::min({end, moles.nextDeadline(), nextTick, nextKey});
+        if (now >= end) {
+            break;
+        }
+        if (now == nextKey) {
+            int key = pickKey(moles.getMask(), playerRandom);
+            recorder.recordKey(now, key);
+            int cell = kLedLayout.cellForKey(key);
+            if (cell != LedLayout::kNoCell) {
+                player.addPoints(moles.whack(cell, now).scoreDelta);
+            }
+            nextKey = now + reactionTime(playerRandom);
+        } else if (now == nextTick) {
+            recorder.recordTick(now);
+            nextTick += kTickInterval;
+        }
+    }
+    recorder.endRound(player.getScore());
+    return player.getScore();
+}
+
+/**
+ * @brief Replays a log and prints every round.
+ */
+int replayLog(const char* path, GameReplayer::Speed speed) {
+    GameReplayer replayer(speed);
+    if (!replayer.open(path)) {
+        return 1;
+    }
+    ReplayedGame game;
+    long rounds = 0;
+    long mismatches = 0;
+    while (replayer.next(game)) {
+        ++rounds;
+        mismatches += game.matches() ? 0 : 1;
+        std::printf("%5ld  %-8s seed %016llx  score %4d (recorded %4d)  %4u hits  %3u misses  %3u escapes  %s\n",
+                    rounds, game.mode.c_str(), static_cast<unsigned long long>(game.seed), game.score,
+                    game.recordedScore, game.hits, game.misses, game.escapes, game.matches() ? "ok" : "DIVERGED");
+    }
+    return replayer.atEnd() && mismatches == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && std::strcmp(argv[1], "--replay") == 0) {
+        bool realTime = argc > 3 && std::strcmp(argv[3], "--realtime") == 0;
+        return replayLog(argv[2], realTime ? GameReplayer::Speed::RealTime : GameReplayer::Speed::Maximum);
+    }
+
+    long games = argc > 1 ? std::atol(argv[1]) : 10000;
+    std::string path = argc > 2 ? argv[2] : "replay_bench.wrec";
+    if (games <= 0) {
+        std::fprintf(stderr, "Usage: %s [games] [log path]\n       %s --replay <log path> [--realtime]\n", argv[0],
+                     argv[0]);
+        return 1;
+    }
+    std::remove(path.c_str());
+
+    GameRecorder recorder;
+    if (!recorder.open(path)) {
+        return 1;
+    }
+    Random seeds(42);
+    Random playerRandom(7);
+    std::vector<int> scores;
+    scores.reserve(static_cast<std::size_t>(games));
+    std::size_t bytes = 0;
+    Clock::time_point started = Clock::now();
+    for (long i = 0; i < games; ++i) {
+        const GameMode& mode = kGameModes[i % std::size(kGameModes)];
+        Clock::time_point start = Clock::time_point(std::chrono::hours(1) + i * std::chrono::minutes(1));
+        scores.push_back(playRound(recorder, mode, seeds.next(), start, playerRandom));
+        bytes += recorder.getRoundBytes();
+    }
+    recorder.close();
+    std::chrono::duration<double> recordTime = Clock::now() - started;
+
+    GameReplayer replayer;
+    if (!replayer.open(path)) {
+        return 1;
+    }
+    ReplayedGame game;
+    long replayed = 0;
+    long mismatches = 0;
+    started = Clock::now();
+    while (replayer.next(game)) {
+        if (!game.matches() || replayed >= games || game.score != scores[static_cast<std::size_t>(replayed)]) {
+            ++mismatches;
+        }
+        ++replayed;
+    }
+    std::chrono::duration<double> replayTime = Clock::now() - started;
+    std::remove(path.c_str());
+
+    std::printf("recorded %ld rounds in %.3f s, %.1f bytes/round (%.2f MB)\n", games, recordTime.count(),
+                static_cast<double>(bytes) / games, bytes / 1e6);
+    std::printf("replayed %ld rounds in %.3f s, %.0f rounds/s, %ld mismatches\n", replayed, replayTime.count(),
+                replayed / replayTime.count(), mismatches);
+    return replayed == games && mismatches == 0 && replayer.atEnd() ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file rng_bench.cpp
+ * @brief Measures the cost of choosing the cell of the next mole.
+ *
+ * The previous code built a std::random_device and seeded a fresh std::mt19937 for every
+ * mole. It is compared with the seeded-once Random engine, both one spawn at a time and
+ * with the batch API.
+ *
+ * Usage: rng_bench [iterations]
+ * @author Anubhav Aery
+ */
+
+#include "Random.h"
+#include "LedLayout.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+volatile int sink; ///< Keeps results alive so the measured calls are not optimised out.
+
+/**
+ * @brief Runs a callable repeatedly and prints its mean cost per spawn.
+ */
+template <typename F>
+void measure(const char* name, long spawns, long spawnsPerCall, F&& f) {
+    auto begin = std::chrono::steady_clock::now();
+    int acc = 0;
+    for (long i = 0; i < spawns; i += spawnsPerCall) {
+        acc += f();
+    }
+    sink = acc;
+    std::chrono::duration<double, std::nano> total = std::chrono::steady_clock::now() - begin;
+    std::printf("%-36s %10.2f ns/spawn\n", name, total.count() / spawns);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? std::atol(argv[1]) : 10000000;
+
+    measure("random_device + mt19937 per spawn", iterations / 1000, 1, [] {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<> distrib(0, LedLayout::kCellCount - 1);
+        return distrib(gen);
+    });
+
+    Random random(12345);
+    int current = -1;
+    measure("Random::nextCell", iterations, 1, [&random, &current] {
+        current = random.nextCell(current, LedLayout::kCellCount);
+        return current;
+    });
+
+    std::uint8_t batch[64];
+    measure("Random::nextCells (batch of 64)", iterations, 64, [&random, &batch] {
+        random.nextCells(batch, 64, batch[63] % LedLayout::kCellCount, LedLayout::kCellCount);
+        return static_cast<int>(batch[0]);
+    });
+    return 0;
+}
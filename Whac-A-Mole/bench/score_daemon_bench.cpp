@@ -0,0 +1,140 @@
+/**
+ * @file score_daemon_bench.cpp
+ * @brief Measures how group commit in the whac-scored daemon amortises fdatasync.
+ *
+ * The baseline appends every score to a ScoreStore and syncs it on its own, which is what
+ * each game would have to do to make its scores durable without the daemon. The daemon
+ * runs are a ScoreServer on a thread of this process with 1 to 16 writer threads, each
+ * submitting single scores over its own ScoreClient connection and waiting for every
+ * acknowledgement. The scores per sync column shows how many submissions shared one
+ * fdatasync. Finally the latency of a top ten query is measured.
+ *
+ * The files live under $TMPDIR, which should be on the disk the daemon will use; on tmpfs
+ * fdatasync costs nothing and there is little to amortise.
+ *
+ * Usage: score_daemon_bench [scores per writer] [commit window in us]
+ * @author Eseosa Emmanuel Atekha
+ */
+
+#include "Random.h"
+#include "ScoreClient.h"
+#include "ScoreServer.h"
+#include "ScoreStore.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Converts an elapsed duration to seconds.
+ */
+double seconds(Clock::duration elapsed) {
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+/**
+ * @brief Removes the files of a store.
+ */
+void removeStore(const std::string& base) {
+    unlink((base + ".log").c_str());
+    unlink((base + ".idx").c_str());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long perWriter = argc > 1 ? std::atol(argv[1]) : 500;
+    long window = argc > 2 ? std::atol(argv[2]) : 0;
+
+    const char* tmp = getenv("TMPDIR");
+    std::string directory = std::string(tmp ? tmp : "/tmp") + "/score_daemon_benchXXXXXX";
+    if (!mkdtemp(&directory[0])) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    std::string base = directory + "/highScores";
+    std::string socketPath = directory + "/scored.sock";
+
+    // Baseline: one write and one sync per score
+    {
+        ScoreStore store(base);
+        store.open();
+        Random random(1);
+        auto begin = Clock::now();
+        for (long i = 0; i < perWriter; ++i) {
+            store.append(static_cast<int>(random.nextBelow(1000)), "baseline");
+            store.sync();
+        }
+        double elapsed = seconds(Clock::now() - begin);
+        std::printf("%-22s %8ld scores %9.0f scores/s %8.1f us/score %6.2f scores/sync\n", "append+sync per score",
+                    perWriter, perWriter / elapsed, elapsed * 1e6 / perWriter, 1.0);
+    }
+    removeStore(base);
+
+    for (int writers : {1, 2, 4, 8, 16}) {
+        ScoreServer server(base, 1000, std::chrono::microseconds(window));
+        if (!server.start(socketPath)) {
+            return 1;
+        }
+        std::thread serverThread([&server] { server.run(); });
+
+        std::atomic<long> failures(0);
+        std::vector<std::thread> threads;
+        auto begin = Clock::now();
+        for (int w = 0; w < writers; ++w) {
+            threads.emplace_back([&, w] {
+                ScoreClient client;
+                if (!client.connect(socketPath)) {
+                    failures += perWriter;
+                    return;
+                }
+                Random random(static_cast<std::uint64_t>(w + 2));
+                std::string name = "writer" + std::to_string(w);
+                for (long i = 0; i < perWriter; ++i) {
+                    ScoreRecord record = ScoreRecord::make(static_cast<int>(random.nextBelow(1000)), name, 0);
+                    if (!client.submit(&record, 1)) {
+                        ++failures;
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        double elapsed = seconds(Clock::now() - begin);
+        long scores = writers * perWriter;
+        char label[32];
+        std::snprintf(label, sizeof(label), "daemon, %d writer%s", writers, writers == 1 ? "" : "s");
+        std::printf("%-22s %8ld scores %9.0f scores/s %8.1f us/score %6.2f scores/sync", label, scores,
+                    scores / elapsed, elapsed * 1e6 / scores,
+                    static_cast<double>(server.getCommittedScores()) / std::max<std::uint64_t>(1, server.getCommits()));
+        std::printf(failures ? " (%ld failed)\n" : "\n", failures.load());
+
+        if (writers == 16) {
+            ScoreClient client;
+            client.connect(socketPath);
+            std::vector<ScoreRecord> top;
+            const int queries = 10000;
+            begin = Clock::now();
+            for (int i = 0; i < queries; ++i) {
+                client.top(10, i & 1, top);
+            }
+            elapsed = seconds(Clock::now() - begin);
+            std::printf("%-22s %8d queries %8.1f us/query\n", "top ten query", queries, elapsed * 1e6 / queries);
+        }
+
+        server.stop();
+        serverThread.join();
+        removeStore(base);
+    }
+    rmdir(directory.c_str());
+    return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file score_journal_bench.cpp
+ * @brief Measures the ScoreJournal on the game-over path and checks its crash recovery.
+ *
+ * The first part compares saving a score durably in the ScoreStore (append and fdatasync
+ * on the caller's thread) with submitting it to the journal, which returns at once and
+ * leaves the sync to its committer. It also reports how many scores shared one sync.
+ *
+ * The second part simulates crashes. A child process submits scores and exits without
+ * closing the journal, so the frames are left unfolded; the parent then appends half a
+ * frame, as a write cut short by a power loss would, and reopens the journal. A second run
+ * also copies half of the frames into the store first, as a fold cut short would. In both
+ * cases every score must be in the store exactly once afterwards.
+ *
+ * Usage: score_journal_bench [scores]
+ * @author Eseosa Emmanuel Atekha
+ */
+
+#include "Random.h"
+#include "ScoreJournal.h"
+#include "ScoreStore.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Converts an elapsed duration to microseconds.
+ */
+double micros(Clock::duration elapsed) {
+    return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+/**
+ * @brief Removes the files of a store and its journal.
+ */
+void removeStore(const std::string& base) {
+    for (const char* extension : {".log", ".idx", ".wal"}) {
+        unlink((base + extension).c_str());
+    }
+}
+
+/**
+ * @brief Builds a score for player i.
+ */
+ScoreRecord makeScore(Random& random, long i) {
+    return ScoreRecord::make(static_cast<int>(random.nextBelow(1000)), "player" + std::to_string(i % 100), 0);
+}
+
+/**
+ * @brief Leaves a journal with unfolded scores behind, as a crash would, and checks its recovery.
+ *
+ * @param base Path of the store without extension.
+ * @param scores Number of scores submitted before the crash.
+ * @param interruptedFold If true, half of the scores are already in the store, as after a fold cut short.
+ * @return True if the store holds every score exactly once after recovery.
+ */
+bool crashAndRecover(const std::string& base, long scores, bool interruptedFold) {
+    removeStore(base);
+    std::fflush(stdout);
+    pid_t child = fork();
+    if (child == 0) {
+        ScoreStore store(base);
+        store.open();
+        // Nothing is folded before the crash
+        ScoreJournal journal(base, 1u << 30, std::chrono::hours(1));
+        journal.open(store);
+        Random random(7);
+        for (long i = 0; i < scores; ++i) {
+            journal.submit(makeScore(random, i));
+        }
+        journal.flush();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+
+    int wal = open((base + ".wal").c_str(), O_WRONLY | O_APPEND);
+    char torn[40] = {'W', 'A', 'L', '1'};
+    bool tornWritten = write(wal, torn, sizeof(torn)) == static_cast<ssize_t>(sizeof(torn));
+    close(wal);
+
+    ScoreStore store(base);
+    store.open();
+    if (interruptedFold) {
+        std::vector<ScoreRecord> half;
+        Random random(7);
+        for (long i = 0; i < scores / 2; ++i) {
+            half.push_back(makeScore(random, i));
+        }
+        store.append(half.data(), half.size());
+    }
+
+    ScoreJournal journal(base);
+    auto begin = Clock::now();
+    bool opened = journal.open(store);
+    double elapsed = micros(Clock::now() - begin);
+    bool ok = tornWritten && opened && journal.getRecovered() == static_cast<std::size_t>(scores) &&
+              store.size() == static_cast<std::size_t>(scores);
+    std::printf("%-34s %6zu frames recovered in %8.1f us, store holds %zu: %s\n",
+                interruptedFold ? "crash during a fold" : "crash before the fold", journal.getRecovered(),
+                elapsed, store.size(), ok ? "ok" : "FAILED");
+    journal.close();
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long scores = argc > 1 ? std::atol(argv[1]) : 2000;
+
+    const char* tmp = getenv("TMPDIR");
+    std::string directory = std::string(tmp ? tmp : "/tmp") + "/score_journal_benchXXXXXX";
+    if (!mkdtemp(&directory[0])) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    std::string base = directory + "/highScores";
+
+    // Durable on the caller's thread: one append and one fdatasync per score
+    {
+        ScoreStore store(base);
+        store.open();
+        Random random(1);
+        auto begin = Clock::now();
+        for (long i = 0; i < scores; ++i) {
+            ScoreRecord record = makeScore(random, i);
+            store.append(&record, 1);
+            store.sync();
+        }
+        double elapsed = micros(Clock::now() - begin);
+        std::printf("%-34s %8.2f us/score on the caller's thread\n", "store append+sync", elapsed / scores);
+    }
+    removeStore(base);
+
+    // Journal: submit returns at once; the committer syncs groups in the background
+    {
+        ScoreStore store(base);
+        store.open();
+        ScoreJournal journal(base);
+        journal.open(store);
+        Random random(1);
+        auto begin = Clock::now();
+        for (long i = 0; i < scores; ++i) {
+            journal.submit(makeScore(random, i));
+        }
+        double submitted = micros(Clock::now() - begin);
+        journal.flush();
+        double durable = micros(Clock::now() - begin);
+        std::printf("%-34s %8.2f us/score on the caller's thread\n", "journal submit", submitted / scores);
+        std::printf("%-34s %8.2f us/score until durable, %.1f scores/sync\n", "journal flush", durable / scores,
+                    static_cast<double>(scores) / std::max<std::uint64_t>(1, journal.getCommits()));
+        journal.close();
+        std::printf("%-34s %8zu scores in the store after %llu folds\n", "journal close", store.size(),
+                    static_cast<unsigned long long>(journal.getCompactions()));
+    }
+
+    bool ok = crashAndRecover(base, scores, false) && crashAndRecover(base, scores, true);
+    removeStore(base);
+    rmdir(directory.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file score_store_bench.cpp
+ * @brief Compares the text high score file with the binary ScoreStore at 1M entries.
+ *
+ * The text path is what HighScore::print() used to do: parse every line of
+ * highScores.txt into a multimap and walk it for the top ten. The binary path imports the
+ * same file once, then measures reopening the store, reading the top ten from the mapped
+ * index, and appending new scores.
+ *
+ * Usage: score_store_bench [entries]
+ * @author Eseosa Emmanuel Atekha
+ */
+
+#include "ScoreStore.h"
+#include "Random.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Converts an elapsed duration to milliseconds.
+ */
+double millis(Clock::duration elapsed) {
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long entries = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+    char directory[] = "/tmp/score_store_benchXXXXXX";
+    if (!mkdtemp(directory)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    std::string base = std::string(directory) + "/highScores";
+    std::string textPath = base + ".txt";
+
+    Random random(99);
+    {
+        std::ofstream text(textPath);
+        for (long i = 0; i < entries; ++i) {
+            text << "player" << random.nextBelow(50000) << " " << random.nextBelow(200) << "\n";
+        }
+    }
+
+    // Old path: parse the whole file into a multimap, then walk the first ten entries
+    auto begin = Clock::now();
+    std::multimap<int, std::string, std::greater<int>> highScoresMap;
+    {
+        std::ifstream inputFile(textPath);
+        std::string name;
+        int score;
+        while (inputFile >> name >> score) {
+            highScoresMap.insert(std::make_pair(score, name));
+        }
+    }
+    long checksum = 0;
+    int shown = 0;
+    for (auto it = highScoresMap.begin(); it != highScoresMap.end() && shown < 10; ++it, ++shown) {
+        checksum += it->first;
+    }
+    std::printf("text parse + top 10           %10.2f ms   (checksum %ld)\n", millis(Clock::now() - begin), checksum);
+
+    begin = Clock::now();
+    {
+        ScoreStore store(base);
+        store.open();
+        store.importText(textPath);
+    }
+    std::printf("one-time import               %10.2f ms\n", millis(Clock::now() - begin));
+
+    ScoreStore store(base);
+    begin = Clock::now();
+    store.open();
+    std::printf("open (single mmap)            %10.3f ms   (%zu records)\n", millis(Clock::now() - begin), store.size());
+
+    const int reads = 1000000;
+    begin = Clock::now();
+    checksum = 0;
+    for (int r = 0; r < reads; ++r) {
+        const ScoreRecord* top = store.top();
+        for (int i = 0; i < 10; ++i) {
+            checksum += top[i].score;
+        }
+    }
+    std::chrono::duration<double, std::nano> topTime = Clock::now() - begin;
+    std::printf("top 10 from index             %10.2f ns   (checksum %ld)\n", topTime.count() / reads, checksum / reads);
+
+    const int appends = 100000;
+    begin = Clock::now();
+    for (int i = 0; i < appends; ++i) {
+        store.append(static_cast<int>(random.nextBelow(200)), "bench");
+    }
+    std::chrono::duration<double, std::nano> appendTime = Clock::now() - begin;
+    std::printf("append                        %10.2f ns/score\n", appendTime.count() / appends);
+
+    store.close();
+    for (const char* extension : {".txt", ".log", ".idx"}) {
+        unlink((base + extension).c_str());
+    }
+    rmdir(directory);
+    return 0;
+}
@@ -0,0 +1,252 @@
+/**
+ * @file whac_bench.cpp
+ * @brief Google Benchmark suite for the Hardware/ classes.
+ *
+ * Covers LED updates, key lookups, the high score table at 10^2 to 10^6 stored scores,
+ * the Timer queries and one pass of the game loop. The GPIO pins are driven through the
+ * CountingGpioBackend mock, so the suite runs on any Linux machine. The high score
+ * benchmarks work in a scratch directory under $TMPDIR and leave the working directory alone.
+ *
+ * Usage: whac_bench [Google Benchmark flags]
+ *   whac_bench --benchmark_format=json --benchmark_out=whac_bench.json
+ * writes a JSON report that can be compared between releases, for example with the
+ * compare.py tool shipped with Google Benchmark.
+ * @author Anubhav Aery
+ */
+
+#include "CountingGpioBackend.h"
+#include "GameController.h"
+#include "GameEvent.h"
+#include "HighScore.h"
+#include "LEDMatrix.h"
+#include "LedLayout.h"
+#include "Player.h"
+#include "Random.h"
+#include "Timer.h"
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace {
+
+const char kKeys[] = "4567rtyufghjvbnm";
+
+/**
+ * @brief Stream buffer that discards everything, to time print() without the terminal.
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        return count;
+    }
+};
+
+/**
+ * @brief A HighScore whose store already holds a given number of scores.
+ *
+ * HighScore keeps its files in the working directory, so every size gets its own
+ * directory, filled once through the text import and reused by every benchmark of that size.
+ */
+class ScoreFixture {
+public:
+    /**
+     * @brief Retrieves the fixture for a number of scores and makes its directory current.
+     */
+    static HighScore& get(long scores) {
+        static std::map<long, std::unique_ptr<ScoreFixture>> fixtures;
+        std::unique_ptr<ScoreFixture>& fixture = fixtures[scores];
+        if (!fixture) {
+            fixture.reset(new ScoreFixture(scores));
+        }
+        if (chdir(fixture->directory.c_str()) != 0) {
+            std::perror(fixture->directory.c_str());
+        }
+        return *fixture->highScore;
+    }
+
+    /**
+     * @brief Closes the store and removes its directory.
+     */
+    ~ScoreFixture() {
+        highScore.reset();
+        for (const char* file : {"/highScores.txt", "/highScores.log", "/highScores.idx", "/highScores.wal"}) {
+            std::remove((directory + file).c_str());
+        }
+        rmdir(directory.c_str());
+    }
+
+private:
+    explicit ScoreFixture(long scores) {
+        const char* tmp = std::getenv("TMPDIR");
+        std::string pattern = std::string(tmp ? tmp : "/tmp") + "/whac_bench_XXXXXX";
+        directory = mkdtemp(&pattern[0]) ? pattern : ".";
+        // Measure the local store even if a whac-scored daemon runs on this machine
+        setenv("WHAC_SCORE_SOCKET", "", 1);
+        if (chdir(directory.c_str()) != 0) {
+            std::perror(directory.c_str());
+        }
+        {
+            std::ofstream text("highScores.txt");
+            Random random(static_cast<std::uint64_t>(scores));
+            for (long i = 0; i < scores; ++i) {
+                text << "player" << random.nextBelow(5000) << " " << random.nextBelow(100000) << "\n";
+            }
+        }
+        std::streambuf* saved = std::cout.rdbuf(&discard);
+        highScore.reset(new HighScore());
+        std::cout.rdbuf(saved);
+    }
+
+    std::string directory;                ///< Scratch directory holding the store.
+    std::unique_ptr<HighScore> highScore; ///< The filled table.
+    NullBuffer discard;                   ///< Swallows the import message.
+};
+
+/**
+ * @brief Starts a timer without its message, which would end up in the JSON report.
+ */
+void startQuietly(Timer& timer) {
+    NullBuffer discard;
+    std::streambuf* saved = std::cout.rdbuf(&discard);
+    timer.start();
+    std::cout.rdbuf(saved);
+}
+
+/**
+ * @brief A GameController on the mock GPIO with a round in progress.
+ */
+struct RoundFixture {
+    RoundFixture() : controller(std::unique_ptr<GpioBackend>(new CountingGpioBackend())) {
+        controller.seed(1);
+        controller.setMode(gameMode(GameModeId::Hard));
+        controller.setEventQueue(&events);
+        controller.setup();
+        startQuietly(controller.timer);
+        controller.beginRound(player, Timer::now());
+    }
+
+    GameEventQueue events;     ///< Receives the events, drained like the GUI does.
+    GameController controller; ///< The controller under test.
+    Player player;             ///< The player of the round.
+};
+
+void BM_LightUpRandomLED(benchmark::State& state) {
+    CountingGpioBackend gpio;
+    gpio.initialise();
+    LEDMatrix matrix;
+    matrix.setBackend(&gpio);
+    Random random(1);
+    int pin = -1;
+    for (auto _ : state) {
+        if (pin != -1) {
+            matrix.setCell(matrix.cellForPin(pin), false);
+        }
+        pin = matrix.lightUpRandomLED(pin, random);
+        benchmark::DoNotOptimize(pin);
+    }
+    state.counters["writes/op"] = benchmark::Counter(static_cast<double>(gpio.getRegisterWrites()),
+                                                     benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_LightUpRandomLED);
+
+void BM_KeyLookupMap(benchmark::State& state) {
+    LEDMatrix matrix;
+    const auto& keyToLed = matrix.getKeyToLedMap();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto it = keyToLed.find(kKeys[i++ & 15]);
+        benchmark::DoNotOptimize(it);
+    }
+}
+BENCHMARK(BM_KeyLookupMap);
+
+void BM_KeyLookupTable(benchmark::State& state) {
+    LEDMatrix matrix;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        int pin = matrix.pinForKey(kKeys[i++ & 15]);
+        benchmark::DoNotOptimize(pin);
+    }
+}
+BENCHMARK(BM_KeyLookupTable);
+
+void BM_HighScoreAdd(benchmark::State& state) {
+    HighScore& highScore = ScoreFixture::get(state.range(0));
+    Random random(2);
+    for (auto _ : state) {
+        highScore.add(static_cast<int>(random.nextBelow(100000)), "bench");
+    }
+}
+BENCHMARK(BM_HighScoreAdd)->RangeMultiplier(10)->Range(100, 1000000);
+
+void BM_HighScorePrint(benchmark::State& state) {
+    HighScore& highScore = ScoreFixture::get(state.range(0));
+    NullBuffer discard;
+    std::streambuf* saved = std::cout.rdbuf(&discard);
+    for (auto _ : state) {
+        highScore.print();
+    }
+    std::cout.rdbuf(saved);
+}
+BENCHMARK(BM_HighScorePrint)->RangeMultiplier(10)->Range(100, 1000000);
+
+void BM_HighScoreGetHighScores(benchmark::State& state) {
+    HighScore& highScore = ScoreFixture::get(state.range(0));
+    for (auto _ : state) {
+        auto scores = highScore.getHighScores(10);
+        benchmark::DoNotOptimize(scores.data());
+    }
+}
+BENCHMARK(BM_HighScoreGetHighScores)->RangeMultiplier(10)->Range(100, 1000000);
+
+void BM_TimerGetTimeLeft(benchmark::State& state) {
+    Timer timer;
+    startQuietly(timer);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(timer.getTimeLeft());
+    }
+}
+BENCHMARK(BM_TimerGetTimeLeft);
+
+void BM_TimerIsTimeUp(benchmark::State& state) {
+    Timer timer;
+    startQuietly(timer);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(timer.isTimeUp());
+    }
+}
+BENCHMARK(BM_TimerIsTimeUp);
+
+/**
+ * One pass of GameController::inGame(): advance and show the moles, handle a key and a
+ * tick, and drain the events as the GUI does. The clock advances 5 ms per pass.
+ */
+void BM_InGameTick(benchmark::State& state) {
+    RoundFixture round;
+    Timer::Clock::time_point now = Timer::now();
+    GameEvent event;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        now += std::chrono::milliseconds(5);
+        round.controller.updateRound(round.player, now);
+        round.controller.handleKey(round.player, kKeys[i++ & 15], now);
+        round.controller.handleTick(round.player, now);
+        while (round.events.tryPop(event)) {
+            benchmark::DoNotOptimize(event);
+        }
+    }
+}
+BENCHMARK(BM_InGameTick);
+
+} // namespace
+
+BENCHMARK_MAIN();
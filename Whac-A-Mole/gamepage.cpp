@@ -8,6 +8,7 @@
 #include <QDebug>
 #include "playpage.h"
 #include "mainwindow.h"
+#include "assetmanager.h"
 
 /**
  * @brief Animates a QPushButton to create a visual effect.
@@ -41,29 +42,10 @@ void animateButton(QPushButton* button) {
  * @brief Class representing the game page in a GUI application.
  *
  * GamePage sets up the main interface for the game, including a display of instructions and a play button.
+ * Images come from the AssetManager, so constructing the page does not decode or scale anything twice.
  */
-class GamePage : public QWidget {
-public:
-    /**
-     * @brief Constructor for GamePage.
-     *
-     * Sets up the UI components of the game page, including layout, instructions label, and play button.
-     *
-     * @param size Size of the game page.
-     * @param parent Pointer to the parent widget.
-     */
-    GamePage(const QSize &size, QWidget *parent);
-
-    /**
-     * @brief Slot to handle the start of the game.
-     *
-     * This function is called when the play button is clicked. It handles the transition to the play page.
-     */
-    void startGame();
-};
-
 GamePage::GamePage(const QSize &size, QWidget *parent)
-        : QWidget(parent)
+        : QWidget(parent), playPage(nullptr)
 {
     setFixedSize(size);
     QVBoxLayout *layout = new QVBoxLayout(this);
@@ -72,11 +54,11 @@ GamePage::GamePage(const QSize &size, QWidget *parent)
 
     // Create a label to display the image with instructions
     QLabel *instructionsImageLabel = new QLabel(this);
-    QPixmap instructionsPixmap("ruleimage.png");
+    QSize scaledSize = size * 0.9; // Example: Scale down to 90% of the GamePage size
+    QPixmap instructionsPixmap = AssetManager::instance().scaled("ruleimage.png", scaledSize);
 
     if (!instructionsPixmap.isNull()) {
-        QSize scaledSize = size * 0.9; // Example: Scale down to 90% of the GamePage size
-        instructionsImageLabel->setPixmap(instructionsPixmap.scaled(scaledSize, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+        instructionsImageLabel->setPixmap(instructionsPixmap);
         instructionsImageLabel->setAlignment(Qt::AlignCenter);
     } else {
         qDebug() << "Failed to load the instructions image.";
@@ -84,10 +66,9 @@ GamePage::GamePage(const QSize &size, QWidget *parent)
 
     // Create a PLAY button using an image
     QPushButton *playButton = new QPushButton(this);
-    QPixmap playButtonPixmap("play.png");
+    QPixmap playButtonPixmap = AssetManager::instance().scaled("play.png", QSize(190, 70));
 
     if (!playButtonPixmap.isNull()) {
-        playButtonPixmap = playButtonPixmap.scaled(QSize(190, 70), Qt::KeepAspectRatio, Qt::SmoothTransformation);
         playButton->setIcon(QIcon(playButtonPixmap));
         playButton->setIconSize(playButtonPixmap.size());
         playButton->setFixedSize(QSize(190, 70));
@@ -115,7 +96,9 @@ void GamePage::startGame() {
     // Hide the current game instructions page
     this->hide();
 
-    // Create and show the play page
-    PlayPage *playPage = new PlayPage(this->size(), this->parentWidget()); // Pass the size and parent
+    // Create the play page on first use and show it
+    if (!playPage) {
+        playPage = new PlayPage(this->size(), this->parentWidget()); // Pass the size and parent
+    }
     playPage->show();
 }
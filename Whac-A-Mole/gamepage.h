@@ -14,6 +14,8 @@
 #include <QWidget>
 #include <QPushButton>
 
+class PlayPage;
+
 /**
  * @class GamePage
  * @brief Class representing the main game page in a GUI application.
@@ -46,7 +48,8 @@ public slots:
              */
             void startGame();
 
-    // ... other members and functions ...
+private:
+    PlayPage *playPage; ///< The play page, created the first time the game starts.
 };
 
 #endif // GAMEPAGE_H
@@ -1,4 +1,6 @@
 #include "mainwindow.h"
+#include "audioengine.h"
+#include "assetmanager.h"
 #include <QApplication>
 
 /**
@@ -13,8 +15,10 @@
 /**
  * @brief Main entry point for the Qt application.
  *
- * Initializes the QApplication, plays a startup audio file, creates the main window,
- * and enters the main event loop of the application.
+ * Opens the audio device and preloads the sounds, initializes the QApplication, plays a
+ * startup audio file, starts decoding the images of every page in the background, creates
+ * the main window, and enters the main event loop of the application. The image cache and
+ * the audio device are released when the event loop ends.
  *
  * @param argc Argument count.
  * @param argv Argument vector.
@@ -22,11 +26,17 @@
  */
 int main(int argc, char *argv[])
 {
+    AudioEngine::instance().initialise(); // Open the audio device and decode the sounds once
     playAudio("gameSound.mp3"); // Play an audio file at startup
     QApplication app(argc, argv); // Initialize the Qt application
+    AssetManager::instance().preload({"mainbgimage.png", "pressstart.png", "gamescores.png", "exit.png",
+                                      "ruleimage.png", "play.png", "start.png", "return.png"});
 
     MainWindow mainWindow; // Create the main window
     mainWindow.show(); // Display the main window
 
-    return app.exec(); // Enter the main event loop of the application
+    int result = app.exec(); // Enter the main event loop of the application
+    AssetManager::instance().clear(); // Pixmaps must be released while the application exists
+    AudioEngine::instance().shutdown(); // Free the sounds and close the audio device
+    return result;
 }
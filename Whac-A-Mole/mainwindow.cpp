@@ -9,15 +9,14 @@
 #include "gamepage.h"
 #include "scorespage.h"
 #include <QMovie>
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_mixer.h>
-#include <iostream>
+#include "audioengine.h"
+#include "assetmanager.h"
 
 /**
  * @brief Plays an audio file using SDL2.
  *
- * Initializes SDL and SDL_mixer, loads the specified audio file, and plays it.
- * It also handles any initialization or loading errors.
+ * Plays the sound through the shared AudioEngine, which keeps the audio device open and
+ * the sound decoded between calls. The engine is opened on first use if main() did not.
  *
  * @param audioPath Path to the audio file as a std::string.
  * @return True if the audio plays successfully, false otherwise.
@@ -25,38 +24,7 @@
  */
 bool playAudio(const std::string &audioPath)
 {
-    if (SDL_Init(SDL_INIT_AUDIO) < 0)
-    {
-        std::cerr << "SDL could not initialize! SDL Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
-
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
-    {
-        std::cerr << "SDL_mixer could not initialize! SDL_mixer Error: " << Mix_GetError() << std::endl;
-        SDL_Quit();
-        return false;
-    }
-
-    Mix_Music *music = Mix_LoadMUS(audioPath.c_str());
-    if (music == NULL)
-    {
-        std::cerr << "Failed to load music! SDL_mixer Error: " << Mix_GetError() << std::endl;
-        Mix_CloseAudio();
-        SDL_Quit();
-        return false;
-    }
-
-    if (Mix_PlayMusic(music, 0) == -1)
-    {
-        std::cerr << "Failed to play music! SDL_mixer Error: " << Mix_GetError() << std::endl;
-        Mix_FreeMusic(music);
-        Mix_CloseAudio();
-        SDL_Quit();
-        return false;
-    }
-
-    return true;
+    return AudioEngine::instance().play(audioPath);
 }
 
 /**
@@ -72,14 +40,13 @@ MainWindow::MainWindow(QWidget *parent)
     setWindowTitle("Whac-A-Mole Game");
     setFixedSize(900, 758);
 
-    QPixmap background("mainbgimage.png");
     QLabel *backgroundLabel = new QLabel(this);
-    backgroundLabel->setPixmap(background.scaled(this->size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    backgroundLabel->setPixmap(AssetManager::instance().scaled("mainbgimage.png", this->size(), Qt::IgnoreAspectRatio));
     backgroundLabel->setScaledContents(true);
     backgroundLabel->setGeometry(this->rect());
 
     QLabel *gifLabel = new QLabel(this);
-    QMovie *movie = new QMovie("molegif.gif");
+    QMovie *movie = AssetManager::instance().movie("molegif.gif", gifLabel);
     if (movie->isValid()) {
         gifLabel->setMovie(movie);
         movie->start();
@@ -116,13 +83,14 @@ MainWindow::MainWindow(QWidget *parent)
     connect(gamescoresButton, &QPushButton::clicked, this, &MainWindow::on_gamescoresButton_clicked);
     connect(exitButton, &QPushButton::clicked, this, &MainWindow::on_exitButton_clicked);
 
+    gamePage = nullptr;
     scoresPage = nullptr;
 }
 
 /**
  * @brief Sets up a QPushButton with an image.
  *
- * Creates a QPushButton, sets its icon to the specified image, and applies styling.
+ * Creates a QPushButton, sets its icon to the specified image from the asset cache, and applies styling.
  * It also connects a press signal to an animation and sound effect.
  *
  * @param imagePath Path to the image file as a QString.
@@ -131,8 +99,7 @@ MainWindow::MainWindow(QWidget *parent)
  */
 QPushButton* MainWindow::setupButtonWithImage(const QString &imagePath, const QSize &size) {
     QPushButton *button = new QPushButton(this);
-    QPixmap pixmap(imagePath);
-    pixmap = pixmap.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    QPixmap pixmap = AssetManager::instance().scaled(imagePath, size);
     button->setIcon(QIcon(pixmap));
     button->setIconSize(size);
     button->setFixedSize(size);
@@ -178,12 +145,16 @@ void MainWindow::animateButton(QPushButton* button) {
  * @brief Slot for handling the start button click.
  *
  * Hides the main window and displays the game page when the start button is clicked.
+ * The game page is created on the first click and reused afterwards.
  */
 void MainWindow::on_startButton_clicked() {
-    QSize currentSize = this->size();
     this->hide();
 
-    GamePage *gamePage = new GamePage(currentSize);
+    if (!gamePage) {
+        QSize currentSize = this->size();
+        gamePage = new GamePage(currentSize);
+    }
+
     gamePage->show();
 }
 
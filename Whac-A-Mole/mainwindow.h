@@ -12,6 +12,8 @@
 /**
  * @brief Plays an audio file using SDL2.
  *
+ * Thin wrapper around AudioEngine::play().
+ *
  * @param audioPath Path to the audio file as a std::string.
  * @return True if the audio plays successfully, false otherwise.
  */
@@ -91,6 +93,7 @@ private:
     QPushButton *gamescoresButton; ///< Button to view game scores.
     QPushButton *exitButton; ///< Button to exit the application.
 
+    GamePage *gamePage;     ///< Pointer to the GamePage, created on first use.
     ScoresPage *scoresPage; ///< Pointer to the ScoresPage.
 };
 
@@ -1,6 +1,7 @@
 #include "playpage.h"
 #include "mainwindow.h"
 #include "HardwareInterface.h"
+#include "assetmanager.h"
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QPushButton>
@@ -29,8 +30,7 @@ PlayPage::PlayPage(const QSize &size, QWidget *parent)
     layout->addWidget(usernameInput, 0, Qt::AlignCenter);
 
     QPushButton *startButton = new QPushButton(this);
-    QPixmap startButtonPixmap("start.png");
-    startButtonPixmap = startButtonPixmap.scaled(QSize(190, 80), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    QPixmap startButtonPixmap = AssetManager::instance().scaled("start.png", QSize(190, 80));
     startButton->setIcon(QIcon(startButtonPixmap));
     startButton->setIconSize(startButtonPixmap.size());
     startButton->setFixedSize(QSize(190, 80));
@@ -67,12 +67,20 @@ PlayPage::PlayPage(const QSize &size, QWidget *parent)
         countdownLabel->setText("Time left: " + QString::number(timeLeft));
     });
 
+    // The game-over sound is played by the HardwareInterface, off the GUI thread
     connect(hardwareInterface, &HardwareInterface::gameEnded, this, [startButton, usernameInput]() {
-        playAudio("over.wav");
         startButton->setEnabled(true);
         usernameInput->setEnabled(true);
     });
 
+    connect(hardwareInterface, &HardwareInterface::scoreSaved, this, [welcomeLabel](int score, int rank) {
+        if (rank > 0) {
+            welcomeLabel->setText(QString("Score %1 saved, rank #%2!").arg(score).arg(rank));
+        } else {
+            welcomeLabel->setText(QString("Score %1 saved.").arg(score));
+        }
+    });
+
     setLayout(layout);
 }
 
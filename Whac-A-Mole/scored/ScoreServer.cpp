@@ -0,0 +1,439 @@
+#include "ScoreServer.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+/**
+ * @class ScoreServer
+ * @brief Leaderboard daemon with group commit and in-memory top-N queries.
+ *
+ * @param storePath Path of the ScoreStore without extension.
+ * @param boardSize Number of entries kept in each leaderboard.
+ * @param commitWindow Time the first submission of a group waits for others.
+ * @author Eseosa Emmanuel Atekha
+ */
+ScoreServer::ScoreServer(const std::string& storePath, std::size_t boardSize, std::chrono::microseconds commitWindow)
+        : storePath(storePath), commitWindow(commitWindow), journal(storePath), store(storePath), allScores(boardSize),
+          bestPerPlayer(boardSize, true), listenFd(-1), epollFd(-1), stopFd(-1), commitFd(-1), nextClientId(3),
+          windowOpen(false), commits(0), committed(0) {}
+
+/**
+ * @brief Closes the clients and the store and removes the socket.
+ */
+ScoreServer::~ScoreServer() {
+    for (auto& client : clients) {
+        close(client.second.fd);
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+    for (int fd : {epollFd, stopFd, commitFd}) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+/**
+ * @brief Locks and recovers the journal, opens the store, fills the leaderboards and starts listening.
+ *
+ * The scores a game queued in the journal before it crashed are folded into the store
+ * first, so they are on the leaderboards from the start.
+ *
+ * @param socketPath Path of the Unix domain socket.
+ * @return True on success, false with a message on std::cerr otherwise.
+ */
+bool ScoreServer::start(const std::string& socketPath) {
+    if (!journal.lock()) {
+        std::cerr << "The score store " << storePath << " is in use by a game or another daemon" << std::endl;
+        return false;
+    }
+    if (!store.open()) {
+        std::cerr << "Unable to open the score store " << storePath << std::endl;
+        return false;
+    }
+    if (!journal.recover(store)) {
+        std::cerr << "Unable to recover the journal of " << storePath << std::endl;
+        return false;
+    }
+    // The index already holds the best scores overall; only a larger board needs the whole log
+    if (allScores.capacity() <= store.topCount() || store.size() == store.topCount()) {
+        const ScoreRecord* top = store.top();
+        for (std::size_t i = 0; i < store.topCount(); ++i) {
+            allScores.offer(top[i]);
+        }
+    } else {
+        store.load(allScores);
+    }
+    store.load(bestPerPlayer);
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    commitFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epollFd < 0 || stopFd < 0 || commitFd < 0) {
+        std::cerr << "Unable to create the event loop: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    for (auto watched : {std::make_pair(stopFd, kStopId), std::make_pair(commitFd, kCommitId)}) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = watched.second;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, watched.first, &ev);
+    }
+    return listenOn(socketPath);
+}
+
+/**
+ * @brief Serves clients until stop() is called.
+ *
+ * Every pass handles all descriptors that epoll reports ready. The submissions they carried
+ * form one group, committed at the end of the pass, or when the commit window ends if one
+ * is set.
+ */
+void ScoreServer::run() {
+    epoll_event ready[64];
+    bool running = true;
+    while (running) {
+        int count = epoll_wait(epollFd, ready, 64, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        bool windowEnded = false;
+        for (int i = 0; i < count; ++i) {
+            std::uint64_t id = ready[i].data.u64;
+            std::uint64_t value;
+            if (id == kListenId) {
+                acceptClients();
+            } else if (id == kStopId) {
+                running = false;
+            } else if (id == kCommitId) {
+                windowEnded = read(commitFd, &value, sizeof(value)) == sizeof(value);
+            } else {
+                if (ready[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    readClient(id);
+                }
+                if ((ready[i].events & EPOLLOUT) && clients.count(id)) {
+                    flush(id);
+                }
+            }
+        }
+        if (pending.empty()) {
+            continue;
+        }
+        if (commitWindow.count() == 0 || windowEnded) {
+            commit();
+        } else if (!windowOpen) {
+            itimerspec spec{};
+            spec.it_value.tv_sec = static_cast<time_t>(commitWindow.count() / 1000000);
+            spec.it_value.tv_nsec = static_cast<long>(commitWindow.count() % 1000000 * 1000);
+            timerfd_settime(commitFd, 0, &spec, nullptr);
+            windowOpen = true;
+        }
+    }
+    commit();
+}
+
+/**
+ * @brief Asks run() to return. Only writes to an eventfd, so it is async-signal-safe.
+ */
+void ScoreServer::stop() {
+    std::uint64_t one = 1;
+    if (write(stopFd, &one, sizeof(one)) < 0) {
+        // Nothing more can be done from a signal handler
+    }
+}
+
+/**
+ * @brief Retrieves the number of group commits so far.
+ *
+ * @return The number of fdatasync calls.
+ */
+std::uint64_t ScoreServer::getCommits() const {
+    return commits.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Retrieves the number of scores committed so far.
+ *
+ * @return The number of acknowledged scores.
+ */
+std::uint64_t ScoreServer::getCommittedScores() const {
+    return committed.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Binds and listens on the socket, replacing a stale socket file.
+ */
+bool ScoreServer::listenOn(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    bool inUse = probe >= 0 && connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    if (probe >= 0) {
+        close(probe);
+    }
+    if (inUse) {
+        std::cerr << "Another daemon is already listening on " << path << std::endl;
+        return false;
+    }
+    unlink(path.c_str());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenFd, 128) != 0) {
+        std::cerr << "Unable to listen on " << path << ": " << std::strerror(errno) << std::endl;
+        if (listenFd >= 0) {
+            close(listenFd);
+            listenFd = -1;
+        }
+        return false;
+    }
+    socketPath = path;
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = kListenId;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    return true;
+}
+
+/**
+ * @brief Accepts every pending connection.
+ */
+void ScoreServer::acceptClients() {
+    for (;;) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;
+        }
+        std::uint64_t id = nextClientId++;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = id;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            continue;
+        }
+        clients[id] = Connection{fd, {}, {}, 0, false};
+    }
+}
+
+/**
+ * @brief Reads everything a client sent and handles the complete frames.
+ */
+void ScoreServer::readClient(std::uint64_t id) {
+    auto it = clients.find(id);
+    if (it == clients.end()) {
+        return;
+    }
+    Connection& client = it->second;
+    char buffer[65536];
+    for (;;) {
+        ssize_t received = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            client.in.insert(client.in.end(), buffer, buffer + received);
+            continue;
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        drop(id);
+        return;
+    }
+
+    // Replies are only queued here; the connection stays valid until flush()
+    std::size_t offset = 0;
+    while (client.in.size() - offset >= sizeof(ScoreProtocol::FrameHeader)) {
+        ScoreProtocol::FrameHeader header;
+        std::memcpy(&header, client.in.data() + offset, sizeof(header));
+        if (header.magic != ScoreProtocol::kMagic || header.count > ScoreProtocol::kMaxRecords) {
+            drop(id);
+            return;
+        }
+        std::size_t frameSize = sizeof(header) + ScoreProtocol::payloadSize(header);
+        if (client.in.size() - offset < frameSize) {
+            break;
+        }
+        handleFrame(id, header, client.in.data() + offset + sizeof(header));
+        offset += frameSize;
+    }
+    client.in.erase(client.in.begin(), client.in.begin() + static_cast<std::ptrdiff_t>(offset));
+    flush(id);
+}
+
+/**
+ * @brief Handles one complete frame from a client. Unknown frames get an Error reply.
+ */
+void ScoreServer::handleFrame(std::uint64_t id, const ScoreProtocol::FrameHeader& header, const char* payload) {
+    switch (header.type) {
+    case ScoreProtocol::Type::Submit:
+        if (header.count == 0) {
+            break;
+        }
+        for (std::uint32_t i = 0; i < header.count; ++i) {
+            ScoreRecord record;
+            std::memcpy(&record, payload + i * sizeof(ScoreRecord), sizeof(record));
+            record.name[ScoreRecord::kNameLength - 1] = '\0';
+            pending.push_back(record);
+        }
+        waiters.push_back({id, header.count});
+        return;
+    case ScoreProtocol::Type::Top:
+        answerTop(id, header);
+        return;
+    default:
+        break;
+    }
+    reply(id, ScoreProtocol::makeHeader(ScoreProtocol::Type::Error, 0));
+}
+
+/**
+ * @brief Queues the reply to a Top request, read from the in-memory leaderboards.
+ */
+void ScoreServer::answerTop(std::uint64_t id, const ScoreProtocol::FrameHeader& header) {
+    const Leaderboard& board = (header.flags & ScoreProtocol::kBestPerPlayer) ? bestPerPlayer : allScores;
+    auto count = static_cast<std::uint32_t>(std::min<std::size_t>(header.count, board.size()));
+    std::vector<ScoreRecord> records;
+    records.reserve(count);
+    for (const ScoreRecord& record : board) {
+        if (records.size() == count) {
+            break;
+        }
+        records.push_back(record);
+    }
+    reply(id, ScoreProtocol::makeHeader(ScoreProtocol::Type::TopReply, count), records.data(),
+          records.size() * sizeof(ScoreRecord));
+}
+
+/**
+ * @brief Commits the open group: one write, one fdatasync, then one acknowledgement per submission.
+ */
+void ScoreServer::commit() {
+    if (windowOpen) {
+        itimerspec disarm{};
+        timerfd_settime(commitFd, 0, &disarm, nullptr);
+        windowOpen = false;
+    }
+    if (pending.empty()) {
+        return;
+    }
+    bool durable = store.append(pending.data(), pending.size()) && store.sync();
+    if (durable) {
+        for (const ScoreRecord& record : pending) {
+            allScores.offer(record);
+            bestPerPlayer.offer(record);
+        }
+        commits.fetch_add(1, std::memory_order_relaxed);
+        committed.fetch_add(pending.size(), std::memory_order_relaxed);
+    }
+
+    std::size_t offset = 0;
+    for (const Waiter& waiter : waiters) {
+        if (durable) {
+            reply(waiter.client, ScoreProtocol::makeHeader(ScoreProtocol::Type::SubmitAck, waiter.count, 0,
+                                                           pending[offset].sequence));
+        } else {
+            reply(waiter.client, ScoreProtocol::makeHeader(ScoreProtocol::Type::Error, 0));
+        }
+        offset += waiter.count;
+    }
+    for (const Waiter& waiter : waiters) {
+        flush(waiter.client);
+    }
+    pending.clear();
+    waiters.clear();
+}
+
+/**
+ * @brief Queues a frame for a client. Clients that have gone away are skipped.
+ */
+void ScoreServer::reply(std::uint64_t id, const ScoreProtocol::FrameHeader& header, const void* payload,
+                        std::size_t size) {
+    auto it = clients.find(id);
+    if (it == clients.end()) {
+        return;
+    }
+    std::vector<char>& out = it->second.out;
+    const char* bytes = reinterpret_cast<const char*>(&header);
+    out.insert(out.end(), bytes, bytes + sizeof(header));
+    if (size > 0) {
+        bytes = static_cast<const char*>(payload);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+}
+
+/**
+ * @brief Sends as much of a client's queued output as the socket takes.
+ *
+ * EPOLLOUT is requested while output remains and dropped again once it is sent.
+ */
+void ScoreServer::flush(std::uint64_t id) {
+    auto it = clients.find(id);
+    if (it == clients.end()) {
+        return;
+    }
+    Connection& client = it->second;
+    while (client.outSent < client.out.size()) {
+        ssize_t sent = send(client.fd, client.out.data() + client.outSent, client.out.size() - client.outSent,
+                            MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (sent <= 0) {
+            drop(id);
+            return;
+        }
+        client.outSent += static_cast<std::size_t>(sent);
+    }
+    bool remaining = client.outSent < client.out.size();
+    if (!remaining) {
+        client.out.clear();
+        client.outSent = 0;
+    }
+    if (remaining != client.watchingOut) {
+        epoll_event ev{};
+        ev.events = remaining ? EPOLLIN | EPOLLOUT : EPOLLIN;
+        ev.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &ev);
+        client.watchingOut = remaining;
+    }
+}
+
+/**
+ * @brief Closes a client. Its pending submissions are still committed, but not acknowledged.
+ */
+void ScoreServer::drop(std::uint64_t id) {
+    auto it = clients.find(id);
+    if (it == clients.end()) {
+        return;
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    clients.erase(it);
+}
@@ -0,0 +1,151 @@
+#ifndef SCORESERVER_H
+#define SCORESERVER_H
+
+#include "Leaderboard.h"
+#include "ScoreJournal.h"
+#include "ScoreProtocol.h"
+#include "ScoreStore.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class ScoreServer
+ * @brief Leaderboard daemon shared by every game process on a machine.
+ *
+ * Game processes connect to a Unix domain socket and speak ScoreProtocol. All writes to
+ * the ScoreStore go through this one process, so concurrent submissions can no longer
+ * interleave in the files. The server holds the store's journal lock for as long as it
+ * runs, so a game that cannot reach it only reads the store, and it replays a journal left
+ * behind by a crashed game before it serves anyone.
+ *
+ * Submissions are committed in groups. The server collects every Submit frame that arrived
+ * while it was busy, appends them to the log with one write, makes them durable with one
+ * fdatasync and only then acknowledges each of them. With N writers waiting, one sync is
+ * paid for N submissions. An optional commit window holds the first submission of a group
+ * back for a while longer, to collect more of them when syncs are expensive.
+ *
+ * Top queries are answered from two in-memory Leaderboards, one with every score and one
+ * with the best score of each player, filled from the store at startup.
+ *
+ * The server runs on one thread around epoll. Client sockets are non-blocking and every
+ * client has its own input and output buffer, so a slow client never stalls the others.
+ * @author Eseosa Emmanuel Atekha
+ */
+class ScoreServer {
+public:
+    /**
+     * @brief Constructor for ScoreServer.
+     *
+     * @param storePath Path of the ScoreStore without extension.
+     * @param boardSize Number of entries kept in each leaderboard.
+     * @param commitWindow Time the first submission of a group waits for others; zero
+     *        commits as soon as no more frames are ready.
+     */
+    ScoreServer(const std::string& storePath, std::size_t boardSize = 1000,
+                std::chrono::microseconds commitWindow = std::chrono::microseconds(0));
+
+    /**
+     * @brief Closes the clients and the store and removes the socket.
+     */
+    ~ScoreServer();
+
+    ScoreServer(const ScoreServer&) = delete;
+    ScoreServer& operator=(const ScoreServer&) = delete;
+
+    /**
+     * @brief Locks and recovers the journal, opens the store, fills the leaderboards and starts listening.
+     *
+     * Fails if a game or another daemon owns the store. A stale socket file left behind by a
+     * crashed daemon is replaced; a socket on which another daemon still answers is not.
+     *
+     * @param socketPath Path of the Unix domain socket.
+     * @return True on success, false with a message on std::cerr otherwise.
+     */
+    bool start(const std::string& socketPath);
+
+    /**
+     * @brief Serves clients until stop() is called.
+     *
+     * Submissions still queued when the server stops are committed before it returns.
+     */
+    void run();
+
+    /**
+     * @brief Asks run() to return. Safe to call from a signal handler or another thread.
+     */
+    void stop();
+
+    /**
+     * @brief Retrieves the number of group commits so far.
+     *
+     * @return The number of fdatasync calls.
+     */
+    std::uint64_t getCommits() const;
+
+    /**
+     * @brief Retrieves the number of scores committed so far.
+     *
+     * @return The number of acknowledged scores.
+     */
+    std::uint64_t getCommittedScores() const;
+
+private:
+    /**
+     * @brief State of one connected client.
+     */
+    struct Connection {
+        int fd;                  ///< Non-blocking client socket.
+        std::vector<char> in;    ///< Received bytes not yet parsed.
+        std::vector<char> out;   ///< Reply bytes not yet sent.
+        std::size_t outSent;     ///< Bytes of out already sent.
+        bool watchingOut;        ///< True while EPOLLOUT is requested.
+    };
+
+    /**
+     * @brief A client waiting for its submission to be committed.
+     */
+    struct Waiter {
+        std::uint64_t client; ///< Connection id.
+        std::uint32_t count;  ///< Number of scores in the submission.
+    };
+
+    static constexpr std::uint64_t kListenId = 0; ///< epoll id of the listening socket.
+    static constexpr std::uint64_t kStopId = 1;   ///< epoll id of the stop eventfd.
+    static constexpr std::uint64_t kCommitId = 2; ///< epoll id of the commit window timer.
+
+    bool listenOn(const std::string& socketPath);
+    void acceptClients();
+    void readClient(std::uint64_t id);
+    void handleFrame(std::uint64_t id, const ScoreProtocol::FrameHeader& header, const char* payload);
+    void answerTop(std::uint64_t id, const ScoreProtocol::FrameHeader& header);
+    void commit();
+    void reply(std::uint64_t id, const ScoreProtocol::FrameHeader& header, const void* payload = nullptr,
+               std::size_t size = 0);
+    void flush(std::uint64_t id);
+    void drop(std::uint64_t id);
+
+    std::string storePath;                  ///< Path of the store without extension.
+    std::chrono::microseconds commitWindow; ///< Extra time a group collects submissions.
+    ScoreJournal journal;                   ///< Locked, never opened; released after the store is closed.
+    ScoreStore store;                       ///< The durable log and index.
+    Leaderboard allScores;                  ///< Best scores overall.
+    Leaderboard bestPerPlayer;              ///< Best score of each player.
+    std::string socketPath;                 ///< Bound socket path, removed by the destructor.
+    int listenFd;                           ///< Listening socket, or -1.
+    int epollFd;                            ///< epoll instance, or -1.
+    int stopFd;                             ///< eventfd written by stop(), or -1.
+    int commitFd;                           ///< timerfd ending the commit window, or -1.
+    std::unordered_map<std::uint64_t, Connection> clients; ///< Connected clients by id.
+    std::uint64_t nextClientId;             ///< Id of the next accepted client.
+    std::vector<ScoreRecord> pending;       ///< Submitted scores of the open group.
+    std::vector<Waiter> waiters;            ///< Submissions of the open group, in order.
+    bool windowOpen;                        ///< True while the commit timer is armed.
+    std::atomic<std::uint64_t> commits;     ///< Group commits so far.
+    std::atomic<std::uint64_t> committed;   ///< Scores committed so far.
+};
+
+#endif // SCORESERVER_H
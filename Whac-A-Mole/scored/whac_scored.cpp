@@ -0,0 +1,94 @@
+/**
+ * @file whac_scored.cpp
+ * @brief Leaderboard daemon shared by the game processes on one machine.
+ *
+ * Runs a ScoreServer until SIGINT or SIGTERM. The games find it on the socket given by
+ * WHAC_SCORE_SOCKET, or on /tmp/whac-scored.sock by default, and fall back to their own
+ * local store when it is not running.
+ *
+ * Usage: whac-scored [options]
+ *   --socket PATH           socket to listen on (default $WHAC_SCORE_SOCKET or /tmp/whac-scored.sock)
+ *   --store PATH            score store without extension (default highScores)
+ *   --board N               entries kept in each in-memory leaderboard (default 1000)
+ *   --commit-window-us US   time a group of submissions waits for more before the sync (default 0)
+ * @author Eseosa Emmanuel Atekha
+ */
+
+#include "ScoreProtocol.h"
+#include "ScoreServer.h"
+#include <signal.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+ScoreServer* server = nullptr; ///< The running server, for the signal handler.
+
+/**
+ * @brief Stops the server on SIGINT and SIGTERM.
+ */
+void onSignal(int) {
+    if (server) {
+        server->stop();
+    }
+}
+
+/**
+ * @brief Prints the usage and returns the exit code of a bad command line.
+ */
+int usage(const char* program) {
+    std::fprintf(stderr, "Usage: %s [--socket PATH] [--store PATH] [--board N] [--commit-window-us US]\n", program);
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* envSocket = std::getenv("WHAC_SCORE_SOCKET");
+    std::string socketPath = envSocket && *envSocket ? envSocket : ScoreProtocol::kDefaultSocket;
+    std::string storePath = "highScores";
+    long board = 1000;
+    long window = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return usage(argv[0]);
+        }
+        const char* value = argv[++i];
+        if (arg == "--socket") {
+            socketPath = value;
+        } else if (arg == "--store") {
+            storePath = value;
+        } else if (arg == "--board") {
+            board = std::atol(value);
+        } else if (arg == "--commit-window-us") {
+            window = std::atol(value);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (board <= 0 || window < 0) {
+        return usage(argv[0]);
+    }
+
+    ScoreServer scoreServer(storePath, static_cast<std::size_t>(board), std::chrono::microseconds(window));
+    if (!scoreServer.start(socketPath)) {
+        return 1;
+    }
+    server = &scoreServer;
+    struct sigaction action{};
+    action.sa_handler = onSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::printf("whac-scored listening on %s, store %s\n", socketPath.c_str(), storePath.c_str());
+    std::fflush(stdout);
+    scoreServer.run();
+    server = nullptr;
+    std::printf("whac-scored: %llu scores in %llu commits\n",
+                static_cast<unsigned long long>(scoreServer.getCommittedScores()),
+                static_cast<unsigned long long>(scoreServer.getCommits()));
+    return 0;
+}
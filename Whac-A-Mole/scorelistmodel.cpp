@@ -0,0 +1,199 @@
+#include "scorelistmodel.h"
+#include "GameOverPipeline.h"
+#include <QString>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+/**
+ * @brief Retrieves the application's leaderboard model.
+ *
+ * @return The single instance, created on first use.
+ */
+ScoreListModel& ScoreListModel::instance() {
+    static ScoreListModel model;
+    return model;
+}
+
+/**
+ * @brief Constructs an empty model; nothing is read until load().
+ */
+ScoreListModel::ScoreListModel()
+        : fetched(0), capacity(0), bestPerPlayer(false), state(State::Empty) {
+}
+
+/**
+ * @brief Starts reading the leaderboard in the background, once.
+ *
+ * The read is queued on the game-over pipeline's storage lane, so it never opens the
+ * store next to the HighScore that saves the scores.
+ */
+void ScoreListModel::load() {
+    if (state == State::Empty) {
+        state = State::Loading;
+        GameOverPipeline::instance().loadLeaderboard();
+    }
+}
+
+/**
+ * @brief Replaces the rows with a fresh read of the leaderboard.
+ *
+ * Only the first page is handed to the view.
+ *
+ * @param board The entries, best first.
+ * @param boardCapacity Size of the board.
+ * @param perPlayer True if a player holds at most one entry.
+ */
+void ScoreListModel::boardRead(std::vector<ScoreRecord> board, std::size_t boardCapacity, bool perPlayer) {
+    beginResetModel();
+    entries = std::move(board);
+    capacity = boardCapacity;
+    bestPerPlayer = perPlayer;
+    fetched = std::min<std::size_t>(entries.size(), kPageSize);
+    endResetModel();
+    state = State::Loaded;
+}
+
+/**
+ * @brief Applies a saved score to the rows.
+ *
+ * The score is inserted at its rank and the last entry is removed if the board overflows.
+ * On a per-player board, the player's previous entry is moved up instead.
+ *
+ * @param record The score that was saved.
+ * @param rank Its position on the leaderboard, starting at 1, or 0 if it did not make the board.
+ */
+void ScoreListModel::scoreSaved(const ScoreRecord &record, int rank) {
+    // Scores saved before the read are in it already
+    if (state != State::Loaded || rank <= 0) {
+        return;
+    }
+    std::size_t row = std::min<std::size_t>(static_cast<std::size_t>(rank - 1), entries.size());
+    if (bestPerPlayer) {
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (std::strcmp(entries[i].name, record.name) == 0) {
+                moveEntry(i, row, record);
+                return;
+            }
+        }
+    }
+    insertEntry(row, record);
+    if (entries.size() > capacity) {
+        removeEntry(entries.size() - 1);
+    }
+}
+
+/**
+ * @brief Inserts an entry, notifying the view if the row is in the fetched pages.
+ *
+ * @param row Position of the new entry.
+ * @param record The entry.
+ */
+void ScoreListModel::insertEntry(std::size_t row, const ScoreRecord &record) {
+    // An entry appended after the last fetched row is visible only if everything is fetched
+    bool visible = row < fetched || fetched == entries.size();
+    if (visible) {
+        beginInsertRows(QModelIndex(), static_cast<int>(row), static_cast<int>(row));
+    }
+    entries.insert(entries.begin() + row, record);
+    if (visible) {
+        ++fetched;
+        endInsertRows();
+    }
+}
+
+/**
+ * @brief Removes an entry, notifying the view if the row is in the fetched pages.
+ *
+ * @param row Position of the entry.
+ */
+void ScoreListModel::removeEntry(std::size_t row) {
+    bool visible = row < fetched;
+    if (visible) {
+        beginRemoveRows(QModelIndex(), static_cast<int>(row), static_cast<int>(row));
+    }
+    entries.erase(entries.begin() + row);
+    if (visible) {
+        --fetched;
+        endRemoveRows();
+    }
+}
+
+/**
+ * @brief Moves a player's entry to its new rank and replaces it with the better score.
+ *
+ * @param from Current position of the entry.
+ * @param to New position; at most from, as an entry only moves up.
+ * @param record The new entry.
+ */
+void ScoreListModel::moveEntry(std::size_t from, std::size_t to, const ScoreRecord &record) {
+    to = std::min(to, from);
+    if (from >= fetched) {
+        entries.erase(entries.begin() + from);
+        insertEntry(to, record);
+        return;
+    }
+    if (from != to) {
+        beginMoveRows(QModelIndex(), static_cast<int>(from), static_cast<int>(from), QModelIndex(),
+                      static_cast<int>(to));
+        std::rotate(entries.begin() + to, entries.begin() + from, entries.begin() + from + 1);
+        endMoveRows();
+    }
+    entries[to] = record;
+    QModelIndex changed = index(static_cast<int>(to));
+    emit dataChanged(changed, changed);
+}
+
+/**
+ * @brief Retrieves the number of rows handed to the view so far.
+ *
+ * @param parent Must be the invalid root index.
+ * @return The number of fetched rows.
+ */
+int ScoreListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(fetched);
+}
+
+/**
+ * @brief Retrieves the text of a row.
+ *
+ * The text is built when the view asks for it, that is for the rows on screen.
+ *
+ * @param index The row.
+ * @param role Qt::DisplayRole for "name - score"; other roles are empty.
+ * @return The text, or an invalid QVariant.
+ */
+QVariant ScoreListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || role != Qt::DisplayRole || static_cast<std::size_t>(index.row()) >= fetched) {
+        return QVariant();
+    }
+    const ScoreRecord &record = entries[index.row()];
+    return QString("%1 - %2").arg(QString::fromUtf8(record.name)).arg(record.score);
+}
+
+/**
+ * @brief Checks whether rows are left to hand to the view.
+ *
+ * @param parent Must be the invalid root index.
+ * @return True if not every entry has been fetched.
+ */
+bool ScoreListModel::canFetchMore(const QModelIndex &parent) const {
+    return !parent.isValid() && fetched < entries.size();
+}
+
+/**
+ * @brief Hands the next page of rows to the view.
+ *
+ * The view calls this when it scrolls to the last fetched row.
+ *
+ * @param parent Must be the invalid root index.
+ */
+void ScoreListModel::fetchMore(const QModelIndex &parent) {
+    if (!canFetchMore(parent)) {
+        return;
+    }
+    std::size_t count = std::min<std::size_t>(entries.size() - fetched, kPageSize);
+    beginInsertRows(QModelIndex(), static_cast<int>(fetched), static_cast<int>(fetched + count - 1));
+    fetched += count;
+    endInsertRows();
+}
@@ -0,0 +1,137 @@
+/**
+ * @file scorelistmodel.h
+ * @brief Header file for the ScoreListModel class.
+ *
+ * This file contains the declaration of the ScoreListModel class, which feeds the
+ * leaderboard to the scores page one page of rows at a time.
+ * @author Yangxiuye Gu
+ */
+
+#ifndef SCORELISTMODEL_H
+#define SCORELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <cstddef>
+#include <vector>
+#include "Hardware/ScoreStore.h"
+
+/**
+ * @class ScoreListModel
+ * @brief Application-wide list model of the leaderboard, best score first.
+ *
+ * load() has the GameOverPipeline read the leaderboard on its storage lane, through the
+ * same HighScore that saves the scores, and the rows are swapped in with one model reset
+ * by boardRead(). The model then hands the rows to the view in pages of kPageSize through
+ * canFetchMore() and fetchMore(), so a view asks for the text of the rows it shows and no
+ * more; showing the scores page costs the same for ten scores and for thousands.
+ *
+ * After that the model is kept up to date with scoreSaved(), which the game-over pipeline
+ * calls for every saved score. A new entry is inserted at its rank, an improved per-player
+ * entry is moved there, and the entry that fell off the board is removed, each with the
+ * matching begin/end notification, so the view only repaints the rows that changed. Rows
+ * beyond the fetched pages change silently.
+ *
+ * All methods must be called from the GUI thread.
+ */
+class ScoreListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Retrieves the application's leaderboard model.
+     *
+     * @return The single instance.
+     */
+    static ScoreListModel& instance();
+
+    ScoreListModel(const ScoreListModel&) = delete;
+    ScoreListModel& operator=(const ScoreListModel&) = delete;
+
+    /**
+     * @brief Starts reading the leaderboard in the background, once.
+     *
+     * Does nothing if the model is already loaded or loading.
+     */
+    void load();
+
+    /**
+     * @brief Replaces the rows with a fresh read of the leaderboard.
+     *
+     * Called by the GameOverPipeline once the read started by load() is done.
+     *
+     * @param board The entries, best first.
+     * @param boardCapacity Size of the board.
+     * @param perPlayer True if a player holds at most one entry.
+     */
+    void boardRead(std::vector<ScoreRecord> board, std::size_t boardCapacity, bool perPlayer);
+
+    /**
+     * @brief Applies a saved score to the rows.
+     *
+     * Ignored until the leaderboard has been read. A score saved before the read already
+     * is in it, as saves and the read run in order on the pipeline's storage lane.
+     *
+     * @param record The score that was saved.
+     * @param rank Its position on the leaderboard, starting at 1, or 0 if it did not make the board.
+     */
+    void scoreSaved(const ScoreRecord &record, int rank);
+
+    /**
+     * @brief Retrieves the number of rows handed to the view so far.
+     *
+     * @param parent Must be the invalid root index.
+     * @return The number of fetched rows.
+     */
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * @brief Retrieves the text of a row.
+     *
+     * @param index The row.
+     * @param role Qt::DisplayRole for "name - score"; other roles are empty.
+     * @return The text, or an invalid QVariant.
+     */
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Checks whether rows are left to hand to the view.
+     *
+     * @param parent Must be the invalid root index.
+     * @return True if not every entry has been fetched.
+     */
+    bool canFetchMore(const QModelIndex &parent) const override;
+
+    /**
+     * @brief Hands the next page of rows to the view.
+     *
+     * @param parent Must be the invalid root index.
+     */
+    void fetchMore(const QModelIndex &parent) override;
+
+    static constexpr int kPageSize = 50; ///< Rows fetched at a time; a few screens' worth.
+
+private:
+    ScoreListModel();
+
+    /**
+     * @brief Loading progress of the model.
+     */
+    enum class State {
+        Empty,   ///< load() has not been called.
+        Loading, ///< The leaderboard is being read.
+        Loaded   ///< The rows are current.
+    };
+
+    void insertEntry(std::size_t row, const ScoreRecord &record);
+    void removeEntry(std::size_t row);
+    void moveEntry(std::size_t from, std::size_t to, const ScoreRecord &record);
+
+    std::vector<ScoreRecord> entries; ///< Every entry of the board, best first.
+    std::size_t fetched;              ///< Entries handed to the view; a prefix of entries.
+    std::size_t capacity;             ///< Size of the board; the last entry falls off beyond it.
+    bool bestPerPlayer;               ///< True if a player holds at most one entry.
+    State state;                      ///< Loading progress.
+};
+
+#endif // SCORELISTMODEL_H
@@ -5,7 +5,7 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QVBoxLayout>
-#include <QListWidget>
+#include <QListView>
 
 /**
  * @class ScoresPage
@@ -13,6 +13,9 @@
  *
  * The ScoresPage class is responsible for displaying high scores in a list format.
  * It includes a return button to navigate back to the main menu.
+ *
+ * The list is a QListView on the shared ScoreListModel, which reads the scores in the
+ * background and is updated row by row as games end, so the page is never rebuilt.
  */
 class ScoresPage : public QWidget
 {
@@ -30,15 +33,6 @@ public:
      */
     explicit ScoresPage(const QSize &size, QWidget *parent = nullptr);
 
-    /**
-     * @brief Function to update the high scores displayed on the page.
-     *
-     * Updates the QListWidget with the latest high scores.
-     *
-     * @param scoresListWidget Pointer to the QListWidget that displays the scores.
-     */
-    void updateHighScores(QListWidget* scoresListWidget);
-
     signals:
             /**
              * @brief Signal to indicate a return to the main menu.
@@ -59,7 +53,7 @@ private:
     QVBoxLayout* layout;       ///< Layout to organize widgets.
     QLabel* titleLabel;        ///< Label to display the title of the page.
     QPushButton* returnButton; ///< Button to return to the main menu.
-    QListWidget* scoresListWidget; ///< List widget to display scores.
+    QListView* scoresListView; ///< View on the ScoreListModel.
 };
 
 #endif // SCORESPAGE_H
@@ -0,0 +1,87 @@
+#include "GameSimulator.h"
+#include "LedLayout.h"
+#include "Player.h"
+#include "Random.h"
+#include <algorithm>
+
+namespace {
+
+using Clock = MoleEngine::Clock;
+
+/**
+ * @brief Picks one lit cell.
+ */
+int pickCell(std::uint16_t mask, Random& random) {
+    std::uint32_t skip = random.nextBelow(static_cast<std::uint32_t>(__builtin_popcount(mask)));
+    for (; skip > 0; --skip) {
+        mask &= static_cast<std::uint16_t>(mask - 1);
+    }
+    return __builtin_ctz(mask);
+}
+
+} // namespace
+
+/**
+ * @class GameSimulator
+ * @brief Plays rounds headless with a synthetic player on a simulated clock.
+ * @author Anubhav Aery
+ */
+GameSimulator::GameSimulator() : gpio(), frame(), moles() {
+    gpio.setRecording(false);
+    gpio.initialise();
+    frame.setBackend(&gpio);
+}
+
+/**
+ * @brief Plays one round.
+ *
+ * The player aims at a lit mole as soon as one is up and presses after a reaction time
+ * drawn from the model. An inaccurate press lands on another cell, and a press on a mole
+ * that escaped in the meantime is a miss, as it would be at the cabinet.
+ *
+ * @param mode The mode of the round.
+ * @param model The player.
+ * @param seed Seed of the round; equal seeds give equal rounds.
+ * @param roundLength Length of the round.
+ * @return The outcome of the round.
+ */
+SimulatedGame GameSimulator::play(const GameMode& mode, const PlayerModel& model, std::uint64_t seed,
+                                  std::chrono::nanoseconds roundLength) {
+    Random random(seed);
+    Random hand(seed ^ 0x5deece66dULL);
+    Player player;
+    Clock::time_point now{};
+    Clock::time_point end = now + roundLength;
+    Clock::time_point keyAt = Clock::time_point::max();
+    int target = LedLayout::kNoCell;
+    moles.start(mode, now, roundLength);
+
+    while (now < end) {
+        MoleEngine::Step step = moles.advance(now, random);
+        player.addPoints(step.scoreDelta);
+        frame.setMask(moles.getMask());
+        frame.flush();
+        if (target == LedLayout::kNoCell && moles.getMask() != 0) {
+            target = pickCell(moles.getMask(), hand);
+            keyAt = now + model.sampleReaction(hand);
+        }
+
+        now = std::min({end, moles.nextDeadline(), keyAt});
+        if (now >= end) {
+            break;
+        }
+        if (now == keyAt) {
+            int cell = target;
+            if (!model.sampleAccurate(hand)) {
+                cell = (target + 1 + static_cast<int>(hand.nextBelow(LedLayout::kCellCount - 1))) % LedLayout::kCellCount;
+            }
+            player.addPoints(moles.whack(cell, now).scoreDelta);
+            target = LedLayout::kNoCell;
+            keyAt = Clock::time_point::max();
+        }
+    }
+
+    frame.clear();
+    frame.flush();
+    return SimulatedGame{player.getScore(), moles.getHits(), moles.getMisses(), moles.getEscapes()};
+}
@@ -0,0 +1,60 @@
+#ifndef GAMESIMULATOR_H
+#define GAMESIMULATOR_H
+
+#include "GameMode.h"
+#include "LedFrameBuffer.h"
+#include "MoleEngine.h"
+#include "PlayerModel.h"
+#include "SimulatedGpioBackend.h"
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @struct SimulatedGame
+ * @brief The outcome of one simulated round.
+ */
+struct SimulatedGame {
+    int score;             ///< Final score.
+    std::uint32_t hits;    ///< Moles hit.
+    std::uint32_t misses;  ///< Keys on empty cells.
+    std::uint32_t escapes; ///< Moles that escaped.
+};
+
+/**
+ * @class GameSimulator
+ * @brief Plays rounds headless with a synthetic player on a simulated clock.
+ *
+ * The round runs the same MoleEngine and Player scoring as GameController::inGame() and
+ * shows the moles on a SimulatedGpioBackend, but the clock jumps straight to the next mole
+ * deadline or key press instead of waiting for it, so a 30 second round takes a few
+ * microseconds. A round depends only on its seed: the moles and the player draw from two
+ * random engines derived from it, and nothing is shared between simulators. One simulator
+ * is meant to be used by one thread.
+ * @author Anubhav Aery
+ */
+class GameSimulator {
+public:
+    /**
+     * @brief Constructs a simulator with its own simulated board.
+     */
+    GameSimulator();
+
+    /**
+     * @brief Plays one round.
+     *
+     * @param mode The mode of the round.
+     * @param model The player.
+     * @param seed Seed of the round; equal seeds give equal rounds.
+     * @param roundLength Length of the round.
+     * @return The outcome of the round.
+     */
+    SimulatedGame play(const GameMode& mode, const PlayerModel& model, std::uint64_t seed,
+                       std::chrono::nanoseconds roundLength);
+
+private:
+    SimulatedGpioBackend gpio; ///< Board the moles are shown on.
+    LedFrameBuffer frame;      ///< Batches the LED changes for the board.
+    MoleEngine moles;          ///< Spawns, escapes and hit tests of the round.
+};
+
+#endif // GAMESIMULATOR_H
@@ -0,0 +1,41 @@
+#include "PlayerModel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Draws a double uniformly from (0, 1].
+ */
+double uniform(Random& random) {
+    return (static_cast<double>(random.next() >> 11) + 1.0) * 0x1.0p-53;
+}
+
+} // namespace
+
+/**
+ * @brief Draws one reaction time.
+ *
+ * A standard normal value is drawn with the Box-Muller transform and mapped onto the
+ * log-normal distribution with the model's median and shape.
+ *
+ * @param random The random engine of the game.
+ * @return The time from the mole appearing to the key press.
+ */
+std::chrono::nanoseconds PlayerModel::sampleReaction(Random& random) const {
+    double u1 = uniform(random);
+    double u2 = uniform(random);
+    double normal = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+    double ms = std::max(minimumReactionMs, reactionMedianMs * std::exp(reactionSigma * normal));
+    return std::chrono::nanoseconds(static_cast<std::int64_t>(ms * 1e6));
+}
+
+/**
+ * @brief Decides whether a press hits the intended cell.
+ *
+ * @param random The random engine of the game.
+ * @return True with probability accuracy.
+ */
+bool PlayerModel::sampleAccurate(Random& random) const {
+    return uniform(random) <= accuracy;
+}
@@ -0,0 +1,48 @@
+#ifndef PLAYERMODEL_H
+#define PLAYERMODEL_H
+
+#include "Random.h"
+#include <chrono>
+
+/**
+ * @struct PlayerModel
+ * @brief A synthetic player: how fast and how accurately it reacts to a mole.
+ *
+ * Reaction times follow a log-normal distribution, the usual fit for human simple
+ * reaction times: most presses land near the median, with a long tail of slow ones.
+ * @author Anubhav Aery
+ */
+struct PlayerModel {
+    const char* name;         ///< Name used on the command line and in the report.
+    double reactionMedianMs;  ///< Median time from a mole appearing to the key press.
+    double reactionSigma;     ///< Shape of the log-normal distribution; larger is more spread out.
+    double minimumReactionMs; ///< No press comes sooner than this.
+    double accuracy;          ///< Probability that a press hits the intended cell.
+
+    /**
+     * @brief Draws one reaction time.
+     *
+     * @param random The random engine of the game.
+     * @return The time from the mole appearing to the key press.
+     */
+    std::chrono::nanoseconds sampleReaction(Random& random) const;
+
+    /**
+     * @brief Decides whether a press hits the intended cell.
+     *
+     * @param random The random engine of the game.
+     * @return True with probability accuracy.
+     */
+    bool sampleAccurate(Random& random) const;
+};
+
+/**
+ * @brief The built-in player models.
+ */
+inline constexpr PlayerModel kPlayerModels[] = {
+        {"novice", 650.0, 0.35, 200.0, 0.80},
+        {"casual", 450.0, 0.30, 180.0, 0.90},
+        {"expert", 300.0, 0.20, 150.0, 0.97},
+};
+
+#endif // PLAYERMODEL_H
@@ -0,0 +1,187 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+namespace {
+
+thread_local int workerIndex = -1; ///< Index of the pool worker running on this thread, or -1.
+
+} // namespace
+
+/**
+ * @class WorkStealingPool
+ * @brief Thread pool in which every worker has its own task deque and idle workers steal.
+ * @author Anubhav Aery
+ */
+WorkStealingPool::WorkStealingPool(unsigned threads)
+        : queues(), workers(), queued(0), pending(0), steals(0), nextQueue(0), stopping(false) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+/**
+ * @brief Waits for the queued tasks and stops the workers.
+ */
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Queues a task.
+ *
+ * @param task The task.
+ */
+void WorkStealingPool::submit(Task task) {
+    pending.fetch_add(1);
+    unsigned index = workerIndex >= 0 ? static_cast<unsigned>(workerIndex)
+                                      : nextQueue.fetch_add(1, std::memory_order_relaxed) % size();
+    push(index, std::move(task));
+}
+
+/**
+ * @brief Waits until every submitted task has run.
+ */
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    idle.wait(lock, [this] { return pending.load() == 0; });
+}
+
+/**
+ * @brief Runs a body over a range of indices on the pool and waits for it.
+ *
+ * @param begin First index.
+ * @param end One past the last index.
+ * @param grain Largest piece handed to the body in one call.
+ * @param body Called with a sub-range [first, last).
+ */
+void WorkStealingPool::parallelFor(std::uint64_t begin, std::uint64_t end, std::uint64_t grain,
+                                   const std::function<void(std::uint64_t, std::uint64_t)>& body) {
+    if (begin >= end) {
+        return;
+    }
+    grain = std::max<std::uint64_t>(1, grain);
+    const auto* shared = &body;
+    submit([this, begin, end, grain, shared] { split(begin, end, grain, shared); });
+    wait();
+}
+
+/**
+ * @brief Retrieves the number of workers.
+ *
+ * @return The worker count.
+ */
+unsigned WorkStealingPool::size() const {
+    return static_cast<unsigned>(queues.size());
+}
+
+/**
+ * @brief Retrieves the number of tasks taken from another worker's deque.
+ *
+ * @return The steal count since the pool started.
+ */
+std::uint64_t WorkStealingPool::getSteals() const {
+    return steals.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Runs tasks from the worker's own deque, then from the others, until stopped.
+ */
+void WorkStealingPool::run(unsigned index) {
+    workerIndex = static_cast<int>(index);
+    Task task;
+    for (;;) {
+        if (popLocal(index, task) || steal(index, task)) {
+            task();
+            task = nullptr;
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                idle.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) {
+            return;
+        }
+        lock.unlock();
+        // A task counted in queued may not be in its deque yet; let its producer run
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief Appends a task to a deque and wakes a sleeping worker.
+ */
+void WorkStealingPool::push(unsigned index, Task task) {
+    queued.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+/**
+ * @brief Takes the newest task of the worker's own deque.
+ */
+bool WorkStealingPool::popLocal(unsigned index, Task& task) {
+    Queue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queued.fetch_sub(1);
+    return true;
+}
+
+/**
+ * @brief Takes the oldest task of another worker's deque, starting with the next worker.
+ */
+bool WorkStealingPool::steal(unsigned thief, Task& task) {
+    for (unsigned offset = 1; offset < size(); ++offset) {
+        Queue& queue = *queues[(thief + offset) % size()];
+        std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || queue.tasks.empty()) {
+            continue;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        queued.fetch_sub(1);
+        steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Splits a range in halves, queuing the upper halves, and runs the body on the rest.
+ */
+void WorkStealingPool::split(std::uint64_t begin, std::uint64_t end, std::uint64_t grain,
+                             const std::function<void(std::uint64_t, std::uint64_t)>* body) {
+    while (end - begin > grain) {
+        std::uint64_t middle = begin + (end - begin) / 2;
+        submit([this, middle, end, grain, body] { split(middle, end, grain, body); });
+        end = middle;
+    }
+    (*body)(begin, end);
+}
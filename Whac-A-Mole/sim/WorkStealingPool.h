@@ -0,0 +1,115 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkStealingPool
+ * @brief Thread pool in which every worker has its own task deque and idle workers steal.
+ *
+ * A worker pushes and pops tasks at the back of its own deque, so the task it just split
+ * off is still in its cache when it runs. A worker whose deque is empty takes the oldest
+ * task from the front of another worker's deque; the oldest tasks are the largest pieces of
+ * a split range, so a steal moves a lot of work at once. Tasks submitted from outside the
+ * pool are spread over the deques round-robin.
+ * @author Anubhav Aery
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>; ///< A unit of work.
+
+    /**
+     * @brief Starts the workers.
+     *
+     * @param threads Number of workers; 0 uses one per hardware thread.
+     */
+    explicit WorkStealingPool(unsigned threads = 0);
+
+    /**
+     * @brief Waits for the queued tasks and stops the workers.
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Queues a task.
+     *
+     * From a worker, the task goes to the back of its own deque.
+     *
+     * @param task The task.
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Waits until every submitted task has run. Must not be called from a worker.
+     */
+    void wait();
+
+    /**
+     * @brief Runs a body over a range of indices on the pool and waits for it.
+     *
+     * The range is split in halves by the workers themselves until the pieces are no larger
+     * than the grain, so stealing balances the load without a central queue. Must not be
+     * called from a worker.
+     *
+     * @param begin First index.
+     * @param end One past the last index.
+     * @param grain Largest piece handed to the body in one call.
+     * @param body Called with a sub-range [first, last).
+     */
+    void parallelFor(std::uint64_t begin, std::uint64_t end, std::uint64_t grain,
+                     const std::function<void(std::uint64_t, std::uint64_t)>& body);
+
+    /**
+     * @brief Retrieves the number of workers.
+     *
+     * @return The worker count.
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Retrieves the number of tasks taken from another worker's deque.
+     *
+     * @return The steal count since the pool started.
+     */
+    std::uint64_t getSteals() const;
+
+private:
+    /**
+     * @brief The deque of one worker, on its own cache line.
+     */
+    struct alignas(64) Queue {
+        std::mutex mutex;       ///< Guards tasks.
+        std::deque<Task> tasks; ///< Pending tasks; the owner works at the back.
+    };
+
+    void run(unsigned index);
+    void push(unsigned index, Task task);
+    bool popLocal(unsigned index, Task& task);
+    bool steal(unsigned thief, Task& task);
+    void split(std::uint64_t begin, std::uint64_t end, std::uint64_t grain,
+               const std::function<void(std::uint64_t, std::uint64_t)>* body);
+
+    std::vector<std::unique_ptr<Queue>> queues; ///< One deque per worker.
+    std::vector<std::thread> workers;           ///< The worker threads.
+    std::atomic<std::uint64_t> queued;          ///< Tasks in the deques.
+    std::atomic<std::uint64_t> pending;         ///< Tasks submitted and not yet finished.
+    std::atomic<std::uint64_t> steals;          ///< Tasks taken from another deque.
+    std::atomic<unsigned> nextQueue;            ///< Deque of the next task submitted from outside.
+    std::atomic<bool> stopping;                 ///< Set by the destructor.
+    std::mutex sleepMutex;                      ///< Guards the sleeping of workers and waiters.
+    std::condition_variable wake;               ///< Signals workers that a task was queued.
+    std::condition_variable idle;               ///< Signals wait() that pending reached zero.
+};
+
+#endif // WORKSTEALINGPOOL_H
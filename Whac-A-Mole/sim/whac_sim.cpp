@@ -0,0 +1,287 @@
+/**
+ * @file whac_sim.cpp
+ * @brief Headless game simulator for balancing the difficulty of the game modes.
+ *
+ * Plays many rounds of every selected mode with every selected player model on a
+ * WorkStealingPool and prints the distribution of the scores. Round i of a mode and model
+ * is seeded from the base seed, the mode, the model and i alone, and the results are summed
+ * as integer counts, so the report is identical for any number of threads.
+ *
+ * Usage: whac-sim [options]
+ *   --games N          rounds per mode and model (default 100000)
+ *   --mode NAME        easy, medium, hard or all (default all)
+ *   --model NAME       novice, casual, expert or all (default all)
+ *   --reaction MS      override the median reaction time of the models
+ *   --sigma S          override the log-normal shape of the reaction times
+ *   --accuracy P       override the probability of hitting the intended cell
+ *   --round SECONDS    length of a round (default 30)
+ *   --threads N        worker threads (default: one per hardware thread)
+ *   --seed S           base seed (default 1)
+ *   --histogram        print the score histogram of every mode and model
+ * @author Anubhav Aery
+ */
+
+#include "GameMode.h"
+#include "GameSimulator.h"
+#include "PlayerModel.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxScore = 1023; ///< Scores above are counted in the last histogram slot.
+
+/**
+ * @brief Summed results of many rounds of one mode and model.
+ */
+struct Distribution {
+    std::vector<std::uint64_t> scores = std::vector<std::uint64_t>(kMaxScore + 1); ///< Rounds per score.
+    std::uint64_t games = 0;    ///< Rounds played.
+    std::int64_t scoreSum = 0;  ///< Sum of the scores.
+    std::uint64_t hits = 0;     ///< Moles hit.
+    std::uint64_t misses = 0;   ///< Keys on empty cells.
+    std::uint64_t escapes = 0;  ///< Moles that escaped.
+
+    /**
+     * @brief Adds one round.
+     */
+    void add(const SimulatedGame& game) {
+        ++scores[static_cast<std::size_t>(std::min(std::max(game.score, 0), kMaxScore))];
+        ++games;
+        scoreSum += game.score;
+        hits += game.hits;
+        misses += game.misses;
+        escapes += game.escapes;
+    }
+
+    /**
+     * @brief Adds the rounds of another distribution.
+     */
+    void merge(const Distribution& other) {
+        for (std::size_t i = 0; i < scores.size(); ++i) {
+            scores[i] += other.scores[i];
+        }
+        games += other.games;
+        scoreSum += other.scoreSum;
+        hits += other.hits;
+        misses += other.misses;
+        escapes += other.escapes;
+    }
+
+    /**
+     * @brief Retrieves the lowest score reached by a share of the rounds.
+     */
+    int percentile(double percent) const {
+        auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(percent / 100.0 * games)));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < scores.size(); ++i) {
+            seen += scores[i];
+            if (seen >= rank) {
+                return static_cast<int>(i);
+            }
+        }
+        return kMaxScore;
+    }
+};
+
+/**
+ * @brief Command line settings.
+ */
+struct Options {
+    std::uint64_t games = 100000;
+    std::vector<const GameMode*> modes;
+    std::vector<PlayerModel> models;
+    double reaction = 0;
+    double sigma = 0;
+    double accuracy = -1;
+    double roundSeconds = 30;
+    unsigned threads = 0;
+    std::uint64_t seed = 1;
+    bool histogram = false;
+};
+
+/**
+ * @brief Mixes the round index into the seed, with the splitmix64 finaliser.
+ */
+std::uint64_t roundSeed(std::uint64_t base, std::uint64_t stream, std::uint64_t index) {
+    std::uint64_t z = base + stream * 0xd1b54a32d192ed03ULL + (index + 1) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Hashes a mode or model name with FNV-1a, so a stream does not depend on which others run.
+ */
+std::uint64_t nameHash(const char* name) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (; *name; ++name) {
+        hash = (hash ^ static_cast<unsigned char>(*name)) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Prints the usage and returns the exit code of a bad command line.
+ */
+int usage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--games N] [--mode easy|medium|hard|all] [--model novice|casual|expert|all]\n"
+                 "       [--reaction MS] [--sigma S] [--accuracy P] [--round SECONDS] [--threads N]\n"
+                 "       [--seed S] [--histogram]\n",
+                 program);
+    return 2;
+}
+
+/**
+ * @brief Parses the command line.
+ *
+ * @return False if it is invalid.
+ */
+bool parse(int argc, char* argv[], Options& options) {
+    std::string mode = "all";
+    std::string model = "all";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--histogram") {
+            options.histogram = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--games") {
+            options.games = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--mode") {
+            mode = value;
+        } else if (arg == "--model") {
+            model = value;
+        } else if (arg == "--reaction") {
+            options.reaction = std::atof(value);
+        } else if (arg == "--sigma") {
+            options.sigma = std::atof(value);
+        } else if (arg == "--accuracy") {
+            options.accuracy = std::atof(value);
+        } else if (arg == "--round") {
+            options.roundSeconds = std::atof(value);
+        } else if (arg == "--threads") {
+            options.threads = static_cast<unsigned>(std::atoi(value));
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value, nullptr, 0);
+        } else {
+            return false;
+        }
+    }
+
+    for (const GameMode& candidate : kGameModes) {
+        if (mode == "all" || mode == candidate.name) {
+            options.modes.push_back(&candidate);
+        }
+    }
+    for (const PlayerModel& candidate : kPlayerModels) {
+        if (model == "all" || model == candidate.name) {
+            PlayerModel tuned = candidate;
+            tuned.reactionMedianMs = options.reaction > 0 ? options.reaction : tuned.reactionMedianMs;
+            tuned.reactionSigma = options.sigma > 0 ? options.sigma : tuned.reactionSigma;
+            tuned.accuracy = options.accuracy >= 0 ? options.accuracy : tuned.accuracy;
+            options.models.push_back(tuned);
+        }
+    }
+    return options.games > 0 && options.roundSeconds > 0 && !options.modes.empty() && !options.models.empty();
+}
+
+/**
+ * @brief Prints a histogram of the scores in about twenty rows.
+ */
+void printHistogram(const Distribution& distribution) {
+    int low = distribution.percentile(0);
+    int high = distribution.percentile(100);
+    int width = std::max(1, (high - low + 20) / 20);
+    std::uint64_t peak = 1;
+    std::vector<std::uint64_t> rows;
+    for (int start = low; start <= high; start += width) {
+        std::uint64_t count = 0;
+        for (int score = start; score < start + width && score <= kMaxScore; ++score) {
+            count += distribution.scores[static_cast<std::size_t>(score)];
+        }
+        rows.push_back(count);
+        peak = std::max(peak, count);
+    }
+    for (std::size_t row = 0; row < rows.size(); ++row) {
+        int start = low + static_cast<int>(row) * width;
+        int bar = static_cast<int>(rows[row] * 50 / peak);
+        std::printf("    %4d-%-4d %10llu %s\n", start, start + width - 1, static_cast<unsigned long long>(rows[row]),
+                    std::string(static_cast<std::size_t>(bar), '#').c_str());
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        return usage(argv[0]);
+    }
+
+    WorkStealingPool pool(options.threads);
+    auto roundLength = std::chrono::nanoseconds(static_cast<std::int64_t>(options.roundSeconds * 1e9));
+    std::printf("%llu rounds of %.0f s per mode and model, %u threads, seed %llu\n\n",
+                static_cast<unsigned long long>(options.games), options.roundSeconds, pool.size(),
+                static_cast<unsigned long long>(options.seed));
+    std::printf("%-7s %-7s %10s %8s %7s %5s %5s %5s %5s %5s %7s %9s %9s\n", "mode", "model", "rounds", "mean", "stddev",
+                "min", "p10", "p50", "p90", "max", "hit%", "misses", "escapes");
+
+    auto started = std::chrono::steady_clock::now();
+    std::uint64_t totalGames = 0;
+    for (std::size_t m = 0; m < options.modes.size(); ++m) {
+        const GameMode& mode = *options.modes[m];
+        for (std::size_t p = 0; p < options.models.size(); ++p) {
+            const PlayerModel& model = options.models[p];
+            std::uint64_t stream = nameHash(mode.name) ^ (nameHash(model.name) << 1);
+            Distribution total;
+            std::mutex totalMutex;
+            pool.parallelFor(0, options.games, 2048, [&](std::uint64_t first, std::uint64_t last) {
+                // One simulator per piece keeps the workers free of shared state
+                GameSimulator simulator;
+                Distribution local;
+                for (std::uint64_t i = first; i < last; ++i) {
+                    local.add(simulator.play(mode, model, roundSeed(options.seed, stream, i), roundLength));
+                }
+                std::lock_guard<std::mutex> lock(totalMutex);
+                total.merge(local);
+            });
+            totalGames += total.games;
+
+            double mean = static_cast<double>(total.scoreSum) / total.games;
+            double squares = 0;
+            for (std::size_t score = 0; score < total.scores.size(); ++score) {
+                squares += static_cast<double>(total.scores[score]) * static_cast<double>(score * score);
+            }
+            double deviation = std::sqrt(std::max(0.0, squares / total.games - mean * mean));
+            double attempts = static_cast<double>(total.hits + total.misses);
+            std::printf("%-7s %-7s %10llu %8.2f %7.2f %5d %5d %5d %5d %5d %6.1f%% %9.2f %9.2f\n", mode.name,
+                        model.name, static_cast<unsigned long long>(total.games), mean, deviation,
+                        total.percentile(0), total.percentile(10), total.percentile(50), total.percentile(90),
+                        total.percentile(100), attempts > 0 ? 100.0 * total.hits / attempts : 0.0,
+                        static_cast<double>(total.misses) / total.games,
+                        static_cast<double>(total.escapes) / total.games);
+            if (options.histogram) {
+                printHistogram(total);
+            }
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+    std::printf("\n%llu rounds in %.2f s (%.0f rounds/s, %llu steals)\n", static_cast<unsigned long long>(totalGames),
+                elapsed.count(), totalGames / elapsed.count(), static_cast<unsigned long long>(pool.getSteals()));
+    return 0;
+}